@@ -32,6 +32,7 @@
 #include "server/network/protocol/protocollogin.hpp"
 #include "server/network/protocol/protocolstatus.hpp"
 #include "server/network/webhook/webhook.hpp"
+#include "utils/cpu_features.hpp"
 #include "creatures/players/vocations/vocation.hpp"
 
 CanaryServer::CanaryServer(
@@ -82,6 +83,10 @@ int CanaryServer::run() {
 				setWorldType();
 				loadMaps();
 
+				// Game::loadItemsPrice reads the order book and the statistics when the game state becomes INIT
+				IOMarket::getInstance().loadOffers();
+				IOMarket::getInstance().updateStatistics();
+
 				logger.info("Initializing gamestate...");
 				g_game().setGameState(GAME_STATE_INIT);
 
@@ -89,7 +94,6 @@ int CanaryServer::run() {
 				g_game().transferHouseItemsToDepot();
 
 				IOMarket::checkExpiredOffers();
-				IOMarket::getInstance().updateStatistics();
 
 				logger.info("Loaded all modules, server starting up...");
 
@@ -240,6 +244,7 @@ void CanaryServer::logInfos() {
 #endif
 
 	logger.debug("Compiled with {}, on {} {}, for platform {}", getCompiler(), __DATE__, __TIME__, getPlatform());
+	logger.info("Using {} vector instructions", getSimdLevelName(getSimdLevel()));
 
 #if defined(LUAJIT_VERSION)
 	logger.debug("Linked with {} for Lua support", LUAJIT_VERSION);
@@ -354,6 +359,7 @@ void CanaryServer::initializeDatabase() {
 		throw FailedToInitializeCanary("Failed to connect to database!");
 	}
 	logger.debug("MySQL Version: {}", Database::getClientVersion());
+	logger.debug("MySQL connection pool: {} connections", Database::getInstance().getPoolSize());
 
 	logger.debug("Running database manager...");
 	if (!DatabaseManager::isDatabaseSetup()) {
@@ -115,6 +115,7 @@ enum ConfigKey_t : uint16_t {
 	HAZARD_PODS_TIME_TO_DAMAGE,
 	HAZARD_PODS_TIME_TO_SPAWN,
 	HAZARD_SPAWN_PLUNDER_MULTIPLIER,
+	HIERARCHICAL_PATHFINDING,
 	DAYS_TO_CLOSE_BID,
 	HOUSE_BUY_LEVEL,
 	HOUSE_LOSE_AFTER_INACTIVITY,
@@ -147,6 +148,8 @@ enum ConfigKey_t : uint16_t {
 	MARKET_REFRESH_PRICES,
 	MARKET_PREMIUM,
 	MAX_ALLOWED_ON_A_DUMMY,
+	MAX_BYTES_PER_FLUSH,
+	MAX_CONCURRENT_LOGINS,
 	MAX_CONTAINER_ITEM,
 	MAX_CONTAINER,
 	MAX_CONTAINER_DEPTH,
@@ -176,8 +179,10 @@ enum ConfigKey_t : uint16_t {
 	MYSQL_DB_BACKUP,
 	MYSQL_HOST,
 	MYSQL_PASS,
+	MYSQL_POOL_SIZE,
 	MYSQL_SOCK,
 	MYSQL_USER,
+	NETWORK_IO_THREADS,
 	OLD_PROTOCOL,
 	ONE_PLAYER_ON_ACCOUNT,
 	ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS,
@@ -245,6 +250,7 @@ enum ConfigKey_t : uint16_t {
 	REMOVE_WEAPON_AMMO,
 	REMOVE_WEAPON_CHARGES,
 	REPLACE_KICK_ON_LOGIN,
+	REPORT_BLOCKING_QUERIES,
 	RESET_SESSIONS_ON_STARTUP,
 	REWARD_CHEST_COLLECT_ENABLED,
 	REWARD_CHEST_MAX_COLLECT_ITEMS,
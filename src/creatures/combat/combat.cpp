@@ -27,6 +27,7 @@
 #include "lua/callbacks/events_callbacks.hpp"
 #include "lua/creature/events.hpp"
 #include "map/spectators.hpp"
+#include "server/network/protocol/tile_effects.hpp"
 #include "creatures/players/player.hpp"
 #include "creatures/players/components/wheel/wheel_definitions.hpp"
 
@@ -886,6 +887,20 @@ void Combat::CombatNullFunc(const std::shared_ptr<Creature> &caster, const std::
 }
 
 void Combat::combatTileEffects(const CreatureVector &spectators, const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params) {
+	combatTileItems(caster, tile, params);
+
+	if (params.impactEffect != CONST_ME_NONE) {
+		Game::addMagicEffect(spectators, tile->getPosition(), params.impactEffect);
+	}
+
+	if (params.soundImpactEffect != SoundEffect_t::SILENCE) {
+		g_game().sendDoubleSoundEffect(tile->getPosition(), params.soundCastEffect, params.soundImpactEffect, caster);
+	} else if (params.soundCastEffect != SoundEffect_t::SILENCE) {
+		g_game().sendSingleSoundEffect(tile->getPosition(), params.soundCastEffect, caster);
+	}
+}
+
+void Combat::combatTileItems(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params) {
 	if (params.itemId != 0) {
 		uint16_t itemId = params.itemId;
 		switch (itemId) {
@@ -962,16 +977,6 @@ void Combat::combatTileEffects(const CreatureVector &spectators, const std::shar
 	if (params.tileCallback) {
 		params.tileCallback->onTileCombat(caster, tile);
 	}
-
-	if (params.impactEffect != CONST_ME_NONE) {
-		Game::addMagicEffect(spectators, tile->getPosition(), params.impactEffect);
-	}
-
-	if (params.soundImpactEffect != SoundEffect_t::SILENCE) {
-		g_game().sendDoubleSoundEffect(tile->getPosition(), params.soundCastEffect, params.soundImpactEffect, caster);
-	} else if (params.soundCastEffect != SoundEffect_t::SILENCE) {
-		g_game().sendSingleSoundEffect(tile->getPosition(), params.soundCastEffect, caster);
-	}
 }
 
 void Combat::postCombatEffects(const std::shared_ptr<Creature> &caster, const Position &origin, const Position &pos, const CombatParams &params) {
@@ -1225,8 +1230,22 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 	uint32_t maxY = 0;
 	std::vector<std::shared_ptr<Creature>> affectedTargets;
 
+	// The creatures of every tile are copied once for the whole area, when the first pass reaches the tile:
+	// the Lua callbacks of canDoCombat and of the combat itself may add or remove creatures of the tiles
+	CreatureVector areaCreatures;
+	// [size_t = first creature of the tile in areaCreatures, size_t = end of its creatures], npos until copied
+	std::vector<std::pair<size_t, size_t>> tileCreatures(tileList.size(), { std::string::npos, std::string::npos });
+	const auto copyTileCreatures = [&areaCreatures, &tileCreatures](size_t index, const std::shared_ptr<Tile> &tile) {
+		const size_t begin = areaCreatures.size();
+		if (const CreatureVector* creatures = tile->getCreatures()) {
+			areaCreatures.insert(areaCreatures.end(), creatures->begin(), creatures->end());
+		}
+		tileCreatures[index] = { begin, areaCreatures.size() };
+	};
+
 	// Calculate the max viewable range and affected creatures
-	for (const auto &tile : tileList) {
+	for (size_t index = 0; index < tileList.size(); ++index) {
+		const auto &tile = tileList[index];
 		// If the caster is a player and the world is no pvp, we need to check if there are more than one player in the tile and skip the combat
 		if (casterPlayer && g_game().getWorldType() == WORLD_TYPE_NO_PVP && tile->getPosition() == origin) {
 			if (!casterPlayer->isFirstOnStack()) {
@@ -1251,10 +1270,12 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 			continue;
 		}
 
-		if (CreatureVector* creatures = tile->getCreatures()) {
+		copyTileCreatures(index, tile);
+		const auto &[begin, end] = tileCreatures[index];
+		if (begin != end) {
 			const auto &topCreature = tile->getTopCreature();
-			CreatureVector creaturesCopy = *creatures;
-			for (const auto &creature : creaturesCopy) {
+			for (size_t i = begin; i < end; ++i) {
+				const auto &creature = areaCreatures[i];
 				if (params.targetCasterOrTopMost) {
 					if (caster && caster->getTile() == tile) {
 						if (creature != caster) {
@@ -1293,16 +1314,34 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 	if (affectedTargets.size() == 1) {
 		tmpDamage = extensionsDamage;
 	}
-	for (const auto &tile : tileList) {
+
+	// The effects of consecutive tiles go out in one write per spectator, but always before the next
+	// damage or field packets: clients see every tile hit, then its effect, in the order of the area
+	TileEffects tileEffects(params.impactEffect, params.soundCastEffect, params.soundImpactEffect);
+	const auto sendTileEffects = [&tileEffects, &spectators, &caster] {
+		Game::addTileEffects(spectators.data(), tileEffects, caster);
+		tileEffects.clear();
+	};
+
+	for (size_t index = 0; index < tileList.size(); ++index) {
+		const auto &tile = tileList[index];
 		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
 			continue;
 		}
 
-		if (CreatureVector* creatures = tile->getCreatures()) {
+		if (tileCreatures[index].first == std::string::npos) {
+			copyTileCreatures(index, tile);
+		}
+		const auto &[begin, end] = tileCreatures[index];
+		if (begin != end) {
 			const auto &topCreature = tile->getTopCreature();
-			// A copy of the tile's creature list is made because modifications to this vector, such as adding or removing creatures through a Lua callback, may occur during the iteration within the for loop.
-			CreatureVector creaturesCopy = *creatures;
-			for (const auto &creature : creaturesCopy) {
+			for (size_t i = begin; i < end; ++i) {
+				const auto &creature = areaCreatures[i];
+				// Moved away or removed by a callback since the tile was copied
+				if (creature->isRemoved() || creature->getTile() != tile) {
+					continue;
+				}
+
 				if (params.targetCasterOrTopMost) {
 					if (caster && caster->getTile() == tile) {
 						if (creature != caster) {
@@ -1314,6 +1353,8 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 				}
 
 				if (!params.aggressive || (caster != creature && Combat::canDoCombat(caster, creature, params.aggressive) == RETURNVALUE_NOERROR)) {
+					sendTileEffects();
+
 					// Wheel of destiny update beam mastery damage
 					if (casterPlayer) {
 						casterPlayer->wheel().updateBeamMasteryDamage(tmpDamage, beamAffectedTotal, beamAffectedCurrent);
@@ -1339,8 +1380,13 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 				}
 			}
 		}
-		combatTileEffects(spectators.data(), caster, tile, params);
+		if (params.itemId != 0 || params.tileCallback) {
+			sendTileEffects();
+			combatTileItems(caster, tile, params);
+		}
+		tileEffects.addPosition(tile->getPosition());
 	}
+	sendTileEffects();
 
 	postCombatEffects(caster, origin, toPos, params);
 }
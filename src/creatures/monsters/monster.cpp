@@ -1610,7 +1610,7 @@ void Monster::doWalkBack(uint32_t &flags, Direction &nextDirection, bool &result
 		}
 
 		std::vector<Direction> listDir;
-		if (!getPathTo(masterPos, listDir, 0, std::max<int32_t>(0, distance - 5), true, true, distance)) {
+		if (!getWalkBackPath(distance, listDir)) {
 			isWalkingBack = false;
 			return;
 		}
@@ -1618,6 +1618,20 @@ void Monster::doWalkBack(uint32_t &flags, Direction &nextDirection, bool &result
 	}
 }
 
+bool Monster::getWalkBackPath(int32_t distance, std::vector<Direction> &listDir) {
+	// Far from the spawn, walk towards a waypoint of a route over the map sectors instead of searching the whole way
+	if (distance > SECTOR_SIZE && g_configManager().getBoolean(HIERARCHICAL_PATHFINDING)) {
+		if (const auto waypoint = g_game().map.getRouteWaypoint(position, masterPos, SECTOR_SIZE)) {
+			const int32_t waypointDistance = Position::getDiagonalDistance(position, *waypoint);
+			if (getPathTo(*waypoint, listDir, 0, 0, true, false, waypointDistance + SECTOR_SIZE / 2)) {
+				return true;
+			}
+		}
+	}
+
+	return getPathTo(masterPos, listDir, 0, std::max<int32_t>(0, distance - 5), true, true, distance);
+}
+
 void Monster::doFollowCreature(uint32_t &flags, Direction &nextDirection, bool &result) {
 	randomStepping = false;
 	result = Creature::getNextStep(nextDirection, flags);
@@ -385,6 +385,7 @@ private:
 	static std::vector<std::pair<int8_t, int8_t>> getPushItemLocationOptions(const Direction &direction);
 
 	void doWalkBack(uint32_t &flags, Direction &nextDirection, bool &result);
+	bool getWalkBackPath(int32_t distance, std::vector<Direction> &listDir);
 	void doFollowCreature(uint32_t &flags, Direction &nextDirection, bool &result);
 	void doRandomStep(Direction &nextDirection, bool &result);
 
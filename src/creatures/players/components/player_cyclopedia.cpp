@@ -38,25 +38,24 @@ void PlayerCyclopedia::loadDeathHistory(uint16_t page, uint16_t entriesPerPage)
 	uint32_t offset = static_cast<uint32_t>(page - 1) * entriesPerPage;
 	const auto query = fmt::format("SELECT `time`, `level`, `killed_by`, `mostdamage_by`, (select count(*) FROM `player_deaths` WHERE `player_id` = {}) as `entries` FROM `player_deaths` WHERE `player_id` = {} AND `time` >= UNIX_TIMESTAMP(DATE_SUB(NOW(), INTERVAL 30 DAY)) ORDER BY `time` DESC LIMIT {}, {}", m_player.getGUID(), m_player.getGUID(), offset, entriesPerPage);
 
-	uint32_t playerID = m_player.getID();
-	const std::function<void(DBResult_ptr, bool)> callback = [playerID, page, entriesPerPage](const DBResult_ptr &result, bool) {
-		const auto &player = g_game().getPlayerByID(playerID);
-		if (!player) {
-			return;
-		}
+	struct RecentDeaths {
+		uint16_t pages = 0;
+		std::vector<RecentDeathEntry> entries;
+	};
 
-		player->resetAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
+	// Parsed on the thread pool
+	const auto parse = [entriesPerPage](const DBResult_ptr &result) {
+		RecentDeaths deaths;
 		if (!result) {
-			player->sendCyclopediaCharacterRecentDeaths(0, 0, {});
-			return;
+			return deaths;
 		}
 
 		auto pages = result->getNumber<uint32_t>("entries");
 		pages += entriesPerPage - 1;
 		pages /= entriesPerPage;
+		deaths.pages = static_cast<uint16_t>(pages);
 
-		std::vector<RecentDeathEntry> entries;
-		entries.reserve(result->countResults());
+		deaths.entries.reserve(result->countResults());
 		do {
 			std::string killed_by = result->getString("killed_by");
 			std::string mostdamage_by = result->getString("mostdamage_by");
@@ -71,11 +70,27 @@ void PlayerCyclopedia::loadDeathHistory(uint16_t page, uint16_t entriesPerPage)
 				cause.append(fmt::format("{}{}", !killed_by.empty() ? " and" : "", formatWithArticle(mostdamage_by)));
 			}
 
-			entries.emplace_back(cause, result->getNumber<uint32_t>("time"));
+			deaths.entries.emplace_back(cause, result->getNumber<uint32_t>("time"));
 		} while (result->next());
-		player->sendCyclopediaCharacterRecentDeaths(page, static_cast<uint16_t>(pages), entries);
+		return deaths;
 	};
-	g_databaseTasks().store(query, callback);
+
+	uint32_t playerID = m_player.getID();
+	const auto callback = [playerID, page](RecentDeaths deaths) {
+		const auto &player = g_game().getPlayerByID(playerID);
+		if (!player) {
+			return;
+		}
+
+		player->resetAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
+		if (deaths.entries.empty()) {
+			player->sendCyclopediaCharacterRecentDeaths(0, 0, {});
+			return;
+		}
+
+		player->sendCyclopediaCharacterRecentDeaths(page, deaths.pages, deaths.entries);
+	};
+	g_databaseTasks().storeAsync(query, parse, callback);
 	m_player.addAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
 
 	g_logger().debug("Loading death history from the player {} took {} milliseconds.", m_player.getName(), bm_check.duration());
@@ -0,0 +1,70 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "creatures/players/components/player_save_state.hpp"
+
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	void countSection(std::string_view counter, PlayerSaveSection section) {
+		g_metrics().addCounter(counter, 1, { { "section", std::string(magic_enum::enum_name(section)) } });
+	}
+}
+
+void PlayerSaveState::setDirty(PlayerSaveSection section) {
+	++m_versions[static_cast<size_t>(section)];
+}
+
+bool PlayerSaveState::isClean(PlayerSaveSection section) const {
+	const auto index = static_cast<size_t>(section);
+	const auto &committed = m_committed[index];
+	if (!committed || committed->version != m_versions[index]) {
+		return false;
+	}
+
+	countSection("player_save_sections_skipped", section);
+	return true;
+}
+
+bool PlayerSaveState::stage(PlayerSaveSection section, size_t fingerprint, ItemRows rows /* = {}*/) {
+	const auto index = static_cast<size_t>(section);
+	const auto &committed = m_committed[index];
+	if (committed && committed->version == m_versions[index] && committed->fingerprint == fingerprint) {
+		countSection("player_save_sections_skipped", section);
+		return false;
+	}
+
+	m_staged[index] = Snapshot { m_versions[index], fingerprint, std::move(rows) };
+	countSection("player_save_sections_written", section);
+	return true;
+}
+
+const PlayerSaveState::ItemRows* PlayerSaveState::getCommittedItemRows(PlayerSaveSection section) const {
+	const auto index = static_cast<size_t>(section);
+	const auto &committed = m_committed[index];
+	if (!committed || committed->version != m_versions[index]) {
+		return nullptr;
+	}
+	return &committed->rows;
+}
+
+void PlayerSaveState::commit() {
+	for (size_t index = 0; index < SECTIONS; ++index) {
+		if (m_staged[index]) {
+			m_committed[index] = std::move(m_staged[index]);
+			m_staged[index].reset();
+		}
+	}
+}
+
+void PlayerSaveState::discard() {
+	for (auto &staged : m_staged) {
+		staged.reset();
+	}
+}
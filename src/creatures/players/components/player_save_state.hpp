@@ -0,0 +1,107 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#ifndef USE_PRECOMPILED_HEADERS
+	#include <array>
+	#include <cstdint>
+	#include <optional>
+	#include <parallel_hashmap/phmap.h>
+#endif
+
+/**
+ * @brief Player tables written by IOLoginData::savePlayer that can be skipped when unchanged.
+ */
+enum class PlayerSaveSection : uint8_t {
+	Stash,
+	Spells,
+	Kills,
+	Bestiary,
+	Inventory,
+	Depot,
+	Rewards,
+	Inbox,
+	Prey,
+	TaskHunting,
+	Bosstiary,
+};
+
+/**
+ * @brief Tracks what each save section last wrote to the database.
+ *
+ * Sections are dirty when their version was bumped through @ref setDirty or when
+ * the fingerprint of their serialized rows differs from the one last committed.
+ * Item tables also keep a hash per row (by `sid`), so only changed rows are upserted.
+ *
+ * Saves run inside a transaction, so new snapshots are only staged while saving
+ * and become the reference on @ref commit, after the transaction succeeded.
+ */
+class PlayerSaveState {
+public:
+	/**
+	 * @brief Hash of a saved item row and its parent, keyed by `sid`.
+	 */
+	struct ItemRow {
+		int32_t pid;
+		size_t hash;
+	};
+	using ItemRows = phmap::flat_hash_map<int32_t, ItemRow>;
+
+	/**
+	 * @brief Forces the section to be written on the next save.
+	 */
+	void setDirty(PlayerSaveSection section);
+
+	/**
+	 * @brief Whether the section is unchanged since the last committed save.
+	 *
+	 * Only meaningful for sections whose every change goes through @ref setDirty
+	 * (spells, stash), the others must be compared with @ref stage.
+	 * Counts the section as skipped when it is clean.
+	 */
+	bool isClean(PlayerSaveSection section) const;
+
+	/**
+	 * @brief Stages the snapshot that is about to be written.
+	 *
+	 * @param fingerprint Hash of every row the section writes.
+	 * @param rows Per-row hashes, only for item tables.
+	 * @return false (and counts the section as skipped) when it matches the committed snapshot.
+	 */
+	bool stage(PlayerSaveSection section, size_t fingerprint, ItemRows rows = {});
+
+	/**
+	 * @brief Rows of the committed snapshot, nullptr when the database content is unknown.
+	 */
+	const ItemRows* getCommittedItemRows(PlayerSaveSection section) const;
+
+	/**
+	 * @brief Makes the staged snapshots the reference for the next save.
+	 */
+	void commit();
+
+	/**
+	 * @brief Drops the staged snapshots, the database still holds the committed ones.
+	 */
+	void discard();
+
+private:
+	struct Snapshot {
+		uint32_t version = 0;
+		size_t fingerprint = 0;
+		ItemRows rows;
+	};
+
+	static constexpr size_t SECTIONS = static_cast<size_t>(PlayerSaveSection::Bosstiary) + 1;
+
+	std::array<uint32_t, SECTIONS> m_versions {};
+	std::array<std::optional<Snapshot>, SECTIONS> m_committed;
+	std::array<std::optional<Snapshot>, SECTIONS> m_staged;
+};
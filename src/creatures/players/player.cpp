@@ -2127,6 +2127,12 @@ void Player::sendMagicEffect(const Position &pos, uint16_t type) const {
 	}
 }
 
+void Player::sendTileEffects(const TileEffects &effects, SourceEffect_t source) const {
+	if (client) {
+		client->sendTileEffects(effects, source);
+	}
+}
+
 void Player::removeMagicEffect(const Position &pos, uint16_t type) const {
 	if (client) {
 		client->removeMagicEffect(pos, type);
@@ -2811,11 +2817,14 @@ void Player::setEditHouse(const std::shared_ptr<House> &house, uint32_t listId)
 void Player::learnInstantSpell(const std::string &spellName) {
 	if (!hasLearnedInstantSpell(spellName)) {
 		learnedInstantSpellList.emplace_back(spellName);
+		m_saveState.setDirty(PlayerSaveSection::Spells);
 	}
 }
 
 void Player::forgetInstantSpell(const std::string &spellName) {
-	std::erase(learnedInstantSpellList, spellName);
+	if (std::erase(learnedInstantSpellList, spellName) != 0) {
+		m_saveState.setDirty(PlayerSaveSection::Spells);
+	}
 }
 
 bool Player::hasLearnedInstantSpell(const std::string &spellName) const {
@@ -4993,6 +5002,7 @@ bool Player::removeItemCountById(uint16_t itemId, uint32_t itemAmount, bool remo
 }
 
 void Player::addItemOnStash(uint16_t itemId, uint32_t amount) {
+	m_saveState.setDirty(PlayerSaveSection::Stash);
 	const auto it = stashItems.find(itemId);
 	if (it != stashItems.end()) {
 		stashItems[itemId] += amount;
@@ -5020,6 +5030,7 @@ bool Player::withdrawItem(uint16_t itemId, uint32_t amount) {
 		} else {
 			return false;
 		}
+		m_saveState.setDirty(PlayerSaveSection::Stash);
 		return true;
 	}
 	return false;
@@ -6492,6 +6503,8 @@ void Player::sendAddTileItem(const std::shared_ptr<Tile> &itemTile, const Positi
 }
 
 void Player::sendUpdateTileItem(const std::shared_ptr<Tile> &updateTile, const Position &pos, const std::shared_ptr<Item> &item) {
+	// Attribute changes can reach clients without going through the tile
+	updateTile->invalidateDescription();
 	if (client) {
 		int32_t stackpos = updateTile->getStackposOfItem(static_self_cast<Player>(), item);
 		if (stackpos != -1) {
@@ -11222,6 +11235,15 @@ const PlayerStorage &Player::storage() const {
 	return m_storage;
 }
 
+// Save state interface
+PlayerSaveState &Player::saveState() {
+	return m_saveState;
+}
+
+const PlayerSaveState &Player::saveState() const {
+	return m_saveState;
+}
+
 void Player::sendLootMessage(const std::string &message) const {
 	const auto &party = getParty();
 	if (!party) {
@@ -23,6 +23,7 @@
 #include "creatures/players/components/player_badge.hpp"
 #include "creatures/players/components/player_cyclopedia.hpp"
 #include "creatures/players/components/player_forge_history.hpp"
+#include "creatures/players/components/player_save_state.hpp"
 #include "creatures/players/components/player_storage.hpp"
 #include "creatures/players/components/player_title.hpp"
 #include "creatures/players/components/wheel/player_wheel.hpp"
@@ -55,6 +56,7 @@ class Container;
 class KV;
 class BedItem;
 class Npc;
+class TileEffects;
 
 struct ModalWindow;
 struct Achievement;
@@ -895,6 +897,7 @@ public:
 	void sendClientCheck() const;
 	void sendGameNews() const;
 	void sendMagicEffect(const Position &pos, uint16_t type) const;
+	void sendTileEffects(const TileEffects &effects, SourceEffect_t source) const;
 	void removeMagicEffect(const Position &pos, uint16_t type) const;
 	void sendPing();
 	void sendPingBack() const;
@@ -1339,6 +1342,9 @@ public:
 	PlayerStorage &storage();
 	const PlayerStorage &storage() const;
 
+	PlayerSaveState &saveState();
+	const PlayerSaveState &saveState() const;
+
 	void sendLootMessage(const std::string &message) const;
 
 	std::shared_ptr<Container> getLootPouch();
@@ -1721,6 +1727,7 @@ private:
 	PlayerAttachedEffects m_playerAttachedEffects;
 	PlayerStorage m_storage;
 	PlayerForgeHistory m_forgeHistoryPlayer;
+	PlayerSaveState m_saveState;
 
 	std::mutex quickLootMutex;
 
@@ -10,14 +10,25 @@
 #include "database/database.hpp"
 
 #include "config/configmanager.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "lib/di/container.hpp"
 #include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
+namespace {
+	// Connection checked out by the current thread, kept while a query or transaction is running
+	struct ThreadConnection {
+		const Database* owner = nullptr;
+		MYSQL* handle = nullptr;
+		uint32_t depth = 0;
+		uint64_t lastInsertId = 0;
+	};
+
+	thread_local ThreadConnection threadConnection;
+}
+
 Database::~Database() {
-	if (handle != nullptr) {
-		mysql_close(handle);
-	}
+	disconnect();
 }
 
 Database &Database::getInstance() {
@@ -25,35 +36,78 @@ Database &Database::getInstance() {
 }
 
 bool Database::connect() {
-	return connect(&g_configManager().getString(MYSQL_HOST), &g_configManager().getString(MYSQL_USER), &g_configManager().getString(MYSQL_PASS), &g_configManager().getString(MYSQL_DB), g_configManager().getNumber(SQL_PORT), &g_configManager().getString(MYSQL_SOCK));
+	return connect(&g_configManager().getString(MYSQL_HOST), &g_configManager().getString(MYSQL_USER), &g_configManager().getString(MYSQL_PASS), &g_configManager().getString(MYSQL_DB), g_configManager().getNumber(SQL_PORT), &g_configManager().getString(MYSQL_SOCK), g_configManager().getNumber(MYSQL_POOL_SIZE));
 }
 
-bool Database::connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock) {
-	// connection handle initialization
-	handle = mysql_init(nullptr);
-	if (!handle) {
-		g_logger().error("Failed to initialize MySQL connection handle.");
-		return false;
-	}
+bool Database::connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock, uint32_t poolSize) {
+	disconnect();
 
 	if (host->empty() || user->empty() || password->empty() || database->empty() || port <= 0) {
 		g_logger().warn("MySQL host, user, password, database or port not provided");
 	}
 
-	// automatic reconnect
-	bool reconnect = true;
-	mysql_options(handle, MYSQL_OPT_RECONNECT, &reconnect);
+	const auto openConnection = [&]() -> MYSQL* {
+		// connection handle initialization
+		MYSQL* handle = mysql_init(nullptr);
+		if (!handle) {
+			g_logger().error("Failed to initialize MySQL connection handle.");
+			return nullptr;
+		}
+
+		// automatic reconnect
+		bool reconnect = true;
+		mysql_options(handle, MYSQL_OPT_RECONNECT, &reconnect);
 
-	// Remove ssl verification
-	bool ssl_enabled = false;
-	mysql_options(handle, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, &ssl_enabled);
+		// Remove ssl verification
+		bool ssl_enabled = false;
+		mysql_options(handle, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, &ssl_enabled);
 
-	// connects to database
-	if (!mysql_real_connect(handle, host->c_str(), user->c_str(), password->c_str(), database->c_str(), port, sock->c_str(), 0)) {
-		g_logger().error("MySQL Error Message: {}", mysql_error(handle));
+		// connects to database
+		if (!mysql_real_connect(handle, host->c_str(), user->c_str(), password->c_str(), database->c_str(), port, sock->c_str(), 0)) {
+			g_logger().error("MySQL Error Message: {}", mysql_error(handle));
+			mysql_close(handle);
+			return nullptr;
+		}
+		return handle;
+	};
+
+	poolSize = std::max<uint32_t>(poolSize, 1);
+	std::vector<MYSQL*> opened;
+	for (uint32_t i = 0; i < poolSize; ++i) {
+		MYSQL* handle = openConnection();
+		if (!handle) {
+			break;
+		}
+		opened.emplace_back(handle);
+	}
+
+	if (opened.empty()) {
 		return false;
 	}
 
+	// Threads that hold no pooled connection escape on their own handle, never on one running a query
+	MYSQL* handle = openConnection();
+	if (!handle) {
+		for (MYSQL* pooled : opened) {
+			mysql_close(pooled);
+		}
+		return false;
+	}
+	{
+		std::scoped_lock lock(escapeMutex);
+		escapeHandle = handle;
+	}
+
+	if (opened.size() < poolSize) {
+		g_logger().warn("Only {} of {} MySQL connections could be opened", opened.size(), poolSize);
+	}
+
+	{
+		std::scoped_lock lock(poolMutex);
+		connections = opened;
+		idleConnections = std::move(opened);
+	}
+
 	DBResult_ptr result = storeQuery("SHOW VARIABLES LIKE 'max_allowed_packet'");
 	if (result) {
 		maxPacketSize = result->getNumber<uint64_t>("Value");
@@ -61,6 +115,97 @@ bool Database::connect(const std::string* host, const std::string* user, const s
 	return true;
 }
 
+void Database::disconnect() {
+	{
+		std::scoped_lock lock(poolMutex);
+		for (MYSQL* handle : idleConnections) {
+			mysql_close(handle);
+		}
+		// Connections still checked out by other threads are closed once they are released
+		for (MYSQL* handle : connections) {
+			if (std::ranges::find(idleConnections, handle) == idleConnections.end()) {
+				closingConnections.emplace_back(handle);
+			}
+		}
+		connections.clear();
+		idleConnections.clear();
+	}
+	// Threads waiting for a connection give up instead of waiting forever
+	poolSignal.notify_all();
+
+	std::scoped_lock lock(escapeMutex);
+	if (escapeHandle) {
+		mysql_close(escapeHandle);
+		escapeHandle = nullptr;
+	}
+}
+
+MYSQL* Database::acquireConnection() {
+	// Nested calls and open transactions keep using the connection already held by this thread
+	if (threadConnection.owner == this && threadConnection.handle) {
+		++threadConnection.depth;
+		return threadConnection.handle;
+	}
+
+	metrics::lock_latency measureLock("database_pool");
+	std::unique_lock lock(poolMutex);
+	poolSignal.wait(lock, [this] { return !idleConnections.empty() || connections.empty(); });
+	measureLock.stop();
+
+	if (idleConnections.empty()) {
+		return nullptr;
+	}
+
+	MYSQL* handle = idleConnections.back();
+	idleConnections.pop_back();
+	lock.unlock();
+
+	g_metrics().addCounter("database_pool_checkouts", 1);
+	g_metrics().addUpDownCounter("database_pool_in_use", 1);
+
+	threadConnection.owner = this;
+	threadConnection.handle = handle;
+	threadConnection.depth = 1;
+	return handle;
+}
+
+void Database::releaseConnection() {
+	if (threadConnection.owner != this || !threadConnection.handle) {
+		return;
+	}
+
+	if (--threadConnection.depth > 0) {
+		return;
+	}
+
+	MYSQL* handle = threadConnection.handle;
+	threadConnection.owner = nullptr;
+	threadConnection.handle = nullptr;
+
+	g_metrics().addUpDownCounter("database_pool_in_use", -1);
+
+	{
+		std::scoped_lock lock(poolMutex);
+		// A connection checked out before disconnect() is closed instead of returned to the pool
+		if (const auto it = std::ranges::find(closingConnections, handle); it != closingConnections.end()) {
+			closingConnections.erase(it);
+			mysql_close(handle);
+			return;
+		}
+		idleConnections.emplace_back(handle);
+	}
+	poolSignal.notify_one();
+}
+
+size_t Database::getPoolSize() const {
+	std::scoped_lock lock(poolMutex);
+	return connections.size();
+}
+
+uint64_t Database::getLastInsertId() const {
+	return threadConnection.lastInsertId;
+}
+
 void Database::createDatabaseBackup(bool compress) const {
 	if (!g_configManager().getBoolean(MYSQL_DB_BACKUP)) {
 		return;
@@ -158,17 +303,22 @@ void Database::createDatabaseBackup(bool compress) const {
 }
 
 bool Database::beginTransaction() {
+	// The connection stays bound to this thread until commit or rollback
+	if (!acquireConnection()) {
+		g_logger().error("Database not initialized!");
+		return false;
+	}
+
 	if (!executeQuery("BEGIN")) {
+		releaseConnection();
 		return false;
 	}
-	metrics::lock_latency measureLock("database");
-	databaseLock.lock();
-	measureLock.stop();
 
 	return true;
 }
 
 bool Database::rollback() {
+	MYSQL* handle = threadConnection.owner == this ? threadConnection.handle : nullptr;
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return false;
@@ -176,26 +326,27 @@ bool Database::rollback() {
 
 	if (mysql_rollback(handle) != 0) {
 		g_logger().error("Message: {}", mysql_error(handle));
-		databaseLock.unlock();
+		releaseConnection();
 		return false;
 	}
 
-	databaseLock.unlock();
+	releaseConnection();
 	return true;
 }
 
 bool Database::commit() {
+	MYSQL* handle = threadConnection.owner == this ? threadConnection.handle : nullptr;
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return false;
 	}
 	if (mysql_commit(handle) != 0) {
 		g_logger().error("Message: {}", mysql_error(handle));
-		databaseLock.unlock();
+		releaseConnection();
 		return false;
 	}
 
-	databaseLock.unlock();
+	releaseConnection();
 	return true;
 }
 
@@ -203,7 +354,7 @@ bool Database::isRecoverableError(unsigned int error) {
 	return error == CR_SERVER_LOST || error == CR_SERVER_GONE_ERROR || error == CR_CONN_HOST_ERROR || error == 1053 /*ER_SERVER_SHUTDOWN*/ || error == CR_CONNECTION_ERROR;
 }
 
-bool Database::retryQuery(std::string_view query, int retries) {
+bool Database::retryQuery(MYSQL* handle, std::string_view query, int retries) {
 	while (retries > 0 && mysql_query(handle, query.data()) != 0) {
 		g_logger().error("Query: {}", query.substr(0, 256));
 		g_logger().error("MySQL error [{}]: {}", mysql_errno(handle), mysql_error(handle));
@@ -221,7 +372,38 @@ bool Database::retryQuery(std::string_view query, int retries) {
 	return true;
 }
 
-bool Database::executeQuery(std::string_view query) {
+void Database::reportBlockingQuery(std::string_view query, const std::source_location &location) {
+	if (!g_configManager().getBoolean(REPORT_BLOCKING_QUERIES)) {
+		return;
+	}
+
+	// Tasks of the thread pool run without a dispatcher context
+	const auto &context = g_dispatcher().context();
+	if (context.getType() == DispatcherType::None) {
+		return;
+	}
+
+	const std::string taskName { context.getName() };
+	const auto site = fmt::format("{}:{}", std::filesystem::path(location.file_name()).filename().string(), location.line());
+	g_metrics().addCounter("database_blocking_queries", 1, { { "task", taskName }, { "site", site } });
+
+	const auto now = OTSYS_TIME();
+	{
+		std::scoped_lock lock(blockingReportMutex);
+		auto &lastReport = blockingReports[site];
+		if (lastReport != 0 && now - lastReport < 60 * 1000) {
+			return;
+		}
+		lastReport = now;
+	}
+
+	g_logger().warn("[Database::reportBlockingQuery] - Task {} blocked the dispatcher in {} ({}) with the query: {}", taskName, site, location.function_name(), query.substr(0, 100));
+}
+
+bool Database::executeQuery(std::string_view query, const std::source_location &location) {
+	reportBlockingQuery(query, location);
+
+	MYSQL* handle = acquireConnection();
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return false;
@@ -229,42 +411,41 @@ bool Database::executeQuery(std::string_view query) {
 
 	g_logger().trace("Executing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
-	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
-
 	metrics::query_latency measure(query.substr(0, 50));
-	bool success = retryQuery(query, 10);
+	bool success = retryQuery(handle, query, 10);
 	mysql_free_result(mysql_store_result(handle));
+	threadConnection.lastInsertId = static_cast<uint64_t>(mysql_insert_id(handle));
 
+	releaseConnection();
 	return success;
 }
 
-DBResult_ptr Database::storeQuery(std::string_view query) {
+DBResult_ptr Database::storeQuery(std::string_view query, const std::source_location &location) {
+	reportBlockingQuery(query, location);
+
+	MYSQL* handle = acquireConnection();
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return nullptr;
 	}
 	g_logger().trace("Storing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
-	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
-
 	metrics::query_latency measure(query.substr(0, 50));
 retry:
 	if (mysql_query(handle, query.data()) != 0) {
 		g_logger().error("Query: {}", query);
 		g_logger().error("Message: {}", mysql_error(handle));
 		if (!isRecoverableError(mysql_errno(handle))) {
+			releaseConnection();
 			return nullptr;
 		}
 		std::this_thread::sleep_for(std::chrono::seconds(1));
 		goto retry;
 	}
 
-	// Retrieving results of query
+	// Retrieving results of query, the result set is fully buffered so the connection can be released
 	MYSQL_RES* res = mysql_store_result(handle);
+	releaseConnection();
 	if (res != nullptr) {
 		DBResult_ptr result = std::make_shared<DBResult>(res);
 		if (!result->hasNext()) {
@@ -294,7 +475,17 @@ std::string Database::escapeBlob(const char* s, uint32_t length) const {
 
 	if (length != 0) {
 		std::string output(maxLength, '\0');
-		size_t escapedLength = mysql_real_escape_string(handle, &output[0], s, length);
+		size_t escapedLength = 0;
+		if (threadConnection.owner == this && threadConnection.handle) {
+			escapedLength = mysql_real_escape_string(threadConnection.handle, &output[0], s, length);
+		} else {
+			std::scoped_lock lock(escapeMutex);
+			if (!escapeHandle) {
+				g_logger().error("Database not initialized!");
+				return {};
+			}
+			escapedLength = mysql_real_escape_string(escapeHandle, &output[0], s, length);
+		}
 		output.resize(escapedLength);
 		escaped.append(output);
 	}
@@ -309,43 +500,57 @@ DBResult::DBResult(MYSQL_RES* res) {
 	int num_fields = mysql_num_fields(handle);
 
 	const MYSQL_FIELD* fields = mysql_fetch_fields(handle);
+	listNames.reserve(num_fields);
 	for (size_t i = 0; i < num_fields; i++) {
 		listNames[fields[i].name] = i;
 	}
 	row = mysql_fetch_row(handle);
+	lengths = row ? mysql_fetch_lengths(handle) : nullptr;
 }
 
 DBResult::~DBResult() {
 	mysql_free_result(handle);
 }
 
-std::string DBResult::getString(const std::string &s) const {
-	auto it = listNames.find(s);
-	if (it == listNames.end()) {
-		g_logger().error("Column '{}' does not exist in result set", s);
+DBColumn DBResult::getColumn(std::string_view name) const {
+	const auto it = listNames.find(name);
+	return it != listNames.end() ? DBColumn(it->second) : DBColumn();
+}
+
+std::string DBResult::getString(std::string_view name) const {
+	const auto column = getColumn(name);
+	if (!column.isValid()) {
+		g_logger().error("Column '{}' does not exist in result set", name);
 		return {};
 	}
-	if (row[it->second] == nullptr) {
+	return getString(column);
+}
+
+std::string DBResult::getString(const DBColumn &column) const {
+	if (!column.isValid() || row[column.index] == nullptr) {
 		return {};
 	}
-	return std::string(row[it->second]);
+	return std::string(row[column.index]);
 }
 
-const char* DBResult::getStream(const std::string &s, unsigned long &size) const {
-	auto it = listNames.find(s);
-	if (it == listNames.end()) {
-		g_logger().error("Column '{}' doesn't exist in the result set", s);
+const char* DBResult::getStream(std::string_view name, unsigned long &size) const {
+	const auto column = getColumn(name);
+	if (!column.isValid()) {
+		g_logger().error("Column '{}' doesn't exist in the result set", name);
 		size = 0;
 		return nullptr;
 	}
+	return getStream(column, size);
+}
 
-	if (row[it->second] == nullptr) {
+const char* DBResult::getStream(const DBColumn &column, unsigned long &size) const {
+	if (!column.isValid() || row[column.index] == nullptr) {
 		size = 0;
 		return nullptr;
 	}
 
-	size = mysql_fetch_lengths(handle)[it->second];
-	return row[it->second];
+	size = lengths[column.index];
+	return row[column.index];
 }
 
 uint8_t DBResult::getU8FromString(const std::string &string, const std::string &function) {
@@ -382,6 +587,7 @@ bool DBResult::next() {
 		return false;
 	}
 	row = mysql_fetch_row(handle);
+	lengths = row ? mysql_fetch_lengths(handle) : nullptr;
 	return row != nullptr;
 }
 
@@ -424,7 +630,7 @@ void DBInsert::upsert(const std::vector<std::string> &columns) {
 	upsertColumns = columns;
 }
 
-bool DBInsert::execute() {
+bool DBInsert::execute(const std::source_location &location) {
 	if (values.empty()) {
 		return true;
 	}
@@ -465,7 +671,7 @@ bool DBInsert::execute() {
 
 		std::ostringstream query;
 		query << baseQuery << " " << batchValues << upsertQuery;
-		if (!Database::getInstance().executeQuery(query.str())) {
+		if (!Database::getInstance().executeQuery(query.str(), location)) {
 			return false;
 		}
 	}
@@ -13,7 +13,10 @@
 
 #ifndef USE_PRECOMPILED_HEADERS
 	#include <mysql/mysql.h>
+	#include <charconv>
+	#include <condition_variable>
 	#include <mutex>
+	#include <source_location>
 	#include <utility>
 #endif
 
@@ -35,7 +38,16 @@ public:
 
 	bool connect();
 
-	bool connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock);
+	/**
+	 * @brief Opens the connection pool.
+	 *
+	 * Every query checks out one connection from the pool for its duration, so queries issued
+	 * from different threads run concurrently. A transaction keeps its connection bound to the
+	 * calling thread until it is committed or rolled back.
+	 *
+	 * @param poolSize Number of connections to open, at least one is always opened.
+	 */
+	bool connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock, uint32_t poolSize = 1);
 
 	/**
 	 * @brief Creates a backup of the database.
@@ -54,18 +66,21 @@ public:
 	 */
 	void createDatabaseBackup(bool compress) const;
 
-	bool retryQuery(std::string_view query, int retries);
-	bool executeQuery(std::string_view query);
+	/**
+	 * @param location Calling site, named when reportBlockingQueries reports the query.
+	 */
+	bool executeQuery(std::string_view query, const std::source_location &location = std::source_location::current());
 
-	DBResult_ptr storeQuery(std::string_view query);
+	DBResult_ptr storeQuery(std::string_view query, const std::source_location &location = std::source_location::current());
 
 	std::string escapeString(const std::string &s) const;
 
 	std::string escapeBlob(const char* s, uint32_t length) const;
 
-	uint64_t getLastInsertId() const {
-		return static_cast<uint64_t>(mysql_insert_id(handle));
-	}
+	/**
+	 * @brief Returns the id generated by the last query executed on the calling thread.
+	 */
+	uint64_t getLastInsertId() const;
 
 	static const char* getClientVersion() {
 		return mysql_get_client_info();
@@ -75,22 +90,70 @@ public:
 		return maxPacketSize;
 	}
 
+	size_t getPoolSize() const;
+
 private:
 	bool beginTransaction();
 	bool rollback();
 	bool commit();
 
-	static bool isRecoverableError(unsigned int error);
+	MYSQL* acquireConnection();
+	void releaseConnection();
+	void disconnect();
+
+	/**
+	 * @brief Counts a query that blocks the dispatcher and warns which task and calling site ran it.
+	 *
+	 * Enabled by reportBlockingQueries. The warning of a calling site is repeated at most once a minute.
+	 */
+	void reportBlockingQuery(std::string_view query, const std::source_location &location);
 
-	MYSQL* handle = nullptr;
-	std::recursive_mutex databaseLock;
+	static bool isRecoverableError(unsigned int error);
+	bool retryQuery(MYSQL* handle, std::string_view query, int retries);
+
+	// Guarded by poolMutex
+	std::vector<MYSQL*> connections;
+	std::vector<MYSQL*> idleConnections;
+	// Checked out when the pool was disconnected, closed by their thread on release
+	std::vector<MYSQL*> closingConnections;
+	mutable std::mutex poolMutex;
+	std::condition_variable poolSignal;
+	// Escapes strings for threads that hold no pooled connection
+	MYSQL* escapeHandle = nullptr;
+	mutable std::mutex escapeMutex;
 	uint64_t maxPacketSize = 1048576;
 
+	std::mutex blockingReportMutex;
+	// [std::string = calling site, int64_t = time of the last warning]
+	phmap::flat_hash_map<std::string, int64_t> blockingReports;
+
 	friend class DBTransaction;
 };
 
 constexpr auto g_database = Database::getInstance;
 
+/**
+ * @brief A column of a result set, resolved once by name and then read by index for every row.
+ */
+class DBColumn {
+public:
+	DBColumn() = default;
+
+	bool isValid() const {
+		return index != INVALID_INDEX;
+	}
+
+private:
+	static constexpr size_t INVALID_INDEX = std::numeric_limits<size_t>::max();
+
+	explicit DBColumn(size_t index) :
+		index(index) { }
+
+	size_t index = INVALID_INDEX;
+
+	friend class DBResult;
+};
+
 class DBResult {
 public:
 	explicit DBResult(MYSQL_RES* res);
@@ -100,88 +163,58 @@ public:
 	DBResult(const DBResult &) = delete;
 	DBResult &operator=(const DBResult &) = delete;
 
+	/**
+	 * @brief Resolves a column by name, to read it in a loop over the rows without a lookup per cell.
+	 */
+	DBColumn getColumn(std::string_view name) const;
+
 	template <typename T>
-	T getNumber(const std::string &s) const {
-		auto it = listNames.find(s);
-		if (it == listNames.end()) {
-			g_logger().error("[DBResult::getNumber] - Column '{}' doesn't exist in the result set", s);
-			return T();
-		}
+	T getNumber(std::string_view name) const {
+		return getNumber<T>(getColumn(name), name);
+	}
 
-		if (row[it->second] == nullptr) {
-			return T();
-		}
+	template <typename T>
+	T getNumber(const DBColumn &column) const {
+		return getNumber<T>(column, {});
+	}
 
-		T data {};
-		try {
-			// Check if the type T is a enum
-			if constexpr (std::is_enum_v<T>) {
-				using underlying_type = std::underlying_type_t<T>;
-				underlying_type value = 0;
-				if constexpr (std::is_signed_v<underlying_type>) {
-					value = static_cast<underlying_type>(std::stoll(row[it->second]));
-				} else {
-					value = static_cast<underlying_type>(std::stoull(row[it->second]));
+	/**
+	 * @brief Parses the text of a numeric cell, as MySQL sends it.
+	 *
+	 * Integers are parsed into a 64-bit value and then narrowed to T, so a small type
+	 * keeps the low bits of a larger value and a negative value read as unsigned wraps.
+	 * @return nullopt if the text is not an integer or does not fit 64 bits.
+	 */
+	template <typename T>
+	static std::optional<T> parseNumber(std::string_view text) {
+		if constexpr (std::is_enum_v<T>) {
+			const auto value = parseNumber<std::underlying_type_t<T>>(text);
+			return value ? std::optional<T>(static_cast<T>(*value)) : std::nullopt;
+		} else {
+			static_assert(std::is_integral_v<T>, "DBResult::parseNumber only parses integers");
+
+			const auto* begin = text.data();
+			const auto* end = text.data() + text.size();
+			if (std::is_signed_v<T> || (!text.empty() && text.front() == '-')) {
+				int64_t value = 0;
+				if (std::from_chars(begin, end, value).ec != std::errc()) {
+					return std::nullopt;
 				}
 				return static_cast<T>(value);
 			}
-			// Check if the type T is signed or unsigned
-			if constexpr (std::is_signed_v<T>) {
-				// Check if the type T is int8_t or int16_t
-				if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>) {
-					// Use std::stoi to convert string to int8_t
-					data = static_cast<T>(std::stoi(row[it->second]));
-				}
-				// Check if the type T is int32_t
-				else if constexpr (std::is_same_v<T, int32_t>) {
-					// Use std::stol to convert string to int32_t
-					data = static_cast<T>(std::stol(row[it->second]));
-				}
-				// Check if the type T is int64_t
-				else if constexpr (std::is_same_v<T, int64_t>) {
-					// Use std::stoll to convert string to int64_t
-					data = static_cast<T>(std::stoll(row[it->second]));
-				}
-				// Check if the type T is time_t
-				else if constexpr (std::is_same_v<T, time_t>) {
-					// Use std::stoll to convert string to time_t (usually long long)
-					data = static_cast<T>(std::stoll(row[it->second]));
-				} else {
-					// Throws exception indicating that type T is invalid
-					g_logger().error("Invalid signed type T");
-				}
-			} else if (std::is_same<T, bool>::value) {
-				data = static_cast<T>(std::stoi(row[it->second]));
-			} else {
-				// Check if the type T is uint8_t or uint16_t or uint32_t
-				if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> || std::is_same_v<T, uint32_t>) {
-					// Use std::stoul to convert string to uint8_t
-					data = static_cast<T>(std::stoul(row[it->second]));
-				}
-				// Check if the type T is uint64_t
-				else if constexpr (std::is_same_v<T, uint64_t>) {
-					// Use std::stoull to convert string to uint64_t
-					data = static_cast<T>(std::stoull(row[it->second]));
-				} else {
-					// Send log indicating that type T is invalid
-					g_logger().error("Column '{}' has an invalid unsigned T is invalid", s);
-				}
+
+			uint64_t value = 0;
+			if (std::from_chars(begin, end, value).ec != std::errc()) {
+				return std::nullopt;
 			}
-		} catch (std::invalid_argument &e) {
-			// Value of string is invalid
-			g_logger().error("Column '{}' has an invalid value set, error code: {}", s, e.what());
-			data = T();
-		} catch (std::out_of_range &e) {
-			// Value of string is too large to fit the range allowed by type T
-			g_logger().error("Column '{}' has a value out of range, error code: {}", s, e.what());
-			data = T();
+			return static_cast<T>(value);
 		}
-
-		return data;
 	}
 
-	std::string getString(const std::string &s) const;
-	const char* getStream(const std::string &s, unsigned long &size) const;
+	std::string getString(std::string_view name) const;
+	std::string getString(const DBColumn &column) const;
+	const char* getStream(std::string_view name, unsigned long &size) const;
+	const char* getStream(const DBColumn &column, unsigned long &size) const;
 	static uint8_t getU8FromString(const std::string &string, const std::string &function);
 	static int8_t getInt8FromString(const std::string &string, const std::string &function);
 
@@ -190,10 +223,31 @@ public:
 	bool next();
 
 private:
+	template <typename T>
+	T getNumber(const DBColumn &column, std::string_view name) const {
+		if (!column.isValid()) {
+			g_logger().error("[DBResult::getNumber] - Column '{}' doesn't exist in the result set", name);
+			return T();
+		}
+
+		const auto* cell = row[column.index];
+		if (cell == nullptr) {
+			return T();
+		}
+
+		const auto value = parseNumber<T>({ cell, lengths[column.index] });
+		if (!value) {
+			g_logger().error("[DBResult::getNumber] - Column '{}' has an invalid value set: {}", name.empty() ? fmt::format("#{}", column.index) : std::string(name), cell);
+			return T();
+		}
+		return *value;
+	}
+
 	MYSQL_RES* handle;
 	MYSQL_ROW row;
+	unsigned long* lengths = nullptr;
 
-	std::map<std::string_view, size_t> listNames;
+	phmap::flat_hash_map<std::string_view, size_t> listNames;
 
 	friend class Database;
 };
@@ -207,7 +261,7 @@ public:
 	void upsert(const std::vector<std::string> &columns);
 	bool addRow(std::string_view row);
 	bool addRow(std::ostringstream &row);
-	bool execute();
+	bool execute(const std::source_location &location = std::source_location::current());
 
 private:
 	std::vector<std::string> upsertColumns;
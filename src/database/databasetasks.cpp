@@ -38,3 +38,9 @@ void DatabaseTasks::store(const std::string &query, const std::function<void(DBR
 		}
 	});
 }
+
+std::future<bool> DatabaseTasks::executeAsync(std::string query) {
+	return threadPool.submit_task([this, query = std::move(query)] {
+		return db.executeQuery(query);
+	});
+}
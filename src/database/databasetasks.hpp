@@ -10,6 +10,7 @@
 #pragma once
 
 #include "database/database.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "lib/thread/thread_pool.hpp"
 
 class DatabaseTasks {
@@ -25,6 +26,39 @@ public:
 	void execute(const std::string &query, const std::function<void(DBResult_ptr, bool)> &callback = nullptr);
 	void store(const std::string &query, const std::function<void(DBResult_ptr, bool)> &callback = nullptr);
 
+	/**
+	 * @brief Runs the query on the thread pool and parses its result there.
+	 *
+	 * The parser receives the result, or nullptr if the query returned no rows, and
+	 * its return value is the value of the future. Wait on the future off the dispatcher.
+	 */
+	template <typename Parser>
+	auto storeAsync(std::string query, Parser &&parse) {
+		return threadPool.submit_task([this, query = std::move(query), parse = std::forward<Parser>(parse)] {
+			return parse(db.storeQuery(query));
+		});
+	}
+
+	/**
+	 * @brief Runs the query and parses its result on the thread pool, then calls back on the dispatcher with the parsed value.
+	 *
+	 * Nothing but the parsed value should be read from the game state in the callback's
+	 * captures, the game may have changed while the query ran.
+	 */
+	template <typename Parser, typename Callback>
+	void storeAsync(std::string query, Parser &&parse, Callback &&callback) {
+		threadPool.detach_task([this, query = std::move(query), parse = std::forward<Parser>(parse), callback = std::forward<Callback>(callback)] {
+			using Result = std::invoke_result_t<const std::decay_t<Parser> &, DBResult_ptr>;
+			auto value = std::make_shared<Result>(parse(db.storeQuery(query)));
+			g_dispatcher().addEvent([callback, value] { callback(std::move(*value)); }, "DatabaseTasks::storeAsync");
+		});
+	}
+
+	/**
+	 * @return A future holding whether the query succeeded.
+	 */
+	std::future<bool> executeAsync(std::string query);
+
 private:
 	Database &db;
 	ThreadPool &threadPool;
@@ -53,6 +53,7 @@
 #include "server/network/protocol/protocollogin.hpp"
 #include "server/network/protocol/protocolstatus.hpp"
 #include "server/network/protocol/protocolgame.hpp"
+#include "server/network/protocol/tile_effects.hpp"
 #include "server/network/webhook/webhook.hpp"
 #include "server/server.hpp"
 #include "utils/tools.hpp"
@@ -565,6 +566,9 @@ void Game::start(ServiceManager* manager) {
 	g_dispatcher().cycleEvent(
 		UPDATE_PLAYERS_ONLINE_DB, [this] { updatePlayersOnline(); }, "Game::updatePlayersOnline"
 	);
+	g_dispatcher().cycleEvent(
+		1000, [this] { map.reportPathMetrics(); }, "Map::reportPathMetrics"
+	);
 }
 
 GameState_t Game::getGameState() const {
@@ -653,6 +657,7 @@ void Game::setGameState(GameState_t newState) {
 
 			saveMotdNum();
 			g_saveManager().saveAll();
+			IOMarket::getInstance().flush();
 
 			g_dispatcher().addEvent([this] { shutdown(); }, __FUNCTION__);
 
@@ -683,8 +688,6 @@ void Game::setGameState(GameState_t newState) {
 }
 
 void Game::loadItemsPrice() {
-	IOMarket::getInstance().updateStatistics();
-
 	// Update purchased offers (market_history)
 	const auto &stats = IOMarket::getInstance().getPurchaseStatistics();
 	for (const auto &[itemId, itemStats] : stats) {
@@ -8323,6 +8326,31 @@ void Game::addMagicEffect(const CreatureVector &spectators, const Position &pos,
 	}
 }
 
+void Game::addTileEffects(const CreatureVector &spectators, const TileEffects &effects, const std::shared_ptr<Creature> &actor) {
+	if (effects.empty()) {
+		return;
+	}
+
+	using enum SourceEffect_t;
+	for (const auto &spectator : spectators) {
+		const auto &tmpPlayer = spectator->getPlayer();
+		if (!tmpPlayer) {
+			continue;
+		}
+
+		SourceEffect_t source = CREATURES;
+		if (!actor || actor->getNpc()) {
+			source = GLOBAL;
+		} else if (actor == spectator) {
+			source = OWN;
+		} else if (actor->getPlayer()) {
+			source = OTHERS;
+		}
+
+		tmpPlayer->sendTileEffects(effects, source);
+	}
+}
+
 void Game::removeMagicEffect(const Position &pos, uint16_t effect) {
 	auto spectators = Spectators().find<Player>(pos, true);
 	removeMagicEffect(spectators.data(), pos, effect);
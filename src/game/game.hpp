@@ -50,6 +50,7 @@ class ContainerIterator;
 class Item;
 class BedItem;
 class WildcardTreeNode;
+class TileEffects;
 
 struct Achievement;
 struct HighscoreCategory;
@@ -488,6 +489,7 @@ public:
 	void addPlayerVocation(const std::shared_ptr<Player> &target);
 	void addMagicEffect(const Position &pos, uint16_t effect);
 	static void addMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect);
+	static void addTileEffects(const CreatureVector &spectators, const TileEffects &effects, const std::shared_ptr<Creature> &actor);
 	void removeMagicEffect(const Position &pos, uint16_t effect);
 	static void removeMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect);
 	void addDistanceEffect(const Position &fromPos, const Position &toPos, uint16_t effect);
@@ -10,6 +10,8 @@
 #include "game/scheduling/dispatcher.hpp"
 
 #include "lib/thread/thread_pool.hpp"
+#include "lib/thread/work_stealing_loop.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "lib/di/container.hpp"
 #include "utils/tools.hpp"
 
@@ -54,6 +56,8 @@ void Dispatcher::executeSerialEvents(const uint8_t groupId) {
 		return;
 	}
 
+	const auto depth = QueueDepth(static_cast<TaskGroup>(groupId), tasks.size());
+
 	dispacherContext.group = static_cast<TaskGroup>(groupId);
 	dispacherContext.type = DispatcherType::Event;
 
@@ -74,7 +78,9 @@ void Dispatcher::executeParallelEvents(const uint8_t groupId) {
 		return;
 	}
 
-	asyncWait(tasks.size(), [groupId, &tasks](size_t i) {
+	const auto depth = QueueDepth(static_cast<TaskGroup>(groupId), tasks.size());
+
+	parallelFor(static_cast<TaskGroup>(groupId), tasks.size(), [groupId, &tasks](size_t i) {
 		dispacherContext.type = DispatcherType::AsyncEvent;
 		dispacherContext.group = static_cast<TaskGroup>(groupId);
 		tasks[i].execute();
@@ -86,41 +92,57 @@ void Dispatcher::executeParallelEvents(const uint8_t groupId) {
 }
 
 void Dispatcher::asyncWait(size_t requestSize, std::function<void(size_t i)> &&f) {
+	parallelFor(dispacherContext.group, requestSize, f);
+}
+
+void Dispatcher::parallelFor(TaskGroup group, size_t requestSize, const std::function<void(size_t i)> &f) {
 	if (requestSize == 0) {
 		return;
 	}
 
 	// This prevents an async call from running inside another async call.
-	if (asyncWaitDisabled) {
+	const auto workers = asyncWaitDisabled ? 1 : std::min<size_t>(requestSize, threadPool.get_thread_count());
+	if (workers <= 1) {
 		for (uint_fast64_t i = 0; i < requestSize; ++i) {
 			f(i);
 		}
 		return;
 	}
 
-	const auto &partitions = generatePartition(requestSize);
-	const auto pSize = partitions.size();
+	// Pool workers may start after this call returned, so they share ownership of the
+	// body and of the loop holding the pending counter they wait on.
+	struct ParallelForState {
+		ParallelForState(size_t workers, size_t size, const std::function<void(size_t i)> &f) :
+			loop(workers, size), f(f) { }
 
-	BS::multi_future<void> retFuture;
+		WorkStealingLoop loop;
+		const std::function<void(size_t i)> f;
+	};
 
-	if (pSize > 1) {
-		asyncWaitDisabled = true;
-		const auto min = partitions[1].first;
-		const auto max = partitions[partitions.size() - 1].second;
-		retFuture = threadPool.submit_loop(min, max, [&f](const unsigned int i) { f(i); });
+	asyncWaitDisabled = true;
+	const auto state = std::make_shared<ParallelForState>(workers, requestSize, f);
+	for (size_t worker = 1; worker < workers; ++worker) {
+		threadPool.detach_task([state, worker] { state->loop.run(worker, state->f); });
 	}
 
-	const auto &[min, max] = partitions[0];
-	for (uint_fast64_t i = min; i < max; ++i) {
-		f(i);
-	}
+	state->loop.run(0, state->f);
+	state->loop.wait();
+	asyncWaitDisabled = false;
 
-	if (pSize > 1) {
-		retFuture.wait();
-		asyncWaitDisabled = false;
+	if (const auto steals = state->loop.getSteals(); steals > 0) {
+		g_metrics().addCounter("dispatcher_steals", static_cast<double>(steals), { { "group", std::string(magic_enum::enum_name(group)) } });
 	}
 }
 
+Dispatcher::QueueDepth::QueueDepth(TaskGroup group, size_t size) :
+	group(magic_enum::enum_name(group)), size(static_cast<int>(size)) {
+	g_metrics().addUpDownCounter("dispatcher_queue_depth", this->size, { { "group", this->group } });
+}
+
+Dispatcher::QueueDepth::~QueueDepth() {
+	g_metrics().addUpDownCounter("dispatcher_queue_depth", -size, { { "group", group } });
+}
+
 void Dispatcher::executeEvents(const TaskGroup startGroup) {
 	for (uint_fast8_t groupId = static_cast<uint8_t>(startGroup); groupId < static_cast<uint8_t>(TaskGroup::Last); ++groupId) {
 		const auto isWalk = groupId == static_cast<uint8_t>(TaskGroup::Walk);
@@ -190,21 +190,20 @@ private:
 		}
 	}
 
-	std::vector<std::pair<uint64_t, uint64_t>> generatePartition(size_t size) const {
-		if (size == 0) {
-			return {};
-		}
+	// Runs f(0..size-1) on the dispatcher and pool threads, idle threads steal indexes from busy ones
+	void parallelFor(TaskGroup group, size_t size, const std::function<void(size_t i)> &f);
 
-		std::vector<std::pair<uint64_t, uint64_t>> list;
-		list.reserve(threadPool.get_thread_count());
+	// Reports the tasks of a group as queued while the group executes
+	struct QueueDepth {
+		QueueDepth(TaskGroup group, size_t size);
+		~QueueDepth();
 
-		const auto size_per_block = std::ceil(size / static_cast<float>(threadPool.get_thread_count()));
-		for (uint_fast64_t i = 0; i < size; i += size_per_block) {
-			list.emplace_back(i, std::min<uint64_t>(size, i + size_per_block));
-		}
+		QueueDepth(const QueueDepth &) = delete;
+		QueueDepth &operator=(const QueueDepth &) = delete;
 
-		return list;
-	}
+		std::string group;
+		int size;
+	};
 
 	uint_fast64_t dispatcherCycle = 0;
 
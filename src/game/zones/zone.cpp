@@ -15,11 +15,20 @@
 #include "creatures/players/player.hpp"
 #include "utils/pugicast.hpp"
 #include "kv/kv.hpp"
+#include "map/map_const.hpp"
 
+// Declared before the zone maps so it outlives the zones they hold during static destruction
+phmap::flat_hash_map<uint64_t, std::vector<Zone::SectorZone>> Zone::zonesBySector = {};
 phmap::parallel_flat_hash_map<std::string, std::shared_ptr<Zone>> Zone::zones = {};
 phmap::parallel_flat_hash_map<uint32_t, std::shared_ptr<Zone>> Zone::zonesByID = {};
 const static std::shared_ptr<Zone> nullZone = nullptr;
 
+Zone::~Zone() {
+	for (const auto &position : positions) {
+		unindexPosition(position);
+	}
+}
+
 std::shared_ptr<Zone> Zone::addZone(const std::string &name, uint32_t zoneID /* = 0 */) {
 	if (name == "default") {
 		g_logger().error("Zone name {} is reserved", name);
@@ -62,6 +71,39 @@ bool Zone::contains(const Position &pos) const {
 	return positions.contains(pos);
 }
 
+uint64_t Zone::getSectorKey(const Position &position) {
+	return static_cast<uint64_t>(position.x / SECTOR_SIZE) | static_cast<uint64_t>(position.y / SECTOR_SIZE) << 16 | static_cast<uint64_t>(position.z) << 32;
+}
+
+void Zone::indexPosition(const Position &position) {
+	auto &sectorZones = zonesBySector[getSectorKey(position)];
+	const auto it = std::ranges::find(sectorZones, this, &SectorZone::zone);
+	if (it != sectorZones.end()) {
+		++it->positions;
+	} else {
+		sectorZones.push_back({ this, 1 });
+	}
+}
+
+void Zone::unindexPosition(const Position &position) {
+	const auto sectorIt = zonesBySector.find(getSectorKey(position));
+	if (sectorIt == zonesBySector.end()) {
+		return;
+	}
+
+	auto &sectorZones = sectorIt->second;
+	const auto it = std::ranges::find(sectorZones, this, &SectorZone::zone);
+	if (it == sectorZones.end() || --it->positions != 0) {
+		return;
+	}
+
+	*it = sectorZones.back();
+	sectorZones.pop_back();
+	if (sectorZones.empty()) {
+		zonesBySector.erase(sectorIt);
+	}
+}
+
 Position Zone::getRemoveDestination(const std::shared_ptr<Creature> &creature /* = nullptr */) const {
 	if (!creature || !creature->getPlayer()) {
 		return Position();
@@ -76,15 +118,16 @@ Position Zone::getRemoveDestination(const std::shared_ptr<Creature> &creature /*
 }
 
 std::shared_ptr<Zone> Zone::getZone(const std::string &name) {
-	return zones[name];
+	const auto it = zones.find(name);
+	return it != zones.end() ? it->second : nullZone;
 }
 
 std::shared_ptr<Zone> Zone::getZone(uint32_t zoneID) {
 	if (zoneID == 0) {
 		return nullZone;
 	}
-	if (zonesByID.contains(zoneID)) {
-		return zonesByID[zoneID];
+	if (const auto it = zonesByID.find(zoneID); it != zonesByID.end()) {
+		return it->second;
 	}
 	auto zone = std::make_shared<Zone>(zoneID);
 	zonesByID[zoneID] = zone;
@@ -158,9 +201,19 @@ void Zone::clearZones() {
 std::vector<std::shared_ptr<Zone>> Zone::getZones(const Position position) {
 	Benchmark bm_getZones;
 	std::vector<std::shared_ptr<Zone>> result;
-	for (const auto &[_, zone] : zones) {
-		if (zone && zone->contains(position)) {
-			result.push_back(zone);
+	const auto sectorIt = zonesBySector.find(getSectorKey(position));
+	if (sectorIt == zonesBySector.end()) {
+		return result;
+	}
+
+	for (const auto &[zone, _] : sectorIt->second) {
+		if (!zone->contains(position)) {
+			continue;
+		}
+		// Only zones registered by name are listed, the same as before the index existed
+		const auto it = zones.find(zone->name);
+		if (it != zones.end() && it->second.get() == zone) {
+			result.push_back(it->second);
 		}
 	}
 	auto duration = bm_getZones.duration();
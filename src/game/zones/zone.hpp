@@ -147,6 +147,7 @@ public:
 		name(std::move(name)), id(id) { }
 	explicit Zone(uint32_t id) :
 		id(id) { }
+	~Zone();
 
 	// Deleted copy constructor and assignment operator.
 	Zone(const Zone &) = delete;
@@ -158,10 +159,14 @@ public:
 	void addArea(Area area);
 	void subtractArea(Area area);
 	void addPosition(const Position &position) {
-		positions.emplace(position);
+		if (positions.emplace(position).second) {
+			indexPosition(position);
+		}
 	}
 	void removePosition(const Position &position) {
-		positions.erase(position);
+		if (positions.erase(position) != 0) {
+			unindexPosition(position);
+		}
 	}
 	Position getRemoveDestination(const std::shared_ptr<Creature> &creature = nullptr) const;
 	void setRemoveDestination(const Position &position) {
@@ -213,6 +218,16 @@ public:
 protected:
 	bool contains(const Position &position) const;
 
+	// Sector bucket entry: a zone and how many of its positions fall in that sector
+	struct SectorZone {
+		Zone* zone;
+		uint32_t positions;
+	};
+
+	static uint64_t getSectorKey(const Position &position);
+	void indexPosition(const Position &position);
+	void unindexPosition(const Position &position);
+
 	Position removeDestination = Position();
 	std::string name;
 	std::string monsterVariant;
@@ -225,6 +240,8 @@ protected:
 	weak::set<Npc> npcsCache;
 	weak::set<Player> playersCache;
 
+	// Zones with positions in each map sector, so getZones(position) only checks the zones near it
+	static phmap::flat_hash_map<uint64_t, std::vector<SectorZone>> zonesBySector;
 	static phmap::parallel_flat_hash_map<std::string, std::shared_ptr<Zone>> zones;
 	static phmap::parallel_flat_hash_map<uint32_t, std::shared_ptr<Zone>> zonesByID;
 };
@@ -11,6 +11,15 @@
 
 #include "io/fileloader.hpp"
 
+FileStream FileStream::slice(uint32_t begin, uint32_t end) const {
+	if (begin > end || end > m_data.size()) {
+		g_logger().error("Slice failed");
+		return { {}, 1 };
+	}
+
+	return { m_data.subspan(begin, end - begin), 1 };
+}
+
 uint32_t FileStream::tell() const {
 	return m_pos;
 }
@@ -58,7 +67,7 @@ bool FileStream::read(T &ret, bool escape) {
 			++m_pos;
 		}
 	} else {
-		std::span<const uint8_t> sourceSpan(m_data.data() + m_pos, size);
+		const auto sourceSpan = m_data.subspan(m_pos, size);
 		std::ranges::copy(sourceSpan, array.begin());
 		m_pos += size;
 	}
@@ -112,7 +121,7 @@ std::string FileStream::getString() {
 			return {};
 		}
 
-		str = { (char*)&m_data[m_pos], len };
+		str = { reinterpret_cast<const char*>(m_data.data() + m_pos), len };
 		m_pos += len;
 	} else if (len != 0) {
 		g_logger().error("[FileStream::getString] - Read failed because string is too big");
@@ -159,3 +168,24 @@ bool FileStream::endNode() {
 	back();
 	return false;
 }
+
+bool FileStream::skipNode() {
+	uint32_t depth = 0;
+	while (m_pos < m_data.size()) {
+		const uint8_t byte = m_data[m_pos++];
+		if (byte == OTB::Node::ESCAPE) {
+			++m_pos;
+		} else if (byte == OTB::Node::START) {
+			++depth;
+		} else if (byte == OTB::Node::END) {
+			if (depth == 0) {
+				--m_nodes;
+				return true;
+			}
+			--depth;
+		}
+	}
+
+	g_logger().error("Skip node failed");
+	return false;
+}
@@ -11,13 +11,22 @@
 
 class FileStream {
 public:
-	FileStream(const char* begin, const char* end) {
-		m_data.insert(m_data.end(), begin, end);
-	}
-
-	explicit FileStream(mio::mmap_source source) {
-		m_data.insert(m_data.end(), source.begin(), source.end());
-	}
+	/**
+	 * Reads directly from [begin, end) without copying it.
+	 * The caller must keep the underlying buffer alive while the stream is used.
+	 */
+	FileStream(const char* begin, const char* end) :
+		m_data(reinterpret_cast<const uint8_t*>(begin), static_cast<size_t>(end - begin)) { }
+
+	explicit FileStream(mio::mmap_source source) :
+		m_source(std::move(source)),
+		m_data(reinterpret_cast<const uint8_t*>(m_source.data()), m_source.size()) { }
+
+	/**
+	 * Creates a stream over [begin, end) of this stream, sharing the same bytes.
+	 * The returned stream starts inside a node, so escaped bytes are honoured.
+	 */
+	FileStream slice(uint32_t begin, uint32_t end) const;
 
 	void back(uint32_t pos = 1);
 	void seek(uint32_t pos);
@@ -27,6 +36,11 @@ public:
 
 	bool startNode(uint8_t type = 0);
 	bool endNode();
+	/**
+	 * Skips the remainder of the current node, including its children,
+	 * and consumes its end marker.
+	 */
+	bool skipNode();
 	bool isProp(uint8_t prop, bool toNext = true);
 
 	uint8_t getU8();
@@ -36,10 +50,14 @@ public:
 	std::string getString();
 
 private:
+	FileStream(std::span<const uint8_t> data, uint32_t nodes) :
+		m_nodes(nodes), m_data(data) { }
+
 	template <typename T>
 	bool read(T &ret, bool escape = false);
 	uint32_t m_nodes { 0 };
 	uint32_t m_pos { 0 };
 
-	std::vector<uint8_t> m_data;
+	mio::mmap_source m_source;
+	std::span<const uint8_t> m_data;
 };
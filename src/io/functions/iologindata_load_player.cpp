@@ -32,13 +32,18 @@
 
 void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, const DBResult_ptr &result, const std::shared_ptr<Player> &player) {
 	try {
+		const auto sidColumn = result->getColumn("sid");
+		const auto pidColumn = result->getColumn("pid");
+		const auto typeColumn = result->getColumn("itemtype");
+		const auto countColumn = result->getColumn("count");
+		const auto attributesColumn = result->getColumn("attributes");
 		do {
-			auto sid = result->getNumber<uint32_t>("sid");
-			auto pid = result->getNumber<uint32_t>("pid");
-			auto type = result->getNumber<uint16_t>("itemtype");
-			auto count = result->getNumber<uint16_t>("count");
+			auto sid = result->getNumber<uint32_t>(sidColumn);
+			auto pid = result->getNumber<uint32_t>(pidColumn);
+			auto type = result->getNumber<uint16_t>(typeColumn);
+			auto count = result->getNumber<uint16_t>(countColumn);
 			unsigned long attrSize;
-			const char* attr = result->getStream("attributes", attrSize);
+			const char* attr = result->getStream(attributesColumn, attrSize);
 			PropStream propStream;
 			propStream.init(attr, attrSize);
 
@@ -547,8 +552,6 @@ void IOLoginDataLoad::loadPlayerInventoryItems(const std::shared_ptr<Player> &pl
 	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_items WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
 
 	ItemsMap inventoryItems;
-	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
-	std::vector<std::shared_ptr<Item>> imbuedItemsToStartDecay;
 
 	try {
 		if (!(result = g_database().storeQuery(query))) {
@@ -567,10 +570,6 @@ void IOLoginDataLoad::loadPlayerInventoryItems(const std::shared_ptr<Player> &pl
 			int32_t pid = pair.second;
 			if (pid >= CONST_SLOT_FIRST && pid <= CONST_SLOT_LAST) {
 				player->internalAddThing(pid, item);
-				item->startDecaying();
-				if (item->hasImbuements()) {
-					(void)imbuedItemsToStartDecay.emplace_back(item);
-				}
 			} else {
 				ItemsMap::const_iterator it2 = inventoryItems.find(pid);
 				if (it2 == inventoryItems.end()) {
@@ -583,47 +582,8 @@ void IOLoginDataLoad::loadPlayerInventoryItems(const std::shared_ptr<Player> &pl
 				}
 
 				container->internalAddThing(item);
-				// Here, the sub-containers do not yet have a parent, since the main backpack has not yet been added to the player, so we need to postpone
-				(void)itemsToStartDecaying.emplace_back(item);
-				if (item->hasImbuements()) {
-					(void)imbuedItemsToStartDecay.emplace_back(item);
-				}
-			}
-
-			const std::shared_ptr<Container> &itemContainer = item->getContainer();
-			if (!itemContainer) {
-				continue;
-			}
-
-			if (itemContainer.get() != item.get() && itemContainer->hasImbuements()) {
-				(void)imbuedItemsToStartDecay.emplace_back(itemContainer);
-			}
-
-			for (const bool isLootContainer : { true, false }) {
-				const auto checkAttribute = isLootContainer ? ItemAttribute_t::QUICKLOOTCONTAINER : ItemAttribute_t::OBTAINCONTAINER;
-				if (!item->hasAttribute(checkAttribute)) {
-					continue;
-				}
-
-				const auto flags = item->getAttribute<uint32_t>(checkAttribute);
-				for (uint8_t category = OBJECTCATEGORY_FIRST; category <= OBJECTCATEGORY_LAST; category++) {
-					if (hasBitSet(1 << category, flags)) {
-						player->refreshManagedContainer(static_cast<ObjectCategory_t>(category), itemContainer, isLootContainer, true);
-					}
-				}
 			}
 		}
-
-		// Now that all items and containers have been added and parent chain is established, start decay
-		for (const auto &item : itemsToStartDecaying) {
-			item->startDecaying();
-		}
-
-		// Start imbuement decay on login for imbued items
-		for (const auto &item : imbuedItemsToStartDecay) {
-			g_imbuementDecay().startImbuementDecay(item);
-		}
-
 	} catch (const std::exception &e) {
 		g_logger().error("[IOLoginDataLoad::loadPlayerInventoryItems] - Exception during inventory loading: {}", e.what());
 	}
@@ -665,7 +625,6 @@ void IOLoginDataLoad::loadPlayerDepotItems(const std::shared_ptr<Player> &player
 	}
 
 	ItemsMap depotItems;
-	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
 	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_depotitems WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
 	if ((result = g_database().storeQuery(query))) {
 		loadItems(depotItems, result, player);
@@ -681,7 +640,6 @@ void IOLoginDataLoad::loadPlayerDepotItems(const std::shared_ptr<Player> &player
 				const std::shared_ptr<DepotChest> &depotChest = player->getDepotChest(pid, true);
 				if (depotChest) {
 					depotChest->internalAddThing(item);
-					item->startDecaying();
 				}
 			} else {
 				auto depotIt = depotItems.find(pid);
@@ -692,17 +650,10 @@ void IOLoginDataLoad::loadPlayerDepotItems(const std::shared_ptr<Player> &player
 				const std::shared_ptr<Container> &container = depotIt->second.first->getContainer();
 				if (container) {
 					container->internalAddThing(item);
-					// Here, the sub-containers do not yet have a parent, since the main backpack has not yet been added to the player, so we need to postpone
-					(void)itemsToStartDecaying.emplace_back(item);
 				}
 			}
 		}
 	}
-
-	// Now that all items and containers have been added and parent chain is established, start decay
-	for (const auto &item : itemsToStartDecaying) {
-		item->startDecaying();
-	}
 }
 
 void IOLoginDataLoad::loadPlayerInboxItems(const std::shared_ptr<Player> &player, DBResult_ptr result) {
@@ -711,7 +662,6 @@ void IOLoginDataLoad::loadPlayerInboxItems(const std::shared_ptr<Player> &player
 		return;
 	}
 
-	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
 	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_inboxitems WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
 	if ((result = g_database().storeQuery(query))) {
 		ItemsMap inboxItems;
@@ -733,7 +683,6 @@ void IOLoginDataLoad::loadPlayerInboxItems(const std::shared_ptr<Player> &player
 			int32_t pid = pair.second;
 			if (pid >= 0 && pid < 100) {
 				playerInbox->internalAddThing(item);
-				item->startDecaying();
 			} else {
 				auto inboxIt = inboxItems.find(pid);
 				if (inboxIt == inboxItems.end()) {
@@ -743,16 +692,71 @@ void IOLoginDataLoad::loadPlayerInboxItems(const std::shared_ptr<Player> &player
 				const std::shared_ptr<Container> &container = inboxIt->second.first->getContainer();
 				if (container) {
 					container->internalAddThing(item);
-					(void)itemsToStartDecaying.emplace_back(item);
 				}
 			}
 		}
 	}
+}
+
+void IOLoginDataLoad::loadPlayerItemsDecay(const std::shared_ptr<Player> &player) {
+	if (!player) {
+		g_logger().warn("[{}] - Player nullptr", __FUNCTION__);
+		return;
+	}
+
+	// Every item inside the container, at any depth
+	const auto forEachItemIn = [](const std::shared_ptr<Container> &container, const std::function<void(const std::shared_ptr<Item> &)> &f) {
+		if (!container) {
+			return;
+		}
+		for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
+			f(*it);
+		}
+	};
+
+	const auto startInventoryItem = [&player](const std::shared_ptr<Item> &item) {
+		item->startDecaying();
+		if (item->hasImbuements()) {
+			g_imbuementDecay().startImbuementDecay(item);
+		}
+
+		const auto &itemContainer = item->getContainer();
+		if (!itemContainer) {
+			return;
+		}
+
+		for (const bool isLootContainer : { true, false }) {
+			const auto checkAttribute = isLootContainer ? ItemAttribute_t::QUICKLOOTCONTAINER : ItemAttribute_t::OBTAINCONTAINER;
+			if (!item->hasAttribute(checkAttribute)) {
+				continue;
+			}
+
+			const auto flags = item->getAttribute<uint32_t>(checkAttribute);
+			for (uint8_t category = OBJECTCATEGORY_FIRST; category <= OBJECTCATEGORY_LAST; category++) {
+				if (hasBitSet(1 << category, flags)) {
+					player->refreshManagedContainer(static_cast<ObjectCategory_t>(category), itemContainer, isLootContainer, true);
+				}
+			}
+		}
+	};
+
+	// Every container holds its items by now, so decay starts with the whole parent chain in place
+	for (int32_t slot = CONST_SLOT_FIRST; slot <= CONST_SLOT_LAST; ++slot) {
+		const auto &item = player->inventory[slot];
+		if (!item) {
+			continue;
+		}
+		startInventoryItem(item);
+		forEachItemIn(item->getContainer(), startInventoryItem);
+	}
 
-	// Now that all items and containers have been added and parent chain is established, start decay
-	for (const auto &item : itemsToStartDecaying) {
+	const auto startDecaying = [](const std::shared_ptr<Item> &item) {
 		item->startDecaying();
+	};
+	for (const auto &[depotId, depotChest] : player->depotChests) {
+		forEachItemIn(depotChest, startDecaying);
 	}
+	forEachItemIn(player->getInbox(), startDecaying);
 }
 
 void IOLoginDataLoad::loadPlayerStorageMap(const std::shared_ptr<Player> &player) {
@@ -36,6 +36,8 @@ public:
 	static void loadPlayerDepotItems(const std::shared_ptr<Player> &player, DBResult_ptr result);
 	static void loadRewardItems(const std::shared_ptr<Player> &player);
 	static void loadPlayerInboxItems(const std::shared_ptr<Player> &player, DBResult_ptr result);
+	// Starts the decay of the items loaded by the item functions above, on the dispatcher
+	static void loadPlayerItemsDecay(const std::shared_ptr<Player> &player);
 	static void loadPlayerStorageMap(const std::shared_ptr<Player> &player);
 	static void loadPlayerVip(const std::shared_ptr<Player> &player, DBResult_ptr result);
 	static void loadPlayerPreyClass(const std::shared_ptr<Player> &player, DBResult_ptr result);
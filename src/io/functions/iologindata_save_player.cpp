@@ -21,59 +21,47 @@
 #include "items/containers/rewards/reward.hpp"
 #include "creatures/players/player.hpp"
 #include "io/player_storage_repository.hpp"
+#include "utils/hash.hpp"
 
-bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &propWriteStream) {
+namespace {
+	size_t fingerprintRows(const std::vector<std::string> &rows) {
+		size_t fingerprint = rows.size();
+		for (const auto &row : rows) {
+			stdext::hash_union(fingerprint, std::hash<std::string> {}(row));
+		}
+		return fingerprint;
+	}
+}
+
+std::vector<IOLoginDataSave::ItemRowData> IOLoginDataSave::serializeItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, PropWriteStream &propWriteStream) {
+	std::vector<ItemRowData> rows;
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
+		return rows;
 	}
 
 	const Database &db = Database::getInstance();
-	std::ostringstream ss;
 
 	// Initialize variables
 	using ContainerBlock = std::pair<std::shared_ptr<Container>, int32_t>;
 	std::list<ContainerBlock> queue;
 	int32_t runningId = 100;
 
-	// Loop through each item in itemList
 	const auto &openContainers = player->getOpenContainers();
-	for (const auto &it : itemList) {
-		const auto &item = it.second;
-		if (!item) {
-			continue;
+	const auto updateOpenContainer = [&openContainers](const std::shared_ptr<Container> &container) {
+		if (container->getAttribute<int64_t>(ItemAttribute_t::OPENCONTAINER) > 0) {
+			container->setAttribute(ItemAttribute_t::OPENCONTAINER, 0);
 		}
 
-		int32_t pid = it.first;
-
-		++runningId;
-
-		// Update container attributes if necessary
-		if (const std::shared_ptr<Container> &container = item->getContainer()) {
-			if (!container) {
-				continue;
-			}
-
-			if (container->getAttribute<int64_t>(ItemAttribute_t::OPENCONTAINER) > 0) {
-				container->setAttribute(ItemAttribute_t::OPENCONTAINER, 0);
-			}
-
-			if (!openContainers.empty()) {
-				for (const auto &its : openContainers) {
-					auto openContainer = its.second;
-					auto opcontainer = openContainer.container;
-
-					if (opcontainer == container) {
-						container->setAttribute(ItemAttribute_t::OPENCONTAINER, ((int)its.first) + 1);
-						break;
-					}
-				}
+		for (const auto &[cid, openContainer] : openContainers) {
+			if (openContainer.container == container) {
+				container->setAttribute(ItemAttribute_t::OPENCONTAINER, cid + 1);
+				break;
 			}
-
-			// Add container to queue
-			queue.emplace_back(container, runningId);
 		}
+	};
 
+	const auto addRow = [&](const std::shared_ptr<Item> &item, int32_t pid) {
 		// Serialize item attributes
 		propWriteStream.clear();
 		item->serializeAttr(propWriteStream);
@@ -81,26 +69,35 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 		size_t attributesSize;
 		const char* attributes = propWriteStream.getStream(attributesSize);
 
-		// Build query string and add row
-		ss << player->getGUID() << ',' << pid << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-		if (!query_insert.addRow(ss)) {
-			g_logger().error("Error adding row to query.");
-			return false;
+		rows.push_back({ pid, runningId, fmt::format("{},{},{},{},{},{}", player->getGUID(), pid, runningId, item->getID(), item->getSubType(), db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize))) });
+	};
+
+	// Loop through each item in itemList
+	for (const auto &[pid, item] : itemList) {
+		if (!item) {
+			continue;
+		}
+
+		++runningId;
+
+		// Update container attributes if necessary
+		if (const std::shared_ptr<Container> &container = item->getContainer()) {
+			updateOpenContainer(container);
+			// Add container to queue
+			queue.emplace_back(container, runningId);
 		}
+
+		addRow(item, pid);
 	}
 
 	// Loop through containers in queue
 	while (!queue.empty()) {
-		const ContainerBlock &cb = queue.front();
-		const std::shared_ptr<Container> &container = cb.first;
-		if (!container) {
-			continue;
-		}
-
-		int32_t parentId = cb.second;
+		const auto [container, parentId] = queue.front();
+		// Removes the object before processing, the children are queued behind it
+		queue.pop_front();
 
 		// Loop through items in container
-		for (auto &item : container->getItemList()) {
+		for (const auto &item : container->getItemList()) {
 			if (!item) {
 				continue;
 			}
@@ -108,51 +105,99 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 			++runningId;
 
 			// Update sub-container attributes if necessary
-			const auto &subContainer = item->getContainer();
-			if (subContainer) {
+			if (const auto &subContainer = item->getContainer()) {
 				queue.emplace_back(subContainer, runningId);
-				if (subContainer->getAttribute<int64_t>(ItemAttribute_t::OPENCONTAINER) > 0) {
-					subContainer->setAttribute(ItemAttribute_t::OPENCONTAINER, 0);
-				}
-
-				if (!openContainers.empty()) {
-					for (const auto &it : openContainers) {
-						auto openContainer = it.second;
-						auto opcontainer = openContainer.container;
-
-						if (opcontainer == subContainer) {
-							subContainer->setAttribute(ItemAttribute_t::OPENCONTAINER, (it.first) + 1);
-							break;
-						}
-					}
-				}
+				updateOpenContainer(subContainer);
 			}
 
-			// Serialize item attributes
-			propWriteStream.clear();
-			item->serializeAttr(propWriteStream);
+			addRow(item, parentId);
+		}
+	}
 
-			size_t attributesSize;
-			const char* attributes = propWriteStream.getStream(attributesSize);
+	return rows;
+}
 
-			// Build query string and add row
-			ss << player->getGUID() << ',' << parentId << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-			if (!query_insert.addRow(ss)) {
-				g_logger().error("Error adding row to query for container item.");
-				return false;
+bool IOLoginDataSave::saveItemRows(const std::shared_ptr<Player> &player, PlayerSaveSection section, std::string_view table, const std::vector<ItemRowData> &rows) {
+	auto &saveState = player->saveState();
+	const auto* savedRows = saveState.getCommittedItemRows(section);
+
+	PlayerSaveState::ItemRows newRows;
+	newRows.reserve(rows.size());
+	size_t fingerprint = rows.size();
+	std::vector<const ItemRowData*> changedRows;
+	for (const auto &row : rows) {
+		const auto hash = std::hash<std::string> {}(row.values);
+		stdext::hash_union(fingerprint, hash);
+		newRows.try_emplace(row.sid, PlayerSaveState::ItemRow { row.pid, hash });
+
+		if (savedRows) {
+			const auto it = savedRows->find(row.sid);
+			if (it == savedRows->end() || it->second.hash != hash) {
+				changedRows.emplace_back(&row);
 			}
 		}
+	}
 
-		// Removes the object after processing everything, avoiding memory usage after freeing
-		queue.pop_front();
+	// Rows that are gone, or moved to another parent (part of the player_items key), are deleted first
+	std::vector<int32_t> deletedSids;
+	if (savedRows) {
+		for (const auto &[sid, savedRow] : *savedRows) {
+			const auto it = newRows.find(sid);
+			if (it == newRows.end() || it->second.pid != savedRow.pid) {
+				deletedSids.emplace_back(sid);
+			}
+		}
+	}
+
+	if (!saveState.stage(section, fingerprint, std::move(newRows))) {
+		return true;
+	}
+
+	const auto insertQuery = fmt::format("INSERT INTO `{}` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", table);
+	if (!savedRows) {
+		std::vector<std::string> values;
+		values.reserve(rows.size());
+		for (const auto &row : rows) {
+			values.emplace_back(row.values);
+		}
+		return replaceRows(player, table, insertQuery, values);
+	}
+
+	g_logger().trace("[{}] - Player {} {}: {} changed and {} deleted of {} rows", __FUNCTION__, player->getName(), table, changedRows.size(), deletedSids.size(), rows.size());
+
+	if (!deletedSids.empty()) {
+		const auto query = fmt::format("DELETE FROM `{}` WHERE `player_id` = {} AND `sid` IN ({})", table, player->getGUID(), fmt::join(deletedSids, ","));
+		if (!Database::getInstance().executeQuery(query)) {
+			return false;
+		}
+	}
+
+	DBInsert upsertQuery(insertQuery);
+	upsertQuery.upsert({ "pid", "itemtype", "count", "attributes" });
+	for (const auto* row : changedRows) {
+		if (!upsertQuery.addRow(row->values)) {
+			g_logger().error("Error adding row to query.");
+			return false;
+		}
 	}
+	return upsertQuery.execute();
+}
 
-	// Execute query
-	if (!query_insert.execute()) {
-		g_logger().error("Error executing query.");
+bool IOLoginDataSave::replaceRows(const std::shared_ptr<Player> &player, std::string_view table, const std::string &insertQuery, const std::vector<std::string> &rows) {
+	const auto query = fmt::format("DELETE FROM `{}` WHERE `player_id` = {}", table, player->getGUID());
+	if (!Database::getInstance().executeQuery(query)) {
+		g_logger().warn("[IOLoginData::savePlayer] - Error delete query '{}' from player: {}", table, player->getName());
 		return false;
 	}
-	return true;
+
+	DBInsert insert(insertQuery);
+	for (const auto &row : rows) {
+		if (!insert.addRow(row)) {
+			g_logger().error("Error adding row to query.");
+			return false;
+		}
+	}
+	return insert.execute();
 }
 
 bool IOLoginDataSave::savePlayerFirst(const std::shared_ptr<Player> &player) {
@@ -337,16 +382,12 @@ bool IOLoginDataSave::savePlayerStash(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
+	auto &saveState = player->saveState();
+	if (saveState.isClean(PlayerSaveSection::Stash)) {
+		return true;
 	}
 
-	query.str("");
-
-	DBInsert stashQuery("INSERT INTO `player_stash` (`player_id`,`item_id`,`item_count`) VALUES ");
+	std::vector<std::string> rows;
 	for (const auto &[itemId, itemCount] : player->getStashItems()) {
 		const ItemType &itemType = Item::items[itemId];
 		if (itemType.decayTo >= 0 && itemType.decayTime > 0) {
@@ -359,16 +400,13 @@ bool IOLoginDataSave::savePlayerStash(const std::shared_ptr<Player> &player) {
 			continue;
 		}
 
-		query << player->getGUID() << ',' << itemId << ',' << itemCount;
-		if (!stashQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(fmt::format("{},{},{}", player->getGUID(), itemId, itemCount));
 	}
 
-	if (!stashQuery.execute()) {
-		return false;
+	if (!saveState.stage(PlayerSaveSection::Stash, fingerprintRows(rows))) {
+		return true;
 	}
-	return true;
+	return replaceRows(player, "player_stash", "INSERT INTO `player_stash` (`player_id`,`item_id`,`item_count`) VALUES ", rows);
 }
 
 bool IOLoginDataSave::savePlayerSpells(const std::shared_ptr<Player> &player) {
@@ -377,27 +415,21 @@ bool IOLoginDataSave::savePlayerSpells(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
+	auto &saveState = player->saveState();
+	if (saveState.isClean(PlayerSaveSection::Spells)) {
+		return true;
 	}
 
-	query.str("");
-
-	DBInsert spellsQuery("INSERT INTO `player_spells` (`player_id`, `name` ) VALUES ");
+	const Database &db = Database::getInstance();
+	std::vector<std::string> rows;
 	for (const std::string &spellName : player->learnedInstantSpellList) {
-		query << player->getGUID() << ',' << db.escapeString(spellName);
-		if (!spellsQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(fmt::format("{},{}", player->getGUID(), db.escapeString(spellName)));
 	}
 
-	if (!spellsQuery.execute()) {
-		return false;
+	if (!saveState.stage(PlayerSaveSection::Spells, fingerprintRows(rows))) {
+		return true;
 	}
-	return true;
+	return replaceRows(player, "player_spells", "INSERT INTO `player_spells` (`player_id`, `name` ) VALUES ", rows);
 }
 
 bool IOLoginDataSave::savePlayerKills(const std::shared_ptr<Player> &player) {
@@ -406,27 +438,15 @@ bool IOLoginDataSave::savePlayerKills(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-
-	DBInsert killsQuery("INSERT INTO `player_kills` (`player_id`, `target`, `time`, `unavenged`) VALUES");
+	std::vector<std::string> rows;
 	for (const auto &kill : player->unjustifiedKills) {
-		query << player->getGUID() << ',' << kill.target << ',' << kill.time << ',' << kill.unavenged;
-		if (!killsQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(fmt::format("{},{},{},{}", player->getGUID(), kill.target, kill.time, kill.unavenged ? 1 : 0));
 	}
 
-	if (!killsQuery.execute()) {
-		return false;
+	if (!player->saveState().stage(PlayerSaveSection::Kills, fingerprintRows(rows))) {
+		return true;
 	}
-	return true;
+	return replaceRows(player, "player_kills", "INSERT INTO `player_kills` (`player_id`, `target`, `time`, `unavenged`) VALUES", rows);
 }
 
 bool IOLoginDataSave::savePlayerBestiarySystem(const std::shared_ptr<Player> &player) {
@@ -467,7 +487,12 @@ bool IOLoginDataSave::savePlayerBestiarySystem(const std::shared_ptr<Player> &pl
 	query << " `tracker list` = " << db.escapeBlob(trackerList, static_cast<uint32_t>(trackerSize));
 	query << " WHERE `player_id` = " << player->getGUID();
 
-	if (!db.executeQuery(query.str())) {
+	const auto queryString = query.str();
+	if (!player->saveState().stage(PlayerSaveSection::Bestiary, std::hash<std::string> {}(queryString))) {
+		return true;
+	}
+
+	if (!db.executeQuery(queryString)) {
 		g_logger().warn("[IOLoginData::savePlayer] - Error saving bestiary data from player: {}", player->getName());
 		return false;
 	}
@@ -480,17 +505,7 @@ bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
 	PropWriteStream propWriteStream;
-	std::ostringstream query;
-	query << "DELETE FROM `player_items` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error delete query 'player_items' from player: {}", player->getName());
-		return false;
-	}
-
-	DBInsert itemsQuery("INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	ItemBlockList itemList;
 	for (int32_t slotId = CONST_SLOT_FIRST; slotId <= CONST_SLOT_LAST; ++slotId) {
 		const auto &item = player->inventory[slotId];
@@ -499,7 +514,7 @@ bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player) {
 		}
 	}
 
-	if (!saveItems(player, itemList, itemsQuery, propWriteStream)) {
+	if (!saveItemRows(player, PlayerSaveSection::Inventory, "player_items", serializeItems(player, itemList, propWriteStream))) {
 		g_logger().warn("[IOLoginData::savePlayer] - Failed for save items from player: {}", player->getName());
 		return false;
 	}
@@ -512,33 +527,19 @@ bool IOLoginDataSave::savePlayerDepotItems(const std::shared_ptr<Player> &player
 		return false;
 	}
 
-	Database &db = Database::getInstance();
+	if (player->lastDepotId == -1) {
+		return true;
+	}
+
 	PropWriteStream propWriteStream;
 	ItemDepotList depotList;
-	if (player->lastDepotId != -1) {
-		std::ostringstream query;
-		query << "DELETE FROM `player_depotitems` WHERE `player_id` = " << player->getGUID();
-
-		if (!db.executeQuery(query.str())) {
-			return false;
+	for (const auto &[pid, depotChest] : player->depotChests) {
+		for (const std::shared_ptr<Item> &item : depotChest->getItemList()) {
+			depotList.emplace_back(pid, item);
 		}
-
-		query.str("");
-
-		DBInsert depotQuery("INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
-		for (const auto &[pid, depotChest] : player->depotChests) {
-			for (const std::shared_ptr<Item> &item : depotChest->getItemList()) {
-				depotList.emplace_back(pid, item);
-			}
-		}
-
-		if (!saveItems(player, depotList, depotQuery, propWriteStream)) {
-			return false;
-		}
-		return true;
 	}
-	return true;
+
+	return saveItemRows(player, PlayerSaveSection::Depot, "player_depotitems", serializeItems(player, depotList, propWriteStream));
 }
 
 bool IOLoginDataSave::saveRewardItems(const std::shared_ptr<Player> &player) {
@@ -547,32 +548,19 @@ bool IOLoginDataSave::saveRewardItems(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	std::ostringstream query;
-	query << "DELETE FROM `player_rewards` WHERE `player_id` = " << player->getGUID();
-
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
 	std::vector<uint64_t> rewardList;
 	player->getRewardList(rewardList);
 
 	ItemRewardList rewardListItems;
-	if (!rewardList.empty()) {
-		for (const auto &rewardId : rewardList) {
-			auto reward = player->getReward(rewardId, false);
-			if (!reward->empty() && (getTimeMsNow() - rewardId <= 1000 * 60 * 60 * 24 * 7)) {
-				rewardListItems.emplace_back(0, reward);
-			}
-		}
-
-		DBInsert rewardQuery("INSERT INTO `player_rewards` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-		PropWriteStream propWriteStream;
-		if (!saveItems(player, rewardListItems, rewardQuery, propWriteStream)) {
-			return false;
+	for (const auto &rewardId : rewardList) {
+		auto reward = player->getReward(rewardId, false);
+		if (!reward->empty() && (getTimeMsNow() - rewardId <= 1000 * 60 * 60 * 24 * 7)) {
+			rewardListItems.emplace_back(0, reward);
 		}
 	}
-	return true;
+
+	PropWriteStream propWriteStream;
+	return saveItemRows(player, PlayerSaveSection::Rewards, "player_rewards", serializeItems(player, rewardListItems, propWriteStream));
 }
 
 bool IOLoginDataSave::savePlayerInbox(const std::shared_ptr<Player> &player) {
@@ -581,26 +569,13 @@ bool IOLoginDataSave::savePlayerInbox(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
 	PropWriteStream propWriteStream;
 	ItemInboxList inboxList;
-	std::ostringstream query;
-	query << "DELETE FROM `player_inboxitems` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert inboxQuery("INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	for (const auto &item : player->getInbox()->getItemList()) {
 		inboxList.emplace_back(0, item);
 	}
 
-	if (!saveItems(player, inboxList, inboxQuery, propWriteStream)) {
-		return false;
-	}
-	return true;
+	return saveItemRows(player, PlayerSaveSection::Inbox, "player_inboxitems", serializeItems(player, inboxList, propWriteStream));
 }
 
 bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player) {
@@ -612,6 +587,7 @@ bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player)
 	Database &db = Database::getInstance();
 	if (g_configManager().getBoolean(PREY_ENABLED)) {
 		std::ostringstream query;
+		std::vector<std::string> queries;
 		for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
 			if (const auto &slot = player->getPreySlotById(static_cast<PreySlot_t>(slotId))) {
 				query.str(std::string());
@@ -647,10 +623,18 @@ bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player)
 					  << "`free_reroll` = VALUES(`free_reroll`), "
 					  << "`monster_list` = VALUES(`monster_list`)";
 
-				if (!db.executeQuery(query.str())) {
-					g_logger().warn("[IOLoginData::savePlayer] - Error saving prey slot data from player: {}", player->getName());
-					return false;
-				}
+				queries.emplace_back(query.str());
+			}
+		}
+
+		if (!player->saveState().stage(PlayerSaveSection::Prey, fingerprintRows(queries))) {
+			return true;
+		}
+
+		for (const auto &slotQuery : queries) {
+			if (!db.executeQuery(slotQuery)) {
+				g_logger().warn("[IOLoginData::savePlayer] - Error saving prey slot data from player: {}", player->getName());
+				return false;
 			}
 		}
 	}
@@ -666,6 +650,7 @@ bool IOLoginDataSave::savePlayerTaskHuntingClass(const std::shared_ptr<Player> &
 	Database &db = Database::getInstance();
 	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
 		std::ostringstream query;
+		std::vector<std::string> queries;
 		for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
 			if (const auto &slot = player->getTaskHuntingSlotById(static_cast<PreySlot_t>(slotId))) {
 				query.str("");
@@ -699,10 +684,18 @@ bool IOLoginDataSave::savePlayerTaskHuntingClass(const std::shared_ptr<Player> &
 					  << "`free_reroll` = VALUES(`free_reroll`), "
 					  << "`monster_list` = VALUES(`monster_list`)";
 
-				if (!db.executeQuery(query.str())) {
-					g_logger().warn("[IOLoginData::savePlayer] - Error saving task hunting slot data from player: {}", player->getName());
-					return false;
-				}
+				queries.emplace_back(query.str());
+			}
+		}
+
+		if (!player->saveState().stage(PlayerSaveSection::TaskHunting, fingerprintRows(queries))) {
+			return true;
+		}
+
+		for (const auto &slotQuery : queries) {
+			if (!db.executeQuery(slotQuery)) {
+				g_logger().warn("[IOLoginData::savePlayer] - Error saving task hunting slot data from player: {}", player->getName());
+				return false;
 			}
 		}
 	}
@@ -724,15 +717,6 @@ bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player)
 		return false;
 	}
 
-	std::ostringstream query;
-	query << "DELETE FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert insertQuery("INSERT INTO `player_bosstiary` (`player_id`, `bossIdSlotOne`, `bossIdSlotTwo`, `removeTimes`, `tracker`) VALUES");
-
 	// Bosstiary tracker
 	PropWriteStream stream;
 	for (const auto &monsterType : player->getCyclopediaMonsterTrackerSet(true)) {
@@ -745,21 +729,14 @@ bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player)
 	size_t size;
 	const char* chars = stream.getStream(size);
 	// Append query informations
-	query << player->getGUID() << ','
-		  << player->getSlotBossId(1) << ','
-		  << player->getSlotBossId(2) << ','
-		  << std::to_string(player->getRemoveTimes()) << ','
-		  << Database::getInstance().escapeBlob(chars, static_cast<uint32_t>(size));
+	const std::vector<std::string> rows {
+		fmt::format("{},{},{},{},{}", player->getGUID(), player->getSlotBossId(1), player->getSlotBossId(2), player->getRemoveTimes(), Database::getInstance().escapeBlob(chars, static_cast<uint32_t>(size)))
+	};
 
-	if (!insertQuery.addRow(query)) {
-		return false;
-	}
-
-	if (!insertQuery.execute()) {
-		return false;
+	if (!player->saveState().stage(PlayerSaveSection::Bosstiary, fingerprintRows(rows))) {
+		return true;
 	}
-
-	return true;
+	return replaceRows(player, "player_bosstiary", "INSERT INTO `player_bosstiary` (`player_id`, `bossIdSlotOne`, `bossIdSlotTwo`, `removeTimes`, `tracker`) VALUES", rows);
 }
 
 bool IOLoginDataSave::savePlayerStorage(const std::shared_ptr<Player> &player) {
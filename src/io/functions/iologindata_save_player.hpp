@@ -10,6 +10,7 @@
 #pragma once
 
 #include "io/iologindata.hpp"
+#include "creatures/players/components/player_save_state.hpp"
 
 class PropWriteStream;
 class DBInsert;
@@ -37,5 +38,13 @@ protected:
 	using ItemRewardList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 	using ItemInboxList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 
-	static bool saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &stream);
+	struct ItemRowData {
+		int32_t pid;
+		int32_t sid;
+		std::string values;
+	};
+
+	static std::vector<ItemRowData> serializeItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, PropWriteStream &stream);
+	static bool saveItemRows(const std::shared_ptr<Player> &player, PlayerSaveSection section, std::string_view table, const std::vector<ItemRowData> &rows);
+	static bool replaceRows(const std::shared_ptr<Player> &player, std::string_view table, const std::string &insertQuery, const std::vector<std::string> &rows);
 };
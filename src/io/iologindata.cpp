@@ -93,6 +93,23 @@ bool IOLoginData::loadPlayerByName(const std::shared_ptr<Player> &player, const
 }
 
 bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResult_ptr &result, bool disableIrrelevantInfo /* = false*/) {
+	if (!loadPlayerDetached(player, result)) {
+		return false;
+	}
+
+	try {
+		loadPlayerAttached(player, result, disableIrrelevantInfo);
+		return true;
+	} catch (const std::system_error &error) {
+		g_logger().warn("[{}] Error while load player: {}", __FUNCTION__, error.what());
+		return false;
+	} catch (const std::exception &e) {
+		g_logger().warn("[{}] Error while load player: {}", __FUNCTION__, e.what());
+		return false;
+	}
+}
+
+bool IOLoginData::loadPlayerDetached(const std::shared_ptr<Player> &player, const DBResult_ptr &result) {
 	if (!result || !player) {
 		std::string nullptrType = !result ? "Result" : "Player";
 		g_logger().warn("[{}] - {} is nullptr", __FUNCTION__, nullptrType);
@@ -130,9 +147,6 @@ bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResu
 		// kills load
 		IOLoginDataLoad::loadPlayerKills(player, result);
 
-		// guild load
-		IOLoginDataLoad::loadPlayerGuild(player, result);
-
 		// stash load items
 		IOLoginDataLoad::loadPlayerStashItems(player, result);
 
@@ -169,11 +183,6 @@ bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResu
 		// Load instant spells list
 		IOLoginDataLoad::loadPlayerInstantSpellList(player, result);
 
-		if (!disableIrrelevantInfo) {
-			// Load additional data only if the player is online (e.g., forge, bosstiary)
-			loadOnlyDataForOnlinePlayer(player, result);
-		}
-
 		return true;
 	} catch (const std::system_error &error) {
 		g_logger().warn("[{}] Error while load player: {}", __FUNCTION__, error.what());
@@ -184,6 +193,19 @@ bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResu
 	}
 }
 
+void IOLoginData::loadPlayerAttached(const std::shared_ptr<Player> &player, const DBResult_ptr &result, bool disableIrrelevantInfo) {
+	// item decay, imbuement decay and managed containers, all shared game state
+	IOLoginDataLoad::loadPlayerItemsDecay(player);
+
+	// guild load, guilds are shared between the players of the game
+	IOLoginDataLoad::loadPlayerGuild(player, result);
+
+	if (!disableIrrelevantInfo) {
+		// Load additional data only if the player is online (e.g., forge, bosstiary)
+		loadOnlyDataForOnlinePlayer(player, result);
+	}
+}
+
 void IOLoginData::loadOnlyDataForOnlinePlayer(const std::shared_ptr<Player> &player, const DBResult_ptr &result) {
 	IOLoginDataLoad::loadPlayerForgeHistory(player);
 	IOLoginDataLoad::loadPlayerBosstiary(player, result);
@@ -197,12 +219,19 @@ bool IOLoginData::savePlayer(const std::shared_ptr<Player> &player) {
 			return savePlayerGuard(player);
 		});
 
-		if (!success) {
+		// Sections skipped by the next save are compared against what this one wrote, only if it was committed
+		if (success) {
+			player->saveState().commit();
+		} else {
+			player->saveState().discard();
 			g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
 		}
 
 		return success;
 	} catch (const DatabaseException &e) {
+		if (player) {
+			player->saveState().discard();
+		}
 		g_logger().error("[{}] Exception occurred: {}", __FUNCTION__, e.what());
 	}
 
@@ -214,6 +243,9 @@ bool IOLoginData::savePlayerGuard(const std::shared_ptr<Player> &player) {
 		throw DatabaseException("Player nullptr in function: " + std::string(__FUNCTION__));
 	}
 
+	// Leftovers of a save that did not finish must not be committed by this one
+	player->saveState().discard();
+
 	if (!IOLoginDataSave::savePlayerFirst(player)) {
 		throw DatabaseException("[" + std::string(__FUNCTION__) + "] - Failed to save player first: " + player->getName());
 	}
@@ -26,6 +26,19 @@ public:
 	static bool loadPlayerByName(const std::shared_ptr<Player> &player, const std::string &name, bool disableIrrelevantInfo = true);
 	static bool loadPlayer(const std::shared_ptr<Player> &player, const std::shared_ptr<DBResult> &result, bool disableIrrelevantInfo = false);
 
+	/**
+	 * @brief Loads the parts of a player that only read the database and static game data.
+	 *
+	 * Touches no shared game state, so it may run on the thread pool for a player
+	 * not yet added to the game. Must be followed by loadPlayerAttached on the dispatcher.
+	 */
+	static bool loadPlayerDetached(const std::shared_ptr<Player> &player, const std::shared_ptr<DBResult> &result);
+
+	/**
+	 * @brief Loads the parts of a player bound to shared game state (item decay, managed containers, guilds, online-only systems), on the dispatcher.
+	 */
+	static void loadPlayerAttached(const std::shared_ptr<Player> &player, const std::shared_ptr<DBResult> &result, bool disableIrrelevantInfo);
+
 	/**
 	 * @brief Loads data components that are only relevant when the player is online.
 	 *
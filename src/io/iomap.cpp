@@ -11,6 +11,7 @@
 
 #include "game/movement/teleport.hpp"
 #include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "io/filestream.hpp"
 
 /*
@@ -66,9 +67,50 @@ void IOMap::loadMap(Map* map, const Position &pos) {
 		throw IOMapException("This map need to be upgraded by using the latest map editor version to be able to load correctly.");
 	}
 
+	double indexDuration = 0;
+	double decodeDuration = 0;
+	double mergeDuration = 0;
+	size_t areaCount = 0;
+
 	if (stream.startNode(OTBM_MAP_DATA)) {
 		parseMapDataAttributes(stream, map);
-		parseTileArea(stream, *map, pos);
+
+		Benchmark bm_index;
+		const auto &areas = indexTileAreas(stream);
+		indexDuration = bm_index.duration();
+		areaCount = areas.size();
+
+		// Areas are decoded in parallel batches and merged in file order, so the result is the same as a sequential load
+		const size_t batchSize = std::max<size_t>(1, g_threadPool().get_thread_count() * 4);
+		std::vector<std::vector<LoadedTile>> decoded;
+		std::vector<std::exception_ptr> errors;
+		for (size_t first = 0; first < areas.size(); first += batchSize) {
+			const size_t count = std::min(batchSize, areas.size() - first);
+			decoded.assign(count, {});
+			errors.assign(count, nullptr);
+
+			Benchmark bm_decode;
+			g_dispatcher().asyncWait(count, [&](size_t i) {
+				try {
+					const auto &[areaBegin, areaEnd] = areas[first + i];
+					auto areaStream = stream.slice(areaBegin, areaEnd);
+					decoded[i] = parseTileArea(areaStream, pos);
+				} catch (...) {
+					errors[i] = std::current_exception();
+				}
+			});
+			decodeDuration += bm_decode.duration();
+
+			Benchmark bm_merge;
+			for (size_t i = 0; i < count; ++i) {
+				if (errors[i]) {
+					std::rethrow_exception(errors[i]);
+				}
+				mergeTileArea(decoded[i], *map);
+			}
+			mergeDuration += bm_merge.duration();
+		}
+
 		stream.endNode();
 	}
 
@@ -77,7 +119,7 @@ void IOMap::loadMap(Map* map, const Position &pos) {
 
 	map->flush();
 
-	g_logger().debug("Map Loaded {} ({}x{}) in {} milliseconds", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration());
+	g_logger().debug("Map Loaded {} ({}x{}) in {} milliseconds (index: {} ms, decode: {} ms, merge: {} ms, {} tile areas)", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration(), indexDuration, decodeDuration, mergeDuration, areaCount);
 }
 
 void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
@@ -116,130 +158,161 @@ void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
 	}
 }
 
-void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
+std::vector<IOMap::TileAreaNode> IOMap::indexTileAreas(FileStream &stream) {
+	std::vector<TileAreaNode> areas;
 	while (stream.startNode(OTBM_TILE_AREA)) {
-		const uint16_t base_x = stream.getU16();
-		const uint16_t base_y = stream.getU16();
-		const uint8_t base_z = stream.getU8();
+		const uint32_t begin = stream.tell();
+		if (!stream.skipNode()) {
+			throw IOMapException("Could not end node.");
+		}
+		areas.emplace_back(begin, stream.tell());
+	}
+	return areas;
+}
 
-		while (stream.startNode()) {
-			const uint8_t tileType = stream.getU8();
-			if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
-				throw IOMapException("Could not read tile type node.");
-			}
+std::vector<IOMap::LoadedTile> IOMap::parseTileArea(FileStream &stream, const Position &pos) {
+	std::vector<LoadedTile> tiles;
 
-			const auto tile = std::make_shared<BasicTile>();
+	const uint16_t base_x = stream.getU16();
+	const uint16_t base_y = stream.getU16();
+	const uint8_t base_z = stream.getU8();
 
-			const uint8_t tileCoordsX = stream.getU8();
-			const uint8_t tileCoordsY = stream.getU8();
+	while (stream.startNode()) {
+		const uint8_t tileType = stream.getU8();
+		if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
+			throw IOMapException("Could not read tile type node.");
+		}
 
-			const uint16_t x = base_x + tileCoordsX + pos.x;
-			const uint16_t y = base_y + tileCoordsY + pos.y;
-			const auto z = static_cast<uint8_t>(base_z + pos.z);
+		auto &loadedTile = tiles.emplace_back();
+		const auto tile = loadedTile.tile = std::make_shared<BasicTile>();
 
-			if (tileType == OTBM_HOUSETILE) {
-				tile->houseId = stream.getU32();
-				if (!map.houses.addHouse(tile->houseId)) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", x, y, z, tile->houseId));
-				}
+		const uint8_t tileCoordsX = stream.getU8();
+		const uint8_t tileCoordsY = stream.getU8();
+
+		const uint16_t x = loadedTile.x = base_x + tileCoordsX + pos.x;
+		const uint16_t y = loadedTile.y = base_y + tileCoordsY + pos.y;
+		const auto z = loadedTile.z = static_cast<uint8_t>(base_z + pos.z);
+
+		if (tileType == OTBM_HOUSETILE) {
+			tile->houseId = stream.getU32();
+		}
+
+		if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
+			const uint32_t flags = stream.getU32();
+			if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
+				tile->flags |= TILESTATE_PROTECTIONZONE;
+			} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
+				tile->flags |= TILESTATE_NOPVPZONE;
+			} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
+				tile->flags |= TILESTATE_PVPZONE;
 			}
 
-			if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
-				const uint32_t flags = stream.getU32();
-				if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
-					tile->flags |= TILESTATE_PROTECTIONZONE;
-				} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
-					tile->flags |= TILESTATE_NOPVPZONE;
-				} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
-					tile->flags |= TILESTATE_PVPZONE;
-				}
+			if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
+				tile->flags |= TILESTATE_NOLOGOUT;
+			}
+		}
 
-				if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
-					tile->flags |= TILESTATE_NOLOGOUT;
+		if (stream.isProp(OTBM_ATTR_ITEM)) {
+			const uint16_t id = stream.getU16();
+			const auto &iType = Item::items[id];
+
+			if (!tile->isHouse() || !iType.isBed()) {
+				const auto item = std::make_shared<BasicItem>();
+				item->id = id;
+
+				if (tile->isHouse() && iType.movable) {
+					g_logger().warn("[IOMap::loadMap] - "
+					                "Movable item with ID: {}, in house: {}, "
+					                "at position: x {}, y {}, z {}",
+					                id, tile->houseId, x, y, z);
+				} else if (iType.isGroundTile()) {
+					tile->ground = item;
+				} else {
+					tile->items.emplace_back(item);
 				}
 			}
+		}
 
-			if (stream.isProp(OTBM_ATTR_ITEM)) {
-				const uint16_t id = stream.getU16();
-				const auto &iType = Item::items[id];
-
-				if (!tile->isHouse() || !iType.isBed()) {
+		while (stream.startNode()) {
+			auto type = stream.getU8();
+			switch (type) {
+				case OTBM_ITEM: {
+					const uint16_t id = stream.getU16();
+					const auto &iType = Item::items[id];
 					const auto item = std::make_shared<BasicItem>();
 					item->id = id;
 
-					if (tile->isHouse() && iType.movable) {
+					if (!item->unserializeItemNode(stream, x, y, z)) {
+						throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item {}, Node Type.", x, y, z, id));
+					}
+
+					if (tile->isHouse() && (iType.isBed() || iType.isTrashHolder())) {
+						// nothing
+					} else if (tile->isHouse() && iType.movable) {
 						g_logger().warn("[IOMap::loadMap] - "
 						                "Movable item with ID: {}, in house: {}, "
 						                "at position: x {}, y {}, z {}",
 						                id, tile->houseId, x, y, z);
 					} else if (iType.isGroundTile()) {
-						tile->ground = map.tryReplaceItemFromCache(item);
+						tile->ground = item;
 					} else {
-						tile->items.emplace_back(map.tryReplaceItemFromCache(item));
+						tile->items.emplace_back(item);
 					}
-				}
-			}
-
-			while (stream.startNode()) {
-				auto type = stream.getU8();
-				switch (type) {
-					case OTBM_ITEM: {
-						const uint16_t id = stream.getU16();
-						const auto &iType = Item::items[id];
-						const auto item = std::make_shared<BasicItem>();
-						item->id = id;
-
-						if (!item->unserializeItemNode(stream, x, y, z)) {
-							throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item {}, Node Type.", x, y, z, id));
-						}
-
-						if (tile->isHouse() && (iType.isBed() || iType.isTrashHolder())) {
-							// nothing
-						} else if (tile->isHouse() && iType.movable) {
-							g_logger().warn("[IOMap::loadMap] - "
-							                "Movable item with ID: {}, in house: {}, "
-							                "at position: x {}, y {}, z {}",
-							                id, tile->houseId, x, y, z);
-						} else if (iType.isGroundTile()) {
-							tile->ground = map.tryReplaceItemFromCache(item);
-						} else {
-							tile->items.emplace_back(map.tryReplaceItemFromCache(item));
+				} break;
+				case OTBM_TILE_ZONE: {
+					const auto zoneCount = stream.getU16();
+					for (uint16_t i = 0; i < zoneCount; ++i) {
+						const auto zoneId = stream.getU16();
+						if (!zoneId) {
+							throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Invalid zone id.", x, y, z));
 						}
-					} break;
-					case OTBM_TILE_ZONE: {
-						const auto zoneCount = stream.getU16();
-						for (uint16_t i = 0; i < zoneCount; ++i) {
-							const auto zoneId = stream.getU16();
-							if (!zoneId) {
-								throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Invalid zone id.", x, y, z));
-							}
-							auto zone = Zone::getZone(zoneId);
-							zone->addPosition(Position(x, y, z));
-						}
-					} break;
-					default:
-						throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not read item/zone node.", x, y, z));
-				}
-
-				if (!stream.endNode()) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
-				}
+						loadedTile.zoneIds.emplace_back(zoneId);
+					}
+				} break;
+				default:
+					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not read item/zone node.", x, y, z));
 			}
 
 			if (!stream.endNode()) {
 				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
 			}
+		}
 
-			if (tile->isEmpty(true)) {
-				continue;
-			}
+		if (!stream.endNode()) {
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
+		}
+	}
 
-			map.setBasicTile(x, y, z, tile);
+	if (!stream.endNode()) {
+		throw IOMapException("Could not end node.");
+	}
+
+	return tiles;
+}
+
+void IOMap::mergeTileArea(std::vector<LoadedTile> &tiles, Map &map) {
+	for (auto &[x, y, z, tile, zoneIds] : tiles) {
+		if (tile->isHouse() && !map.houses.addHouse(tile->houseId)) {
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", x, y, z, tile->houseId));
 		}
 
-		if (!stream.endNode()) {
-			throw IOMapException("Could not end node.");
+		for (const auto zoneId : zoneIds) {
+			Zone::getZone(zoneId)->addPosition(Position(x, y, z));
 		}
+
+		if (tile->isEmpty(true)) {
+			continue;
+		}
+
+		if (tile->ground) {
+			tile->ground = map.tryReplaceItemFromCache(tile->ground);
+		}
+
+		for (auto &item : tile->items) {
+			item = map.tryReplaceItemFromCache(item);
+		}
+
+		map.setBasicTile(x, y, z, tile);
 	}
 }
 
@@ -150,10 +150,31 @@ public:
 	}
 
 private:
+	/**
+	 * Byte range [begin, end) of an OTBM_TILE_AREA node payload, end marker included.
+	 */
+	struct TileAreaNode {
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	/**
+	 * A tile decoded off the map thread, waiting to be merged into the map.
+	 */
+	struct LoadedTile {
+		uint16_t x;
+		uint16_t y;
+		uint8_t z;
+		std::shared_ptr<BasicTile> tile;
+		std::vector<uint16_t> zoneIds;
+	};
+
 	static void parseMapDataAttributes(FileStream &stream, Map* map);
 	static void parseWaypoints(FileStream &stream, Map &map);
 	static void parseTowns(FileStream &stream, Map &map);
-	static void parseTileArea(FileStream &stream, Map &map, const Position &pos);
+	static std::vector<TileAreaNode> indexTileAreas(FileStream &stream);
+	static std::vector<LoadedTile> parseTileArea(FileStream &stream, const Position &pos);
+	static void mergeTileArea(std::vector<LoadedTile> &tiles, Map &map);
 };
 
 class IOMapException : public std::exception {
@@ -22,9 +22,10 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 		return;
 	}
 
+	const auto dataColumn = result->getColumn("data");
 	do {
 		unsigned long attrSize;
-		const char* attr = result->getStream("data", attrSize);
+		const char* attr = result->getStream(dataColumn, attrSize);
 
 		PropStream propStream;
 		propStream.init(attr, attrSize);
@@ -10,12 +10,12 @@
 #include "io/iomarket.hpp"
 
 #include "config/configmanager.hpp"
-#include "database/databasetasks.hpp"
 #include "game/game.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/save_manager.hpp"
 #include "io/iologindata.hpp"
 #include "items/containers/inbox/inbox.hpp"
+#include "lib/thread/thread_pool.hpp"
 #include "creatures/players/player.hpp"
 
 uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
@@ -28,96 +28,68 @@ uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
 	return tier;
 }
 
-MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
-	MarketOfferList offerList;
-
-	std::string query = fmt::format(
-		"SELECT `id`, `itemtype`, `amount`, `price`, `tier`, `created`, `anonymous`, "
-		"(SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` "
-		"FROM `market_offers` WHERE `sale` = {}",
-		action
-	);
-
-	DBResult_ptr result = g_database().storeQuery(query);
-	if (!result) {
-		return offerList;
+namespace {
+	MarketOffer toMarketOffer(const MarketOrder &order, int32_t marketOfferDuration) {
+		MarketOffer offer;
+		offer.itemId = order.itemId;
+		offer.amount = order.amount;
+		offer.price = order.price;
+		offer.timestamp = order.created + marketOfferDuration;
+		offer.counter = order.getCounter();
+		offer.tier = order.tier;
+		offer.playerName = order.anonymous ? "Anonymous" : order.playerName;
+		return offer;
 	}
 
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
+	MarketOfferList toMarketOfferList(const std::vector<const MarketOrder*> &orders) {
+		const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
 
-	do {
-		MarketOffer offer;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = (result->getNumber<uint32_t>("id") ^ 0xABCDEF) & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
-		} else {
-			offer.playerName = "Anonymous";
+		MarketOfferList offerList;
+		for (const auto* order : orders) {
+			offerList.push_back(toMarketOffer(*order, marketOfferDuration));
 		}
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
-	} while (result->next());
-	return offerList;
+		return offerList;
+	}
 }
 
-MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
-	MarketOfferList offerList;
+void IOMarket::loadOffers() {
+	orderBook.clear();
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `tier`, `created`, `anonymous`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `sale` = " << action << " AND `itemtype` = " << itemId << " AND `tier` = " << std::to_string(tier);
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return offerList;
+	DBResult_ptr result = g_database().storeQuery(
+		"SELECT `id`, `player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`, "
+		"(SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` "
+		"FROM `market_offers`"
+	);
+	if (result) {
+		do {
+			MarketOrder order;
+			order.id = result->getNumber<uint32_t>("id");
+			order.playerId = result->getNumber<uint32_t>("player_id");
+			order.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
+			order.itemId = result->getNumber<uint16_t>("itemtype");
+			order.amount = result->getNumber<uint16_t>("amount");
+			order.created = result->getNumber<uint32_t>("created");
+			order.anonymous = result->getNumber<uint16_t>("anonymous") != 0;
+			order.price = result->getNumber<uint64_t>("price");
+			order.tier = getTierFromDatabaseTable(result->getString("tier"));
+			order.playerName = result->getString("player_name");
+			orderBook.add(std::move(order));
+		} while (result->next());
 	}
 
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
-
-	do {
-		MarketOffer offer;
-		offer.itemId = itemId;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = (result->getNumber<uint32_t>("id") ^ 0xABCDEF) & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
-		} else {
-			offer.playerName = "Anonymous";
-		}
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
-	} while (result->next());
-	return offerList;
+	g_logger().info("Loaded {} market offers", orderBook.size());
 }
 
-MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId) {
-	MarketOfferList offerList;
-
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
-
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `created`, `itemtype`, `tier` FROM `market_offers` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
+MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
+	return toMarketOfferList(getInstance().orderBook.getOffers(action));
+}
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return offerList;
-	}
+MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
+	return toMarketOfferList(getInstance().orderBook.getOffers(action, itemId, tier));
+}
 
-	do {
-		MarketOffer offer;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = (result->getNumber<uint32_t>("id") ^ 0xABCDEF) & 0xFFFF;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
-	} while (result->next());
-	return offerList;
+MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId) {
+	return toMarketOfferList(getInstance().orderBook.getPlayerOffers(action, playerId));
 }
 
 HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t playerId) {
@@ -151,91 +123,82 @@ HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t p
 	return offerList;
 }
 
-void IOMarket::processExpiredOffers(const DBResult_ptr &result, bool) {
-	if (!result) {
-		return;
-	}
-
-	do {
-		if (!IOMarket::moveOfferToHistory(result->getNumber<uint32_t>("id"), OFFERSTATE_EXPIRED)) {
-			continue;
+void IOMarket::processExpiredOffer(const MarketOrder &order) {
+	if (order.type == MARKETACTION_SELL) {
+		const ItemType &itemType = Item::items[order.itemId];
+		if (itemType.id == 0) {
+			return;
 		}
 
-		const auto playerId = result->getNumber<uint32_t>("player_id");
-		const auto amount = result->getNumber<uint16_t>("amount");
-		auto tier = getTierFromDatabaseTable(result->getString("tier"));
-		if (result->getNumber<uint16_t>("sale") == 1) {
-			const ItemType &itemType = Item::items[result->getNumber<uint16_t>("itemtype")];
-			if (itemType.id == 0) {
-				continue;
-			}
-
-			const auto &player = g_game().getPlayerByGUID(playerId, true);
-			if (!player) {
-				continue;
-			}
-
-			const auto &playerInbox = player->getInbox();
+		const auto &player = g_game().getPlayerByGUID(order.playerId, true);
+		if (!player) {
+			return;
+		}
 
-			if (itemType.stackable) {
-				uint16_t tmpAmount = amount;
-				while (tmpAmount > 0) {
-					uint16_t stackCount = std::min<uint16_t>(100, tmpAmount);
-					const auto &item = Item::CreateItem(itemType.id, stackCount);
-					if (g_game().internalAddItem(playerInbox, item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
-						g_logger().error("[{}] Ocurred an error to add item with id {} to player {}", __FUNCTION__, itemType.id, player->getName());
+		const auto &playerInbox = player->getInbox();
 
-						break;
-					}
+		if (itemType.stackable) {
+			uint16_t tmpAmount = order.amount;
+			while (tmpAmount > 0) {
+				uint16_t stackCount = std::min<uint16_t>(100, tmpAmount);
+				const auto &item = Item::CreateItem(itemType.id, stackCount);
+				if (g_game().internalAddItem(playerInbox, item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
+					g_logger().error("[{}] Ocurred an error to add item with id {} to player {}", __FUNCTION__, itemType.id, player->getName());
 
-					if (tier != 0) {
-						item->setTier(tier);
-					}
+					break;
+				}
 
-					tmpAmount -= stackCount;
+				if (order.tier != 0) {
+					item->setTier(order.tier);
 				}
+
+				tmpAmount -= stackCount;
+			}
+		} else {
+			int32_t subType;
+			if (itemType.charges != 0) {
+				subType = itemType.charges;
 			} else {
-				int32_t subType;
-				if (itemType.charges != 0) {
-					subType = itemType.charges;
-				} else {
-					subType = -1;
-				}
+				subType = -1;
+			}
 
-				for (uint16_t i = 0; i < amount; ++i) {
-					const auto &item = Item::CreateItem(itemType.id, subType);
-					if (g_game().internalAddItem(playerInbox, item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
-						break;
-					}
+			for (uint16_t i = 0; i < order.amount; ++i) {
+				const auto &item = Item::CreateItem(itemType.id, subType);
+				if (g_game().internalAddItem(playerInbox, item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
+					break;
+				}
 
-					if (tier != 0) {
-						item->setTier(tier);
-					}
+				if (order.tier != 0) {
+					item->setTier(order.tier);
 				}
 			}
+		}
 
-			if (player->isOffline()) {
-				g_saveManager().savePlayer(player);
-			}
-		} else {
-			uint64_t totalPrice = result->getNumber<uint64_t>("price") * amount;
+		if (player->isOffline()) {
+			g_saveManager().savePlayer(player);
+		}
+	} else {
+		uint64_t totalPrice = order.price * order.amount;
 
-			const auto &player = g_game().getPlayerByGUID(playerId);
-			if (player) {
-				player->setBankBalance(player->getBankBalance() + totalPrice);
-			} else {
-				IOLoginData::increaseBankBalance(playerId, totalPrice);
-			}
+		const auto &player = g_game().getPlayerByGUID(order.playerId);
+		if (player) {
+			player->setBankBalance(player->getBankBalance() + totalPrice);
+		} else {
+			IOLoginData::increaseBankBalance(order.playerId, totalPrice);
 		}
-	} while (result->next());
+	}
 }
 
 void IOMarket::checkExpiredOffers() {
 	const time_t lastExpireDate = getTimeNow() - g_configManager().getNumber(MARKET_OFFER_DURATION);
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `itemtype`, `player_id`, `sale`, `tier` FROM `market_offers` WHERE `created` <= " << lastExpireDate;
-	g_databaseTasks().store(query.str(), IOMarket::processExpiredOffers);
+	auto &orderBook = getInstance().orderBook;
+	for (const auto offerId : orderBook.getCreatedUntil(static_cast<uint32_t>(lastExpireDate))) {
+		const MarketOrder order = *orderBook.find(offerId);
+		if (moveOfferToHistory(offerId, OFFERSTATE_EXPIRED)) {
+			processExpiredOffer(order);
+		}
+	}
 
 	int32_t checkExpiredMarketOffersEachMinutes = g_configManager().getNumber(CHECK_EXPIRED_MARKET_OFFERS_EACH_MINUTES);
 	if (checkExpiredMarketOffersEachMinutes <= 0) {
@@ -246,14 +209,7 @@ void IOMarket::checkExpiredOffers() {
 }
 
 uint32_t IOMarket::getPlayerOfferCount(uint32_t playerId) {
-	std::ostringstream query;
-	query << "SELECT COUNT(*) AS `count` FROM `market_offers` WHERE `player_id` = " << playerId;
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return 0;
-	}
-	return result->getNumber<int32_t>("count");
+	return getInstance().orderBook.getPlayerOfferCount(playerId);
 }
 
 MarketOfferEx IOMarket::getOfferByCounter(uint32_t timestamp, uint16_t counter) {
@@ -261,48 +217,69 @@ MarketOfferEx IOMarket::getOfferByCounter(uint32_t timestamp, uint16_t counter)
 
 	const int32_t created = timestamp - g_configManager().getNumber(MARKET_OFFER_DURATION);
 
-	std::ostringstream query;
-	query << "SELECT `id`, `sale`, `itemtype`, `amount`, `created`, `price`, `player_id`, `anonymous`, `tier`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `created` = " << created << " AND ((`id` ^ 0xABCDEF) & 65535) = " << counter << " LIMIT 1";
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
+	const auto* order = getInstance().orderBook.findByCounter(static_cast<uint32_t>(created), counter);
+	if (!order) {
 		offer.id = 0;
 		return offer;
 	}
 
-	offer.id = result->getNumber<uint32_t>("id");
-	offer.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
-	offer.amount = result->getNumber<uint16_t>("amount");
-	offer.counter = (result->getNumber<uint32_t>("id") ^ 0xABCDEF) & 0xFFFF;
-	offer.timestamp = result->getNumber<uint32_t>("created");
-	offer.price = result->getNumber<uint64_t>("price");
-	offer.itemId = result->getNumber<uint16_t>("itemtype");
-	offer.playerId = result->getNumber<uint32_t>("player_id");
-	offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-	if (result->getNumber<uint16_t>("anonymous") == 0) {
-		offer.playerName = result->getString("player_name");
-	} else {
-		offer.playerName = "Anonymous";
-	}
+	offer.id = order->id;
+	offer.type = order->type;
+	offer.amount = order->amount;
+	offer.counter = order->getCounter();
+	offer.timestamp = order->created;
+	offer.price = order->price;
+	offer.itemId = order->itemId;
+	offer.playerId = order->playerId;
+	offer.tier = order->tier;
+	offer.playerName = order->anonymous ? "Anonymous" : order->playerName;
 	return offer;
 }
 
 void IOMarket::createOffer(uint32_t playerId, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous) {
+	auto &orderBook = getInstance().orderBook;
+
+	MarketOrder order;
+	order.id = orderBook.nextId();
+	order.playerId = playerId;
+	order.type = action;
+	order.itemId = static_cast<uint16_t>(itemId);
+	order.amount = amount;
+	order.created = static_cast<uint32_t>(getTimeNow());
+	order.anonymous = anonymous;
+	order.price = price;
+	order.tier = tier;
+	if (const auto &player = g_game().getPlayerByGUID(playerId)) {
+		order.playerName = player->getName();
+	} else {
+		order.playerName = IOLoginData::getNameByGuid(playerId);
+	}
+
 	std::ostringstream query;
-	query << "INSERT INTO `market_offers` (`player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (" << playerId << ',' << action << ',' << itemId << ',' << amount << ',' << getTimeNow() << ',' << anonymous << ',' << price << ',' << std::to_string(tier) << ')';
-	Database::getInstance().executeQuery(query.str());
+	query << "INSERT INTO `market_offers` (`id`, `player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (" << order.id << ',' << playerId << ',' << action << ',' << itemId << ',' << amount << ',' << order.created << ',' << anonymous << ',' << price << ',' << std::to_string(tier) << ')';
+	persist(query.str());
+
+	orderBook.add(std::move(order));
 }
 
 void IOMarket::acceptOffer(uint32_t offerId, uint16_t amount) {
+	if (!getInstance().orderBook.reduce(offerId, amount)) {
+		return;
+	}
+
 	std::ostringstream query;
 	query << "UPDATE `market_offers` SET `amount` = `amount` - " << amount << " WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	persist(query.str());
 }
 
 void IOMarket::deleteOffer(uint32_t offerId) {
+	if (!getInstance().orderBook.remove(offerId)) {
+		return;
+	}
+
 	std::ostringstream query;
 	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	persist(query.str());
 }
 
 void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t itemId, uint16_t amount, uint64_t price, time_t timestamp, uint8_t tier, MarketOfferState_t state) {
@@ -310,36 +287,81 @@ void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t it
 	query << "INSERT INTO `market_history` (`player_id`, `sale`, `itemtype`, `amount`, `price`, `expires_at`, `inserted`, `state`, `tier`) VALUES ("
 		  << playerId << ',' << type << ',' << itemId << ',' << amount << ',' << price << ','
 		  << timestamp << ',' << getTimeNow() << ',' << state << ',' << std::to_string(tier) << ')';
-	g_databaseTasks().execute(query.str());
+	persist(query.str());
+
+	if (state == OFFERSTATE_ACCEPTED) {
+		getInstance().addStatistics(type, itemId, tier, price);
+	}
 }
 
 bool IOMarket::moveOfferToHistory(uint32_t offerId, MarketOfferState_t state) {
-	Database &db = Database::getInstance();
+	const auto order = getInstance().orderBook.remove(offerId);
+	if (!order) {
+		return false;
+	}
 
 	std::ostringstream query;
-	query << "SELECT `player_id`, `sale`, `itemtype`, `amount`, `price`, `created`, `tier` FROM `market_offers` WHERE `id` = " << offerId;
+	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
+	persist(query.str());
 
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
-		return false;
+	appendHistory(order->playerId, order->type, order->itemId, order->amount, order->price, getTimeNow(), order->tier, state);
+	return true;
+}
+
+void IOMarket::persist(std::string query) {
+	auto &market = getInstance();
+	std::scoped_lock lock(market.writeMutex);
+	market.pendingWrites.emplace_back(std::move(query));
+	if (std::exchange(market.writing, true)) {
+		return;
 	}
 
-	query.str(std::string());
-	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	if (!db.executeQuery(query.str())) {
-		return false;
+	g_threadPool().detach_task([&market] { market.writeBehind(); });
+}
+
+void IOMarket::writeBehind() {
+	std::vector<std::string> batch;
+	while (true) {
+		{
+			std::scoped_lock lock(writeMutex);
+			if (pendingWrites.empty()) {
+				writing = false;
+				writeSignal.notify_all();
+				return;
+			}
+			batch.swap(pendingWrites);
+		}
+
+		for (const auto &query : batch) {
+			if (!g_database().executeQuery(query)) {
+				g_logger().error("[IOMarket::writeBehind] - Failed to persist market change: {}", query);
+			}
+		}
+		batch.clear();
 	}
+}
 
-	appendHistory(
-		result->getNumber<uint32_t>("player_id"),
-		static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale")),
-		result->getNumber<uint16_t>("itemtype"),
-		result->getNumber<uint16_t>("amount"),
-		result->getNumber<uint64_t>("price"),
-		getTimeNow(),
-		getTierFromDatabaseTable(result->getString("tier")), state
-	);
-	return true;
+void IOMarket::flush() {
+	std::unique_lock lock(writeMutex);
+	writeSignal.wait(lock, [this] { return !writing; });
+	writing = true;
+	lock.unlock();
+
+	writeBehind();
+}
+
+void IOMarket::addStatistics(MarketAction_t type, uint16_t itemId, uint8_t tier, uint64_t price) {
+	std::scoped_lock lock(statisticsMutex);
+	auto &statistics = (type == MARKETACTION_BUY) ? purchaseStatistics[itemId][tier] : saleStatistics[itemId][tier];
+	if (statistics.numTransactions == 0) {
+		statistics.lowestPrice = price;
+		statistics.highestPrice = price;
+	} else {
+		statistics.lowestPrice = std::min(statistics.lowestPrice, price);
+		statistics.highestPrice = std::max(statistics.highestPrice, price);
+	}
+	++statistics.numTransactions;
+	statistics.totalPrice += price;
 }
 
 void IOMarket::updateStatistics() {
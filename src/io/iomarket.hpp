@@ -11,8 +11,17 @@
 
 #include "database/database.hpp"
 #include "declarations.hpp"
+#include "io/market_order_book.hpp"
 #include "lib/di/container.hpp"
 
+/**
+ * @brief The market, served from an in-memory order book.
+ *
+ * The active offers are loaded once at startup and browsing never queries the
+ * database. Changes to the offers and the history are written behind, in order,
+ * by a single thread pool task, and flushed on shutdown. The statistics are
+ * loaded at startup and updated as offers are accepted.
+ */
 class IOMarket {
 public:
 	IOMarket() = default;
@@ -21,12 +30,13 @@ public:
 		return inject<IOMarket>();
 	}
 
+	void loadOffers();
+
 	static MarketOfferList getActiveOffers(MarketAction_t action);
 	static MarketOfferList getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier);
 	static MarketOfferList getOwnOffers(MarketAction_t action, uint32_t playerId);
 	static HistoryMarketOfferList getOwnHistory(MarketAction_t action, uint32_t playerId);
 
-	static void processExpiredOffers(const DBResult_ptr &result, bool);
 	static void checkExpiredOffers();
 
 	static uint32_t getPlayerOfferCount(uint32_t playerId);
@@ -39,6 +49,11 @@ public:
 	static void appendHistory(uint32_t playerId, MarketAction_t type, uint16_t itemId, uint16_t amount, uint64_t price, time_t timestamp, uint8_t tier, MarketOfferState_t state);
 	static bool moveOfferToHistory(uint32_t offerId, MarketOfferState_t state);
 
+	/**
+	 * @brief Blocks until every pending market change is written to the database.
+	 */
+	void flush();
+
 	void updateStatistics();
 
 	using StatisticsMap = std::map<uint16_t, std::map<uint8_t, MarketStatistics>>;
@@ -53,6 +68,18 @@ public:
 	static uint8_t getTierFromDatabaseTable(const std::string &string);
 
 private:
+	static void processExpiredOffer(const MarketOrder &order);
+	static void persist(std::string query);
+	void writeBehind();
+	void addStatistics(MarketAction_t type, uint16_t itemId, uint8_t tier, uint64_t price);
+
+	MarketOrderBook orderBook;
+
+	std::vector<std::string> pendingWrites;
+	bool writing = false;
+	std::mutex writeMutex;
+	std::condition_variable writeSignal;
+
 	// [uint16_t = item id, [uint8_t = item tier, MarketStatistics = structure of the statistics]]
 	StatisticsMap purchaseStatistics;
 	StatisticsMap saleStatistics;
@@ -0,0 +1,120 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "io/login_pipeline.hpp"
+
+#include "config/configmanager.hpp"
+#include "creatures/players/player.hpp"
+#include "database/database.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "io/iologindata.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "lib/thread/thread_pool.hpp"
+
+struct LoginPipeline::Request {
+	Request(std::shared_ptr<Player> player, Callback callback) :
+		player(std::move(player)), callback(std::move(callback)) { }
+
+	std::shared_ptr<Player> player;
+	Callback callback;
+	metrics::login_latency totalLatency { "total" };
+	std::unique_ptr<metrics::login_latency> queueLatency;
+};
+
+namespace {
+	size_t getConcurrencyLimit() {
+		return static_cast<size_t>(std::max<int32_t>(1, g_configManager().getNumber(MAX_CONCURRENT_LOGINS)));
+	}
+}
+
+bool LoginPipeline::load(const std::shared_ptr<Player> &player, Callback callback) {
+	// dispatcher thread
+	if (!loading.emplace(player->getGUID()).second) {
+		return false;
+	}
+
+	auto request = std::make_shared<Request>(player, std::move(callback));
+	if (running >= getConcurrencyLimit()) {
+		request->queueLatency = std::make_unique<metrics::login_latency>("queue");
+		queued.emplace_back(std::move(request));
+		g_metrics().addUpDownCounter("login_queue", 1);
+		return true;
+	}
+
+	start(std::move(request));
+	return true;
+}
+
+void LoginPipeline::start(std::shared_ptr<Request> request) {
+	// dispatcher thread
+	++running;
+	g_metrics().addUpDownCounter("login_running", 1);
+	if (request->queueLatency) {
+		request->queueLatency->stop();
+	}
+
+	runDetached([this, request = std::move(request)] {
+		metrics::login_latency measureLoad("load");
+		DBResult_ptr result;
+		const bool loaded = loadDetached(request->player, result);
+		measureLoad.stop();
+
+		runAttached([this, request, result, loaded] {
+			bool attached = loaded;
+			if (attached) {
+				metrics::login_latency measureAttach("attach");
+				attached = loadAttached(request->player, result);
+			}
+			finish(request, attached);
+		});
+	});
+}
+
+void LoginPipeline::finish(const std::shared_ptr<Request> &request, bool loaded) {
+	// dispatcher thread
+	--running;
+	g_metrics().addUpDownCounter("login_running", -1);
+	loading.erase(request->player->getGUID());
+
+	request->callback(loaded);
+	request->totalLatency.stop();
+
+	const auto limit = getConcurrencyLimit();
+	while (!queued.empty() && running < limit) {
+		auto next = std::move(queued.front());
+		queued.pop_front();
+		g_metrics().addUpDownCounter("login_queue", -1);
+		start(std::move(next));
+	}
+}
+
+void LoginPipeline::runDetached(std::function<void()> task) {
+	g_threadPool().detach_task(std::move(task));
+}
+
+void LoginPipeline::runAttached(std::function<void()> task) {
+	g_dispatcher().addEvent(std::move(task), "LoginPipeline::load");
+}
+
+bool LoginPipeline::loadDetached(const std::shared_ptr<Player> &player, DBResult_ptr &result) {
+	// thread pool
+	result = Database::getInstance().storeQuery(fmt::format("SELECT * FROM `players` WHERE `id` = {}", player->getGUID()));
+	return IOLoginData::loadPlayerDetached(player, result);
+}
+
+bool LoginPipeline::loadAttached(const std::shared_ptr<Player> &player, const DBResult_ptr &result) {
+	// dispatcher thread
+	try {
+		IOLoginData::loadPlayerAttached(player, result, false);
+		return true;
+	} catch (const std::exception &e) {
+		g_logger().warn("[LoginPipeline::loadAttached] - Error while load player {}: {}", player->getName(), e.what());
+		return false;
+	}
+}
@@ -0,0 +1,81 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "lib/di/container.hpp"
+
+class Player;
+class DBResult;
+using DBResult_ptr = std::shared_ptr<DBResult>;
+
+/**
+ * @brief Loads logging in players on the thread pool, off the dispatcher.
+ *
+ * The queries and item deserialization of IOLoginData::loadPlayerDetached run on
+ * the thread pool into a player not yet added to the game. The parts bound to
+ * shared game state (IOLoginData::loadPlayerAttached, which also starts item
+ * decay) and the completion callback run back on the dispatcher.
+ * At most maxConcurrentLogins players load at once, further logins wait in
+ * order, and a character already loading cannot be loaded a second time.
+ *
+ * Every member is only accessed on the dispatcher thread.
+ */
+class LoginPipeline {
+public:
+	using Callback = std::function<void(bool loaded)>;
+
+	LoginPipeline() = default;
+	virtual ~LoginPipeline() = default;
+
+	// non-copyable
+	LoginPipeline(const LoginPipeline &) = delete;
+	LoginPipeline &operator=(const LoginPipeline &) = delete;
+
+	static LoginPipeline &getInstance() {
+		return inject<LoginPipeline>();
+	}
+
+	/**
+	 * @brief Loads the player with its GUID, then calls the callback on the dispatcher.
+	 * @return False, without calling the callback, if the character is already loading.
+	 */
+	bool load(const std::shared_ptr<Player> &player, Callback callback);
+
+	bool isLoading(uint32_t guid) const {
+		return loading.contains(guid);
+	}
+
+	size_t getRunning() const {
+		return running;
+	}
+
+	size_t getQueued() const {
+		return queued.size();
+	}
+
+protected:
+	// The stages of a load, replaced in tests that run without database, thread pool or dispatcher
+	virtual void runDetached(std::function<void()> task);
+	virtual void runAttached(std::function<void()> task);
+	virtual bool loadDetached(const std::shared_ptr<Player> &player, DBResult_ptr &result);
+	virtual bool loadAttached(const std::shared_ptr<Player> &player, const DBResult_ptr &result);
+
+private:
+	struct Request;
+
+	void start(std::shared_ptr<Request> request);
+	void finish(const std::shared_ptr<Request> &request, bool loaded);
+
+	std::deque<std::shared_ptr<Request>> queued;
+	phmap::flat_hash_set<uint32_t> loading;
+	size_t running = 0;
+};
+
+constexpr auto g_loginPipeline = LoginPipeline::getInstance;
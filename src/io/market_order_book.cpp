@@ -0,0 +1,132 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "io/market_order_book.hpp"
+
+const MarketOrder &MarketOrderBook::add(MarketOrder order) {
+	remove(order.id);
+
+	const auto id = order.id;
+	lastId = std::max(lastId, id);
+	itemOffers[getItemKey(order.type, order.itemId, order.tier)].emplace(id);
+	playerOffers[order.playerId].emplace(id);
+	createdOffers.emplace(order.created, id);
+	return orders.try_emplace(id, std::move(order)).first->second;
+}
+
+std::optional<MarketOrder> MarketOrderBook::remove(uint32_t id) {
+	const auto it = orders.find(id);
+	if (it == orders.end()) {
+		return std::nullopt;
+	}
+
+	MarketOrder order = std::move(it->second);
+	orders.erase(it);
+
+	const auto eraseFrom = [id](auto &index, uint32_t key) {
+		if (const auto indexIt = index.find(key); indexIt != index.end()) {
+			indexIt->second.erase(id);
+			if (indexIt->second.empty()) {
+				index.erase(indexIt);
+			}
+		}
+	};
+	eraseFrom(itemOffers, getItemKey(order.type, order.itemId, order.tier));
+	eraseFrom(playerOffers, order.playerId);
+	createdOffers.erase({ order.created, id });
+	return order;
+}
+
+bool MarketOrderBook::reduce(uint32_t id, uint16_t amount) {
+	const auto it = orders.find(id);
+	if (it == orders.end()) {
+		return false;
+	}
+
+	it->second.amount -= std::min(amount, it->second.amount);
+	return true;
+}
+
+const MarketOrder* MarketOrderBook::find(uint32_t id) const {
+	const auto it = orders.find(id);
+	return it != orders.end() ? &it->second : nullptr;
+}
+
+const MarketOrder* MarketOrderBook::findByCounter(uint32_t created, uint16_t counter) const {
+	for (auto it = createdOffers.lower_bound({ created, 0 }); it != createdOffers.end() && it->first == created; ++it) {
+		const auto &order = orders.at(it->second);
+		if (order.getCounter() == counter) {
+			return &order;
+		}
+	}
+	return nullptr;
+}
+
+std::vector<const MarketOrder*> MarketOrderBook::getOffers(MarketAction_t action) const {
+	std::vector<const MarketOrder*> offers;
+	for (const auto &[key, ids] : itemOffers) {
+		if (static_cast<MarketAction_t>(key & 1) != action) {
+			continue;
+		}
+		for (const auto id : ids) {
+			offers.emplace_back(&orders.at(id));
+		}
+	}
+	std::ranges::sort(offers, {}, &MarketOrder::id);
+	return offers;
+}
+
+std::vector<const MarketOrder*> MarketOrderBook::getOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) const {
+	const auto it = itemOffers.find(getItemKey(action, itemId, tier));
+	if (it == itemOffers.end()) {
+		return {};
+	}
+	return collect(it->second);
+}
+
+std::vector<const MarketOrder*> MarketOrderBook::getPlayerOffers(MarketAction_t action, uint32_t playerId) const {
+	const auto it = playerOffers.find(playerId);
+	if (it == playerOffers.end()) {
+		return {};
+	}
+	return collect(it->second, action);
+}
+
+uint32_t MarketOrderBook::getPlayerOfferCount(uint32_t playerId) const {
+	const auto it = playerOffers.find(playerId);
+	return it != playerOffers.end() ? static_cast<uint32_t>(it->second.size()) : 0;
+}
+
+std::vector<uint32_t> MarketOrderBook::getCreatedUntil(uint32_t created) const {
+	std::vector<uint32_t> ids;
+	for (auto it = createdOffers.begin(); it != createdOffers.end() && it->first <= created; ++it) {
+		ids.emplace_back(it->second);
+	}
+	return ids;
+}
+
+void MarketOrderBook::clear() {
+	orders.clear();
+	itemOffers.clear();
+	playerOffers.clear();
+	createdOffers.clear();
+	lastId = 0;
+}
+
+std::vector<const MarketOrder*> MarketOrderBook::collect(const std::set<uint32_t> &ids, std::optional<MarketAction_t> action /* = std::nullopt */) const {
+	std::vector<const MarketOrder*> offers;
+	offers.reserve(ids.size());
+	for (const auto id : ids) {
+		const auto &order = orders.at(id);
+		if (!action || order.type == *action) {
+			offers.emplace_back(&order);
+		}
+	}
+	return offers;
+}
@@ -0,0 +1,103 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "declarations.hpp"
+
+/**
+ * @brief An active offer of the market, as stored in the `market_offers` table.
+ */
+struct MarketOrder {
+	uint32_t id = 0;
+	uint32_t playerId = 0;
+	uint32_t created = 0;
+	uint64_t price = 0;
+	uint16_t itemId = 0;
+	uint16_t amount = 0;
+	uint8_t tier = 0;
+	MarketAction_t type = MARKETACTION_BUY;
+	bool anonymous = false;
+	std::string playerName;
+
+	/**
+	 * @brief The identifier the client sends back, together with the expiration time, to refer to the offer.
+	 */
+	uint16_t getCounter() const {
+		return static_cast<uint16_t>((id ^ 0xABCDEF) & 0xFFFF);
+	}
+};
+
+/**
+ * @brief The active market offers, indexed by item, by player and by creation time.
+ *
+ * Holds a copy of the `market_offers` table so browsing the market does not
+ * query the database. Offers are listed in id order, as the table returns them.
+ * Not thread safe, it is only used on the dispatcher thread.
+ */
+class MarketOrderBook {
+public:
+	/**
+	 * @brief Adds an offer, replacing any offer with the same id.
+	 */
+	const MarketOrder &add(MarketOrder order);
+
+	/**
+	 * @return The removed offer, or nullopt if there is no offer with the id.
+	 */
+	std::optional<MarketOrder> remove(uint32_t id);
+
+	/**
+	 * @brief Lowers the amount of an offer after part of it was accepted.
+	 * @return False if there is no offer with the id.
+	 */
+	bool reduce(uint32_t id, uint16_t amount);
+
+	const MarketOrder* find(uint32_t id) const;
+	const MarketOrder* findByCounter(uint32_t created, uint16_t counter) const;
+
+	std::vector<const MarketOrder*> getOffers(MarketAction_t action) const;
+	std::vector<const MarketOrder*> getOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) const;
+	std::vector<const MarketOrder*> getPlayerOffers(MarketAction_t action, uint32_t playerId) const;
+	uint32_t getPlayerOfferCount(uint32_t playerId) const;
+
+	/**
+	 * @return The ids of the offers created at or before the given time, oldest first.
+	 */
+	std::vector<uint32_t> getCreatedUntil(uint32_t created) const;
+
+	/**
+	 * @brief Reserves the id of a new offer, higher than any offer added so far.
+	 */
+	uint32_t nextId() {
+		return ++lastId;
+	}
+
+	size_t size() const {
+		return orders.size();
+	}
+
+	void clear();
+
+private:
+	static uint32_t getItemKey(MarketAction_t action, uint16_t itemId, uint8_t tier) {
+		return (static_cast<uint32_t>(itemId) << 16) | (static_cast<uint32_t>(tier) << 1) | static_cast<uint32_t>(action);
+	}
+
+	std::vector<const MarketOrder*> collect(const std::set<uint32_t> &ids, std::optional<MarketAction_t> action = std::nullopt) const;
+
+	phmap::flat_hash_map<uint32_t, MarketOrder> orders;
+	// [uint32_t = item id, tier and action, ids of the offers]
+	phmap::flat_hash_map<uint32_t, std::set<uint32_t>> itemOffers;
+	// [uint32_t = player id, ids of the offers]
+	phmap::flat_hash_map<uint32_t, std::set<uint32_t>> playerOffers;
+	// [created, id]
+	std::set<std::pair<uint32_t, uint32_t>> createdOffers;
+	uint32_t lastId = 0;
+};
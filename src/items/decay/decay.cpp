@@ -14,6 +14,9 @@
 #include "game/scheduling/dispatcher.hpp"
 #include "lib/di/container.hpp"
 
+Decay::Decay() :
+	decayWheel(SCHEDULER_MINTICKS) { }
+
 Decay &Decay::getInstance() {
 	return inject<Decay>();
 }
@@ -46,23 +49,23 @@ void Decay::startDecay(const std::shared_ptr<Item> &item) {
 			stopDecay(item);
 		}
 
-		const int64_t timestamp = OTSYS_TIME() + duration;
-		if (decayMap.empty()) {
-			eventId = g_dispatcher().scheduleEvent(
-				std::max<int32_t>(SCHEDULER_MINTICKS, duration), [this] { checkDecay(); }, "Decay::checkDecay"
-			);
-		} else {
-			if (timestamp < decayMap.begin()->first) {
-				g_dispatcher().stopEvent(eventId);
-				eventId = g_dispatcher().scheduleEvent(
-					std::max<int32_t>(SCHEDULER_MINTICKS, duration), [this] { checkDecay(); }, "Decay::checkDecay"
-				);
-			}
-		}
+		const int64_t now = OTSYS_TIME();
+		const int64_t timestamp = now + duration;
 
 		item->setDecaying(DECAYING_TRUE);
 		item->setAttribute(ItemAttribute_t::DURATION_TIMESTAMP, timestamp);
-		decayMap[timestamp].push_back(item);
+
+		if (const auto it = decayHandles.find(item.get()); it != decayHandles.end()) {
+			decayWheel.cancel(it->second);
+		}
+		decayHandles[item.get()] = decayWheel.insert(now, timestamp, item);
+
+		// A single fixed-tick event drives the wheel while there is something decaying
+		if (eventId == 0) {
+			eventId = g_dispatcher().scheduleEvent(
+				SCHEDULER_MINTICKS, [this] { checkDecay(); }, "Decay::checkDecay"
+			);
+		}
 	}
 }
 
@@ -71,42 +74,18 @@ void Decay::stopDecay(const std::shared_ptr<Item> &item) {
 		return;
 	}
 	if (item->hasAttribute(ItemAttribute_t::DECAYSTATE)) {
-		const auto timestamp = item->getAttribute<int64_t>(ItemAttribute_t::DURATION_TIMESTAMP);
 		if (item->hasAttribute(ItemAttribute_t::DURATION_TIMESTAMP)) {
-			const auto it = decayMap.find(timestamp);
-			if (it != decayMap.end()) {
-				auto &decayItems = it->second;
-
-				size_t i = 0;
-				const size_t end = decayItems.size();
-				auto decayItem = decayItems[i];
-				if (end == 1) {
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayMap.erase(it);
-					}
-					return;
-				}
-				while (i < end) {
-					decayItem = decayItems[i];
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayItems[i] = decayItems.back();
-						decayItems.pop_back();
-						return;
-					}
-					++i;
+			const auto it = decayHandles.find(item.get());
+			if (it != decayHandles.end()) {
+				if (item->hasAttribute(ItemAttribute_t::DURATION)) {
+					// Incase we removed duration attribute don't assign new duration
+					item->setDuration(item->getDuration());
 				}
+				item->removeAttribute(ItemAttribute_t::DECAYSTATE);
+
+				decayWheel.cancel(it->second);
+				decayHandles.erase(it);
+				return;
 			}
 			item->removeAttribute(ItemAttribute_t::DURATION_TIMESTAMP);
 		} else {
@@ -116,28 +95,15 @@ void Decay::stopDecay(const std::shared_ptr<Item> &item) {
 }
 
 void Decay::checkDecay() {
-	const int64_t timestamp = OTSYS_TIME();
+	eventId = 0;
 
-	std::vector<std::shared_ptr<Item>> tempItems;
-	tempItems.reserve(32); // Small preallocation
-
-	auto it = decayMap.begin();
-	const auto end = decayMap.end();
-	while (it != end) {
-		if (it->first > timestamp) {
-			break;
-		}
-
-		// Iterating here is unsafe so let's copy our items into temporary vector
-		auto &decayItems = it->second;
-		tempItems.reserve(tempItems.size() + decayItems.size());
-		for (auto &decayItem : decayItems) {
-			tempItems.emplace_back(decayItem);
-		}
-		it = decayMap.erase(it);
+	std::vector<std::shared_ptr<Item>> expiredItems;
+	decayWheel.advance(OTSYS_TIME(), expiredItems);
+	for (const auto &item : expiredItems) {
+		decayHandles.erase(item.get());
 	}
 
-	for (const auto &item : tempItems) {
+	for (const auto &item : expiredItems) {
 		if (!item->canDecay()) {
 			item->setDuration(item->getDuration());
 			item->setDecaying(DECAYING_FALSE);
@@ -147,9 +113,10 @@ void Decay::checkDecay() {
 		}
 	}
 
-	if (it != end) {
+	// Decaying items may have started a new decay, which already scheduled the next tick
+	if (eventId == 0 && !decayWheel.empty()) {
 		eventId = g_dispatcher().scheduleEvent(
-			std::max<int32_t>(SCHEDULER_MINTICKS, static_cast<int32_t>(it->first - timestamp)), [this] { checkDecay(); }, "Decay::checkDecay"
+			SCHEDULER_MINTICKS, [this] { checkDecay(); }, "Decay::checkDecay"
 		);
 	}
 }
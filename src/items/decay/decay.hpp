@@ -9,11 +9,13 @@
 
 #pragma once
 
+#include "utils/timing_wheel.hpp"
+
 class Item;
 
 class Decay {
 public:
-	Decay() = default;
+	Decay();
 
 	Decay(const Decay &) = delete;
 	void operator=(const Decay &) = delete;
@@ -27,9 +29,10 @@ private:
 	void checkDecay();
 	static void internalDecayItem(const std::shared_ptr<Item> &item);
 
-	uint32_t eventId { 0 };
-	// order is important, so we use an std::map
-	std::map<int64_t, std::vector<std::shared_ptr<Item>>> decayMap;
+	uint64_t eventId { 0 };
+	// expired items are handed back ordered by their timestamp
+	stdext::timing_wheel<std::shared_ptr<Item>> decayWheel;
+	phmap::flat_hash_map<const Item*, stdext::timing_wheel<std::shared_ptr<Item>>::handle> decayHandles;
 };
 
 constexpr auto g_decay = Decay::getInstance;
@@ -447,6 +447,7 @@ void Tile::onAddTileItem(const std::shared_ptr<Item> &item) {
 }
 
 void Tile::onUpdateTileItem(const std::shared_ptr<Item> &oldItem, const ItemType &oldType, const std::shared_ptr<Item> &newItem, const ItemType &newType) {
+	invalidateDescription();
 	if (!oldItem || !newItem) {
 		g_logger().error("Tile::onUpdateTileItem: oldItem or newItem is nullptr");
 		return;
@@ -1025,11 +1026,11 @@ void Tile::addThing(int32_t, const std::shared_ptr<Thing> &thing) {
 
 	const auto &creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
 		creature->setParent(static_self_cast<Tile>());
 
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
+		updateTileBits();
 	} else {
 		const auto &item = thing->getItem();
 		if (item == nullptr) {
@@ -1241,8 +1242,8 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 		if (creatures) {
 			const auto it = std::ranges::find(*creatures, thing);
 			if (it != creatures->end()) {
-				Spectators::clearCache();
 				creatures->erase(it);
+				updateTileBits();
 			}
 		}
 		return;
@@ -1647,10 +1648,9 @@ void Tile::internalAddThing(uint32_t, const std::shared_ptr<Thing> &thing) {
 
 	const auto &creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
-
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
+		updateTileBits();
 	} else {
 		const auto &item = thing->getItem();
 		if (item == nullptr) {
@@ -1699,6 +1699,9 @@ void Tile::updateTileFlags(const std::shared_ptr<Item> &item) {
 }
 
 void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
+	invalidateDescription();
+	const uint32_t oldFlags = flags;
+
 	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
 		const auto &it = Item::items[item->getID()];
 		if (it.floorChange != 0) {
@@ -1783,9 +1786,14 @@ void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	updateTileBits(flags != oldFlags);
 }
 
 void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
+	invalidateDescription();
+	const uint32_t oldFlags = flags;
+
 	const ItemType &it = Item::items[item->getID()];
 	if (it.floorChange != 0) {
 		resetFlag(TILESTATE_FLOORCHANGE);
@@ -1864,6 +1872,22 @@ void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	updateTileBits(flags != oldFlags);
+}
+
+void Tile::updateTileBits(bool flagsChanged /* = false*/) const {
+	const auto sector = g_game().map.getMapSector(tilePos.x, tilePos.y);
+	if (!sector) {
+		return;
+	}
+
+	if (flagsChanged) {
+		sector->onTileChange();
+	}
+	if (const auto floor = sector->getFloor(tilePos.z)) {
+		floor->updateTileBits(tilePos.x, tilePos.y, this);
+	}
 }
 
 bool Tile::isMovableBlocking() const {
@@ -22,6 +22,7 @@ class Zone;
 class Cylinder;
 class Item;
 class ItemType;
+class TileDescription;
 
 using CreatureVector = std::vector<std::shared_ptr<Creature>>;
 using ItemVector = std::vector<std::shared_ptr<Item>>;
@@ -176,6 +177,11 @@ public:
 	void resetFlag(uint32_t flag) {
 		this->flags &= ~flag;
 	}
+	/**
+	 * @brief Mirrors the tile into the bits of its floor, see Floor::TileBits.
+	 * @param flagsChanged Whether its walkability flags changed, bumping the tile version of its sector.
+	 */
+	void updateTileBits(bool flagsChanged = false) const;
 	void addZone(const std::shared_ptr<Zone> &zone);
 	void clearZones();
 
@@ -257,6 +263,24 @@ public:
 		if ((ground = item)) {
 			setTileFlags(item);
 		}
+		invalidateDescription();
+	}
+
+	/**
+	 * @brief Bumped whenever the items of the tile change, cached descriptions built from an older version are stale.
+	 */
+	uint32_t getDescriptionVersion() const {
+		return descriptionVersion.load(std::memory_order_acquire);
+	}
+	void invalidateDescription() {
+		descriptionVersion.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	std::shared_ptr<const TileDescription> getCachedDescription() const {
+		return cachedDescription.load(std::memory_order_acquire);
+	}
+	void setCachedDescription(std::shared_ptr<const TileDescription> description) const {
+		cachedDescription.store(std::move(description), std::memory_order_release);
 	}
 
 	// This method maintains safety in asynchronous calls, avoiding competition between threads.
@@ -278,6 +302,11 @@ protected:
 	Position tilePos;
 	uint32_t flags = 0;
 	std::unordered_set<std::shared_ptr<Zone>> zones {};
+
+private:
+	// Description caches are shared by every client and may be read from parallel tasks
+	std::atomic<uint32_t> descriptionVersion = 0;
+	mutable std::atomic<std::shared_ptr<const TileDescription>> cachedDescription;
 };
 
 // Used for walkable tiles, where there is high likeliness of
@@ -54,6 +54,8 @@ void KVStore::setLocked(const std::string &key, const ValueWrapper &value) {
 			evictKey = *last;
 			evictValue = store_[*last].first;
 			needsEviction = true;
+			// The evicted key may belong to a prefetched prefix that is no longer complete in memory
+			prefetched_.clear();
 			store_.erase(*last);
 			lruQueue_.pop_back();
 		}
@@ -83,6 +85,9 @@ std::optional<ValueWrapper> KVStore::get(const std::string &key, bool forceLoad
 				lruQueue_.splice(lruQueue_.begin(), lruQueue_, lruIt);
 				return value;
 			}
+			if (isPrefetchedLocked(key)) {
+				return std::nullopt;
+			}
 		}
 	}
 
@@ -97,9 +102,117 @@ std::optional<ValueWrapper> KVStore::get(const std::string &key, bool forceLoad
 	return value;
 }
 
+std::vector<std::optional<ValueWrapper>> KVStore::getMany(const std::vector<std::string> &keys) {
+	std::vector<std::optional<ValueWrapper>> values(keys.size());
+	std::vector<std::string> missing;
+	{
+		std::scoped_lock lock(mutex_);
+		for (size_t i = 0; i < keys.size(); ++i) {
+			const auto it = store_.find(keys[i]);
+			if (it == store_.end()) {
+				if (!isPrefetchedLocked(keys[i])) {
+					missing.emplace_back(keys[i]);
+				}
+				continue;
+			}
+			auto &[value, lruIt] = it->second;
+			if (value.isDeleted()) {
+				lruQueue_.splice(lruQueue_.end(), lruQueue_, lruIt);
+				continue;
+			}
+			lruQueue_.splice(lruQueue_.begin(), lruQueue_, lruIt);
+			values[i] = value;
+		}
+	}
+
+	if (missing.empty()) {
+		return values;
+	}
+
+	logger.trace("KVStore::getMany() - loading {} of {} keys", missing.size(), keys.size());
+	const auto loaded = loadMany(missing);
+	{
+		std::scoped_lock lock(mutex_);
+		for (const auto &[key, value] : loaded) {
+			// A set while loading is newer than the stored value
+			if (!store_.contains(key)) {
+				setLocked(key, value);
+			}
+		}
+		for (size_t i = 0; i < keys.size(); ++i) {
+			if (values[i]) {
+				continue;
+			}
+			const auto it = store_.find(keys[i]);
+			if (it != store_.end() && !it->second.first.isDeleted()) {
+				values[i] = it->second.first;
+			}
+		}
+	}
+	processEvictions();
+	return values;
+}
+
+void KVStore::prefetch(const std::string &prefix) {
+	{
+		std::scoped_lock lock(mutex_);
+		if (isPrefetchedLocked(prefix)) {
+			return;
+		}
+	}
+
+	const auto loaded = loadPrefixValues(prefix);
+	{
+		std::scoped_lock lock(mutex_);
+		const auto evictions = pendingEvictions_.size();
+		for (const auto &[key, value] : loaded) {
+			if (!store_.contains(key)) {
+				setLocked(key, value);
+			}
+		}
+		// Only complete if nothing was evicted to make room
+		if (pendingEvictions_.size() == evictions) {
+			prefetched_.emplace(prefix);
+		}
+	}
+	logger.trace("KVStore::prefetch({}) - loaded {} keys", prefix, loaded.size());
+	processEvictions();
+}
+
+bool KVStore::isPrefetchedLocked(const std::string &key) const {
+	if (prefetched_.empty()) {
+		return false;
+	}
+	for (auto pos = key.find('.'); pos != std::string::npos; pos = key.find('.', pos + 1)) {
+		if (prefetched_.contains(key.substr(0, pos + 1))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<std::pair<std::string, ValueWrapper>> KVStore::loadMany(const std::vector<std::string> &keys) {
+	std::vector<std::pair<std::string, ValueWrapper>> values;
+	for (const auto &key : keys) {
+		if (auto value = load(key)) {
+			values.emplace_back(key, std::move(*value));
+		}
+	}
+	return values;
+}
+
+std::vector<std::pair<std::string, ValueWrapper>> KVStore::loadPrefixValues(const std::string &prefix) {
+	std::vector<std::string> keys;
+	for (const auto &suffix : loadPrefix(prefix)) {
+		keys.emplace_back(prefix + suffix);
+	}
+	return loadMany(keys);
+}
+
 std::unordered_set<std::string> KVStore::keys(const std::string &prefix /*= ""*/) {
 	std::unordered_set<std::string> keys;
 
+	bool prefetched = false;
 	{
 		std::scoped_lock lock(mutex_);
 		for (const auto &[key, value] : store_) {
@@ -108,6 +221,12 @@ std::unordered_set<std::string> KVStore::keys(const std::string &prefix /*= ""*/
 				keys.insert(suffix);
 			}
 		}
+		prefetched = isPrefetchedLocked(prefix);
+	}
+
+	// Everything stored under a prefetched prefix is already in memory
+	if (prefetched) {
+		return keys;
 	}
 
 	for (const auto &key : loadPrefix(prefix)) {
@@ -10,6 +10,7 @@
 #pragma once
 
 #ifndef USE_PRECOMPILED_HEADERS
+	#include <atomic>
 	#include <string>
 	#include <mutex>
 	#include <initializer_list>
@@ -19,6 +20,7 @@
 	#include <iomanip>
 	#include <list>
 	#include <utility>
+	#include <vector>
 #endif
 
 #include "kv/value_wrapper.hpp"
@@ -31,6 +33,10 @@ public:
 	virtual void set(const std::string &key, const ValueWrapper &value) = 0;
 
 	virtual std::optional<ValueWrapper> get(const std::string &key, bool forceLoad = false) = 0;
+	// Same as get for each key, results in the same order, but loads the missing ones at once
+	virtual std::vector<std::optional<ValueWrapper>> getMany(const std::vector<std::string> &keys) = 0;
+	// Loads every stored value under prefix ("player.123."), later gets within it are answered from memory
+	virtual void prefetch(const std::string &prefix) = 0;
 
 	virtual bool saveAll() {
 		return true;
@@ -85,6 +91,8 @@ public:
 	void set(const std::string &key, const ValueWrapper &value) override;
 
 	std::optional<ValueWrapper> get(const std::string &key, bool forceLoad = false) override;
+	std::vector<std::optional<ValueWrapper>> getMany(const std::vector<std::string> &keys) override;
+	void prefetch(const std::string &prefix) override;
 
 	void flush() override {
 		std::vector<std::pair<std::string, ValueWrapper>> snapshot;
@@ -97,6 +105,7 @@ public:
 			snapshot.insert(snapshot.end(), pendingEvictions_.begin(), pendingEvictions_.end());
 			store_.clear();
 			pendingEvictions_.clear();
+			prefetched_.clear();
 		}
 		for (const auto &[k, v] : snapshot) {
 			save(k, v);
@@ -122,22 +131,31 @@ protected:
 	virtual std::optional<ValueWrapper> load(const std::string &key) = 0;
 	virtual bool save(const std::string &key, const ValueWrapper &value) = 0;
 	virtual std::vector<std::string> loadPrefix(const std::string &prefix = "") = 0;
+	// Batched loads, backends override them to use a single round-trip
+	virtual std::vector<std::pair<std::string, ValueWrapper>> loadMany(const std::vector<std::string> &keys);
+	virtual std::vector<std::pair<std::string, ValueWrapper>> loadPrefixValues(const std::string &prefix);
 
 private:
 	void setLocked(const std::string &key, const ValueWrapper &value);
 	void processEvictions();
+	bool isPrefetchedLocked(const std::string &key) const;
 
 	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> store_;
 	std::list<std::string> lruQueue_;
 	std::mutex mutex_;
 	// Evicted entries pending persistence; accessed under mutex_
 	std::vector<std::pair<std::string, ValueWrapper>> pendingEvictions_;
+	// Prefixes whose stored values are all in store_, a miss under them needs no load; accessed under mutex_
+	phmap::flat_hash_set<std::string> prefetched_;
 };
 
+// Scoped handles prefetch their entity scope on first read: for "player.123.titles" that is
+// "player.123", so the first read of any player key loads all of that player's keys at once.
+// Handles created straight from the store ("player") only prefetch when read directly.
 class ScopedKV final : public KV {
 public:
-	ScopedKV(Logger &logger, KVStore &rootKV, std::string prefix) :
-		logger(logger), rootKV_(rootKV), prefix_(std::move(prefix)) { }
+	ScopedKV(Logger &logger, KVStore &rootKV, std::string prefix, std::string prefetchScope = "") :
+		logger(logger), rootKV_(rootKV), prefix_(std::move(prefix)), topLevel_(prefetchScope.empty()), prefetchScope_(topLevel_ ? prefix_ : std::move(prefetchScope)) { }
 
 	void set(const std::string &key, const std::initializer_list<ValueWrapper> &init_list) override {
 		rootKV_.set(buildKey(key), init_list);
@@ -150,9 +168,24 @@ public:
 	}
 
 	std::optional<ValueWrapper> get(const std::string &key, bool forceLoad = false) override {
+		prefetchOnce();
 		return rootKV_.get(buildKey(key), forceLoad);
 	}
 
+	std::vector<std::optional<ValueWrapper>> getMany(const std::vector<std::string> &keys) override {
+		prefetchOnce();
+		std::vector<std::string> scopedKeys;
+		scopedKeys.reserve(keys.size());
+		for (const auto &key : keys) {
+			scopedKeys.emplace_back(buildKey(key));
+		}
+		return rootKV_.getMany(scopedKeys);
+	}
+
+	void prefetch(const std::string &prefix) override {
+		rootKV_.prefetch(buildKey(prefix));
+	}
+
 	template <typename T>
 	T get(const std::string &key, bool forceLoad = false) {
 		const auto optValue = get(key, forceLoad);
@@ -168,10 +201,12 @@ public:
 
 	std::shared_ptr<KV> scoped(const std::string &scope) override {
 		logger.trace("ScopedKV::scoped({})", buildKey(scope));
-		return std::make_shared<ScopedKV>(logger, rootKV_, buildKey(scope));
+		const auto key = buildKey(scope);
+		return std::make_shared<ScopedKV>(logger, rootKV_, key, topLevel_ ? key : prefetchScope_);
 	}
 
 	std::unordered_set<std::string> keys(const std::string &prefix = "") override {
+		prefetchOnce();
 		return rootKV_.keys(buildKey(prefix));
 	}
 
@@ -180,9 +215,18 @@ private:
 		return fmt::format("{}.{}", prefix_, key);
 	}
 
+	void prefetchOnce() {
+		if (!prefetched_.exchange(true, std::memory_order_relaxed)) {
+			rootKV_.prefetch(prefetchScope_ + ".");
+		}
+	}
+
 	Logger &logger;
 	KVStore &rootKV_;
 	std::string prefix_;
+	bool topLevel_;
+	std::string prefetchScope_;
+	std::atomic_bool prefetched_ { false };
 };
 
 constexpr auto g_kv = KVStore::getInstance;
@@ -25,18 +25,61 @@ std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
 		return std::nullopt;
 	}
 
+	return readValue(result, key);
+}
+
+std::vector<std::pair<std::string, ValueWrapper>> KVSQL::loadMany(const std::vector<std::string> &keys) {
+	if (keys.empty()) {
+		return {};
+	}
+
+	std::string names;
+	for (const auto &key : keys) {
+		if (!names.empty()) {
+			names.push_back(',');
+		}
+		names += db.escapeString(key);
+	}
+	return loadValues(fmt::format("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` IN ({})", names));
+}
+
+std::vector<std::pair<std::string, ValueWrapper>> KVSQL::loadPrefixValues(const std::string &prefix) {
+	const auto query = fmt::format("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` LIKE {}", db.escapeString(prefix + "%"));
+	return loadValues(query, prefix);
+}
+
+std::vector<std::pair<std::string, ValueWrapper>> KVSQL::loadValues(const std::string &query, const std::string &prefix /* = ""*/) {
+	std::vector<std::pair<std::string, ValueWrapper>> values;
+	const auto result = db.storeQuery(query);
+	if (result == nullptr) {
+		return values;
+	}
+
+	do {
+		auto key = result->getString("key_name");
+		// LIKE treats '_' as a wildcard, so keys outside the prefix may match
+		if (!key.starts_with(prefix)) {
+			continue;
+		}
+		if (auto value = readValue(result, key)) {
+			values.emplace_back(std::move(key), std::move(*value));
+		}
+	} while (result->next());
+
+	return values;
+}
+
+std::optional<ValueWrapper> KVSQL::readValue(const DBResult_ptr &result, const std::string &key) const {
 	unsigned long size;
 	const auto data = result->getStream("value", size);
 	if (data == nullptr) {
 		return std::nullopt;
 	}
 
-	ValueWrapper valueWrapper;
 	const auto timestamp = result->getNumber<uint64_t>("timestamp");
 	Canary::protobuf::kv::ValueWrapper protoValue;
 	if (protoValue.ParseFromArray(data, static_cast<int>(size))) {
-		valueWrapper = ProtoSerializable::fromProto(protoValue, timestamp);
-		return valueWrapper;
+		return ProtoSerializable::fromProto(protoValue, timestamp);
 	}
 	logger.error("Failed to deserialize value for key {}", key);
 	return std::nullopt;
@@ -14,8 +14,11 @@
 class Database;
 class Logger;
 class DBInsert;
+class DBResult;
 class ValueWrapper;
 
+using DBResult_ptr = std::shared_ptr<DBResult>;
+
 class KVSQL final : public KVStore {
 public:
 	explicit KVSQL(Database &db, Logger &logger);
@@ -25,6 +28,10 @@ public:
 private:
 	std::vector<std::string> loadPrefix(const std::string &prefix = "") override;
 	std::optional<ValueWrapper> load(const std::string &key) override;
+	std::vector<std::pair<std::string, ValueWrapper>> loadMany(const std::vector<std::string> &keys) override;
+	std::vector<std::pair<std::string, ValueWrapper>> loadPrefixValues(const std::string &prefix) override;
+	std::vector<std::pair<std::string, ValueWrapper>> loadValues(const std::string &query, const std::string &prefix = "");
+	std::optional<ValueWrapper> readValue(const DBResult_ptr &result, const std::string &key) const;
 	bool save(const std::string &key, const ValueWrapper &value) override;
 	bool prepareSave(const std::string &key, const ValueWrapper &value, DBInsert &update) const;
 
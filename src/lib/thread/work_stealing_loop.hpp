@@ -0,0 +1,130 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#ifndef USE_PRECOMPILED_HEADERS
+	#include <algorithm>
+	#include <atomic>
+	#include <cstdint>
+	#include <vector>
+#endif
+
+/**
+ * @brief Parallel loop over [0, size) where idle workers steal from busy ones.
+ *
+ * Every worker owns a contiguous range of indexes, its begin and end packed in a
+ * single atomic word. The owner takes indexes from the front, and a worker whose
+ * range ran dry takes the back half of another worker's range. A few costly
+ * iterations therefore no longer stall the indexes statically assigned after them.
+ *
+ * Workers may join late or never: @ref wait returns once every index ran, and
+ * a worker arriving after that finds nothing left and returns without calling
+ * the body.
+ */
+class WorkStealingLoop {
+public:
+	WorkStealingLoop(size_t workers, size_t size) :
+		ranges(std::max<size_t>(workers, 1)), pending(size) {
+		const size_t count = ranges.size();
+		for (size_t i = 0; i < count; ++i) {
+			ranges[i].bounds.store(pack(size * i / count, size * (i + 1) / count), std::memory_order_relaxed);
+		}
+	}
+
+	// Ensures that we don't accidentally copy it
+	WorkStealingLoop(const WorkStealingLoop &) = delete;
+	WorkStealingLoop &operator=(const WorkStealingLoop &) = delete;
+
+	/**
+	 * @brief Runs the body for the indexes of the worker, then for stolen ones until none is left.
+	 */
+	template <typename F>
+	void run(size_t worker, F &&f) {
+		do {
+			uint32_t index;
+			while (pop(worker, index)) {
+				f(index);
+				if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					pending.notify_all();
+				}
+			}
+		} while (steal(worker));
+	}
+
+	/**
+	 * @brief Blocks until the body ran for every index.
+	 */
+	void wait() const {
+		for (auto left = pending.load(std::memory_order_acquire); left != 0; left = pending.load(std::memory_order_acquire)) {
+			pending.wait(left, std::memory_order_acquire);
+		}
+	}
+
+	size_t getWorkers() const {
+		return ranges.size();
+	}
+
+	size_t getSteals() const {
+		return steals.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct alignas(64) Range {
+		std::atomic<uint64_t> bounds { 0 };
+	};
+
+	static uint64_t pack(uint64_t begin, uint64_t end) {
+		return (end << 32) | begin;
+	}
+
+	bool pop(size_t worker, uint32_t &index) {
+		auto &bounds = ranges[worker].bounds;
+		auto current = bounds.load(std::memory_order_acquire);
+		for (;;) {
+			const auto begin = static_cast<uint32_t>(current);
+			const auto end = static_cast<uint32_t>(current >> 32);
+			if (begin >= end) {
+				return false;
+			}
+			if (bounds.compare_exchange_weak(current, pack(begin + 1, end), std::memory_order_acq_rel, std::memory_order_acquire)) {
+				index = begin;
+				return true;
+			}
+		}
+	}
+
+	// Only called with an empty own range, so no other thief writes to it meanwhile
+	bool steal(size_t thief) {
+		const size_t count = ranges.size();
+		for (size_t offset = 1; offset < count; ++offset) {
+			auto &bounds = ranges[(thief + offset) % count].bounds;
+			auto current = bounds.load(std::memory_order_acquire);
+			for (;;) {
+				const auto begin = static_cast<uint32_t>(current);
+				const auto end = static_cast<uint32_t>(current >> 32);
+				if (begin >= end) {
+					break;
+				}
+
+				const uint32_t split = end - (end - begin + 1) / 2;
+				if (bounds.compare_exchange_weak(current, pack(begin, split), std::memory_order_acq_rel, std::memory_order_acquire)) {
+					steals.fetch_add(1, std::memory_order_relaxed);
+					ranges[thief].bounds.store(pack(split, end), std::memory_order_release);
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	std::vector<Range> ranges;
+	std::atomic<size_t> pending;
+	std::atomic<size_t> steals = 0;
+};
@@ -168,7 +168,7 @@ std::shared_ptr<Tile> Map::getLoadedTile(uint16_t x, uint16_t y, uint8_t z) {
 		return nullptr;
 	}
 
-	const auto &floor = leaf->getFloor(z);
+	const auto floor = leaf->getFloor(z);
 	if (!floor) {
 		return nullptr;
 	}
@@ -192,7 +192,7 @@ std::shared_ptr<Tile> Map::getTile(uint16_t x, uint16_t y, uint8_t z) {
 		return nullptr;
 	}
 
-	const auto &floor = sector->getFloor(z);
+	const auto floor = sector->getFloor(z);
 	if (!floor) {
 		return nullptr;
 	}
@@ -219,11 +219,13 @@ void Map::setTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<Tile>
 		return;
 	}
 
-	if (const auto &sector = getMapSector(x, y)) {
-		sector->createFloor(z)->setTile(x, y, newTile);
-	} else {
-		getBestMapSector(x, y)->createFloor(z)->setTile(x, y, newTile);
+	auto sector = getMapSector(x, y);
+	if (!sector) {
+		sector = getBestMapSector(x, y);
 	}
+
+	sector->createFloor(z)->setTile(x, y, newTile);
+	sector->onTileChange();
 }
 
 bool Map::placeCreature(const Position &centerPos, const std::shared_ptr<Creature> &creature, bool extendedPos /* = false*/, bool forceLogin /* = false*/) {
@@ -335,7 +337,7 @@ bool Map::placeCreature(const Position &centerPos, const std::shared_ptr<Creatur
 		toCylinder->internalAddThing(creature);
 
 		const Position &dest = toCylinder->getPosition();
-		getMapSector(dest.x, dest.y)->addCreature(creature);
+		getMapSector(dest.x, dest.y)->addCreature(creature, dest);
 	}
 	return true;
 }
@@ -413,7 +415,9 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	// Switch the node ownership
 	if (old_sector != new_sector) {
 		old_sector->removeCreature(creature);
-		new_sector->addCreature(creature);
+		new_sector->addCreature(creature, newPos);
+	} else {
+		new_sector->moveCreature(creature, newPos);
 	}
 
 	// add the creature
@@ -513,8 +517,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 		while (--distanceX > 0) {
 			start.x += delta;
 
-			const auto &tile = getTile(start.x, start.y, start.z);
-			if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+			if (hasAnyTileBit(start.x, start.y, start.z, Floor::TILE_BLOCKS_PROJECTILE)) {
 				return false;
 			}
 		}
@@ -524,8 +527,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 		while (--distanceY > 0) {
 			start.y += delta;
 
-			const auto &tile = getTile(start.x, start.y, start.z);
-			if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+			if (hasAnyTileBit(start.x, start.y, start.z, Floor::TILE_BLOCKS_PROJECTILE)) {
 				return false;
 			}
 		}
@@ -557,8 +559,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 					xIncrease = deltaX;
 				}
 
-				const auto &tile = getTile(start.x + xIncrease, start.y + deltaY, start.z);
-				if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+				if (hasAnyTileBit(start.x + xIncrease, start.y + deltaY, start.z, Floor::TILE_BLOCKS_PROJECTILE)) {
 					if (Position::areInRange<1, 1>(start, destination)) {
 						return true;
 					}
@@ -588,8 +589,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 					yIncrease = deltaY;
 				}
 
-				const auto &tile = getTile(start.x + deltaX, start.y + yIncrease, start.z);
-				if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+				if (hasAnyTileBit(start.x + deltaX, start.y + yIncrease, start.z, Floor::TILE_BLOCKS_PROJECTILE)) {
 					if (Position::areInRange<1, 1>(start, destination)) {
 						return true;
 					}
@@ -654,6 +654,33 @@ bool Map::isSightClear(const Position &fromPos, const Position &toPos, bool floo
 	return true;
 }
 
+bool Map::hasAnyTileBit(uint16_t x, uint16_t y, uint8_t z, uint8_t bits) {
+	const auto sector = z < MAP_MAX_LAYERS ? getMapSector(x, y) : nullptr;
+	const auto floor = sector ? sector->getFloor(z) : nullptr;
+	if (!floor) {
+		return (bits & Floor::TILE_BLOCKS_PATH) != 0;
+	}
+
+	// The bits of a cached tile are known once it is built
+	if (floor->hasTileCache(x, y)) {
+		getOrCreateTileFromCache(floor, x, y);
+	}
+	return floor->hasAnyTileBit(x, y, bits);
+}
+
+uint8_t Map::getBlockingTileBits(const std::shared_ptr<Creature> &creature) {
+	// Only what Tile::queryAdd refuses to every such creature while pathfinding
+	if (!creature) {
+		return 0;
+	}
+
+	uint8_t bits = Floor::TILE_BLOCKS_PATH;
+	if (const auto &monster = creature->getMonster(); monster && !monster->isFamiliar()) {
+		bits |= Floor::TILE_PROTECTION_ZONE;
+	}
+	return bits;
+}
+
 std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature, const Position &pos) {
 	if (!creature || creature->isRemoved()) {
 		return nullptr;
@@ -669,7 +696,7 @@ std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature,
 	return tile;
 }
 
-bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Position &_targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+bool Map::searchPath(const std::shared_ptr<Creature> &creature, const Position &_targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, uint32_t &expandedNodes) {
 	static int_fast32_t allNeighbors[8][2] = {
 		{ -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 }
 	};
@@ -686,6 +713,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 	};
 
 	const bool withoutCreature = creature == nullptr;
+	const uint8_t blockingBits = getBlockingTileBits(creature);
 
 	Position pos = withoutCreature ? _targetPos : creature->getPosition();
 	Position endPos;
@@ -725,6 +753,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 		}
 
 		++cntDirs;
+		++expandedNodes;
 
 		uint_fast32_t dirCount;
 		int_fast32_t* neighbors;
@@ -770,6 +799,10 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 			if (neighborNode) {
 				extraCost = neighborNode->c;
 			} else {
+				if (blockingBits != 0 && hasAnyTileBit(pos.x, pos.y, pos.z, blockingBits)) {
+					continue;
+				}
+
 				const auto &tile = withoutCreature ? getTile(pos.x, pos.y, pos.z) : canWalkTo(creature, pos);
 				if (!tile) {
 					continue;
@@ -848,11 +881,164 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 	return true;
 }
 
+bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+	const Position &startPos = creature ? creature->getPosition() : targetPos;
+	const auto key = getPathKey(creature, startPos, pathCondition, fpp, false);
+	if (getCachedPath(creature, key, pathCondition, fpp, dirList)) {
+		return true;
+	}
+
+	const size_t prevSize = dirList.size();
+	uint32_t expandedNodes = 0;
+	const bool found = searchPath(creature, targetPos, dirList, pathCondition, fpp, expandedNodes);
+	pathCache.onSearch(expandedNodes);
+	if (found) {
+		pathCache.insert(key, { dirList.begin() + prevSize, dirList.end() }, fpp.fullPathSearch && !fpp.keepDistance);
+	}
+	return found;
+}
+
 bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
 	return getPathMatching(creature, creature->getPosition(), dirList, pathCondition, fpp);
 }
 
 bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+	const auto key = getPathKey(creature, creature->getPosition(), pathCondition, fpp, true);
+	if (getCachedPath(creature, key, pathCondition, fpp, dirList)) {
+		return true;
+	}
+
+	const size_t prevSize = dirList.size();
+	uint32_t expandedNodes = 0;
+	const bool found = searchPathCond(creature, targetPos, dirList, pathCondition, fpp, expandedNodes);
+	pathCache.onSearch(expandedNodes);
+	if (found) {
+		pathCache.insert(key, { dirList.begin() + prevSize, dirList.end() }, fpp.fullPathSearch && !fpp.keepDistance);
+	}
+	return found;
+}
+
+std::optional<Position> Map::getRouteWaypoint(const Position &fromPos, const Position &toPos, int32_t maxDistance) {
+	const auto route = routePlanner.findRoute(fromPos, toPos);
+	if (route.empty()) {
+		return std::nullopt;
+	}
+
+	// The farthest waypoint a bounded search can still reach
+	auto waypoint = route.begin();
+	for (auto it = std::next(waypoint); it != route.end(); ++it) {
+		if (Position::getDiagonalDistance(fromPos, *it) > maxDistance) {
+			break;
+		}
+		waypoint = it;
+	}
+	return *waypoint;
+}
+
+void Map::reportPathMetrics() {
+	pathCache.reportMetrics();
+	routePlanner.reportMetrics();
+}
+
+bool Map::isStaticWalkable(uint16_t x, uint16_t y, uint8_t z) {
+	const auto &tile = getTile(x, y, z);
+	return tile && tile->getGround() && !tile->hasFlag(TILESTATE_BLOCKSOLID | TILESTATE_IMMOVABLEBLOCKPATH | TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT);
+}
+
+uint32_t Map::getSectorTileVersion(uint16_t x, uint16_t y) const {
+	const auto sector = getMapSector(x, y);
+	return sector ? sector->getTileVersion() : 0;
+}
+
+PathCache::Key Map::getPathKey(const std::shared_ptr<Creature> &creature, const Position &startPos, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, bool bounded) {
+	uint32_t walkFlags = 0;
+	if (creature) {
+		if (creature->getPlayer()) {
+			walkFlags |= PathCache::WALK_PLAYER;
+		} else if (creature->getNpc()) {
+			walkFlags |= PathCache::WALK_NPC;
+		} else if (const auto &monster = creature->getMonster()) {
+			walkFlags |= PathCache::WALK_MONSTER;
+			if (monster->isSummon()) {
+				walkFlags |= PathCache::WALK_SUMMON;
+			}
+			if (monster->canPushItems()) {
+				walkFlags |= PathCache::WALK_PUSH_ITEMS;
+			}
+			if (monster->canPushCreatures()) {
+				walkFlags |= PathCache::WALK_PUSH_CREATURES;
+			}
+			if (monster->canWalkOnFieldType(COMBAT_FIREDAMAGE)) {
+				walkFlags |= PathCache::WALK_FIRE_FIELDS;
+			}
+			if (monster->canWalkOnFieldType(COMBAT_ENERGYDAMAGE)) {
+				walkFlags |= PathCache::WALK_ENERGY_FIELDS;
+			}
+			if (monster->canWalkOnFieldType(COMBAT_EARTHDAMAGE)) {
+				walkFlags |= PathCache::WALK_POISON_FIELDS;
+			}
+		}
+	}
+
+	uint32_t searchFlags = 0;
+	if (fpp.fullPathSearch) {
+		searchFlags |= PathCache::SEARCH_FULL_PATH;
+	}
+	if (fpp.clearSight) {
+		searchFlags |= PathCache::SEARCH_CLEAR_SIGHT;
+	}
+	if (fpp.allowDiagonal) {
+		searchFlags |= PathCache::SEARCH_ALLOW_DIAGONAL;
+	}
+	if (fpp.keepDistance) {
+		searchFlags |= PathCache::SEARCH_KEEP_DISTANCE;
+	}
+	if (bounded) {
+		searchFlags |= PathCache::SEARCH_BOUNDED;
+	}
+
+	return { startPos, pathCondition.getTargetPos(), walkFlags, searchFlags, fpp.maxSearchDist, fpp.minTargetDist, fpp.maxTargetDist };
+}
+
+bool Map::getCachedPath(const std::shared_ptr<Creature> &creature, const PathCache::Key &key, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, std::vector<Direction> &dirList) {
+	const auto hit = pathCache.find(key);
+	if (!hit) {
+		return false;
+	}
+
+	// The path was found from other tiles and creatures, check it still holds
+	const bool bounded = (key.searchFlags & PathCache::SEARCH_BOUNDED) != 0 && fpp.maxSearchDist != 0;
+	const auto positions = hit->getPositions();
+	for (const auto &pos : positions) {
+		if (bounded && (Position::getDistanceX(key.start, pos) > fpp.maxSearchDist || Position::getDistanceY(key.start, pos) > fpp.maxSearchDist)) {
+			pathCache.reject(key);
+			return false;
+		}
+
+		if (fpp.keepDistance && !pathCondition.isInRange(key.start, pos, fpp)) {
+			pathCache.reject(key);
+			return false;
+		}
+
+		if (creature ? !canWalkTo(creature, pos) : !getTile(pos.x, pos.y, pos.z)) {
+			pathCache.reject(key);
+			return false;
+		}
+	}
+
+	int32_t bestMatch = 0;
+	if (!pathCondition(key.start, positions.empty() ? key.start : positions.back(), fpp, bestMatch)) {
+		pathCache.reject(key);
+		return false;
+	}
+
+	pathCache.onHit();
+	const auto directions = hit->getDirections();
+	dirList.insert(dirList.end(), directions.begin(), directions.end());
+	return true;
+}
+
+bool Map::searchPathCond(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, uint32_t &expandedNodes) {
 	Position pos = creature->getPosition();
 	Position endPos;
 
@@ -876,6 +1062,7 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 	};
 
 	const Position startPos = pos;
+	const uint8_t blockingBits = getBlockingTileBits(creature);
 
 	const int_fast32_t sX = std::abs(targetPos.getX() - pos.getX());
 	const int_fast32_t sY = std::abs(targetPos.getY() - pos.getY());
@@ -905,6 +1092,7 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 		}
 
 		++cntDirs;
+		++expandedNodes;
 
 		uint_fast32_t dirCount;
 		int_fast32_t* neighbors;
@@ -957,6 +1145,10 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 			if (neighborNode) {
 				extraCost = neighborNode->c;
 			} else {
+				if (hasAnyTileBit(pos.x, pos.y, pos.z, blockingBits)) {
+					continue;
+				}
+
 				const auto &tile = Map::canWalkTo(creature, pos);
 				if (!tile) {
 					continue;
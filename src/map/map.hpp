@@ -10,6 +10,8 @@
 #pragma once
 
 #include "mapcache.hpp"
+#include "map/utils/path_cache.hpp"
+#include "map/utils/sector_route_planner.hpp"
 #include "map/town.hpp"
 #include "map/house/house.hpp"
 #include "creatures/monsters/spawns/spawn_monster.hpp"
@@ -130,6 +132,20 @@ public:
 		return getPathMatching(nullptr, startPos, dirList, pathCondition, fpp);
 	}
 
+	/**
+	 * Plans a route over the map sectors, for walks too long for getPathMatching
+	 *	\param fromPos Where the route starts
+	 *	\param toPos Where the route ends, on the same floor
+	 *	\param maxDistance How far from fromPos the waypoint may be
+	 *	\returns The farthest waypoint of the route within maxDistance, the first one when none is, or nullopt when there is no route
+	 */
+	std::optional<Position> getRouteWaypoint(const Position &fromPos, const Position &toPos, int32_t maxDistance);
+
+	/**
+	 * Reports the path cache and route planner counters to the metrics
+	 */
+	void reportPathMetrics();
+
 	std::map<std::string, Position> waypoints;
 
 	// Storage made by "loadFromXML" of houses, monsters and npcs for main map
@@ -153,6 +169,33 @@ private:
 	}
 	std::shared_ptr<Tile> getLoadedTile(uint16_t x, uint16_t y, uint8_t z);
 
+	bool searchPath(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, uint32_t &expandedNodes);
+	bool searchPathCond(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, uint32_t &expandedNodes);
+
+	/**
+	 * Tests the Floor::TileBits of a tile without dereferencing it
+	 */
+	bool hasAnyTileBit(uint16_t x, uint16_t y, uint8_t z, uint8_t bits);
+	/**
+	 * Floor::TileBits the creature never walks into during a path search
+	 */
+	static uint8_t getBlockingTileBits(const std::shared_ptr<Creature> &creature);
+
+	bool isStaticWalkable(uint16_t x, uint16_t y, uint8_t z);
+	uint32_t getSectorTileVersion(uint16_t x, uint16_t y) const;
+
+	static PathCache::Key getPathKey(const std::shared_ptr<Creature> &creature, const Position &startPos, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, bool bounded);
+	/**
+	 * Appends a cached path to dirList when its tiles are still walkable and it still ends where pathCondition matches
+	 */
+	bool getCachedPath(const std::shared_ptr<Creature> &creature, const PathCache::Key &key, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, std::vector<Direction> &dirList);
+
+	PathCache pathCache;
+	SectorRoutePlanner routePlanner {
+		[this](uint16_t x, uint16_t y, uint8_t z) { return isStaticWalkable(x, y, z); },
+		[this](uint16_t x, uint16_t y) { return getSectorTileVersion(x, y); }
+	};
+
 	std::filesystem::path path;
 	std::string monsterfile;
 	std::string housefile;
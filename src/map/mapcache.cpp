@@ -99,72 +99,65 @@ std::shared_ptr<Item> MapCache::createItem(const std::shared_ptr<BasicItem> &Bas
 	return item;
 }
 
-std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<Floor> &floor, uint16_t x, uint16_t y) {
-	const auto &cachedTile = floor->getTileCache(x, y);
-	const auto oldTile = floor->getTile(x, y);
-	if (!cachedTile) {
-		return oldTile;
+std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(Floor* floor, uint16_t x, uint16_t y) {
+	if (!floor->hasTileCache(x, y)) {
+		return floor->getTile(x, y);
 	}
 
-	std::unique_lock l(floor->getMutex());
+	return floor->createTileFromCache(x, y, [this, floor, x, y](const std::shared_ptr<BasicTile> &cachedTile, const std::shared_ptr<Tile> &oldTile) {
+		const uint8_t z = floor->getZ();
+		const auto map = static_cast<Map*>(this);
 
-	const uint8_t z = floor->getZ();
-	const auto map = static_cast<Map*>(this);
-
-	std::vector<std::shared_ptr<Creature>> oldCreatureList;
-	if (oldTile) {
-		if (CreatureVector* creatures = oldTile->getCreatures()) {
-			for (const auto &creature : *creatures) {
-				oldCreatureList.emplace_back(creature);
+		std::vector<std::shared_ptr<Creature>> oldCreatureList;
+		if (oldTile) {
+			if (CreatureVector* creatures = oldTile->getCreatures()) {
+				for (const auto &creature : *creatures) {
+					oldCreatureList.emplace_back(creature);
+				}
 			}
 		}
-	}
 
-	std::shared_ptr<Tile> tile = nullptr;
+		std::shared_ptr<Tile> tile = nullptr;
 
-	auto pos = Position(x, y, z);
+		auto pos = Position(x, y, z);
 
-	if (cachedTile->isHouse()) {
-		if (const auto &house = map->houses.getHouse(cachedTile->houseId)) {
-			tile = std::make_shared<HouseTile>(pos, house);
-			tile->safeCall([tile] {
-				tile->getHouse()->addTile(tile->static_self_cast<HouseTile>());
-			});
+		if (cachedTile->isHouse()) {
+			if (const auto &house = map->houses.getHouse(cachedTile->houseId)) {
+				tile = std::make_shared<HouseTile>(pos, house);
+				tile->safeCall([tile] {
+					tile->getHouse()->addTile(tile->static_self_cast<HouseTile>());
+				});
+			} else {
+				g_logger().error("[{}] house not found for houseId {}", std::source_location::current().function_name(), cachedTile->houseId);
+			}
+		} else if (cachedTile->isStatic) {
+			tile = std::make_shared<StaticTile>(pos);
 		} else {
-			g_logger().error("[{}] house not found for houseId {}", std::source_location::current().function_name(), cachedTile->houseId);
+			tile = std::make_shared<DynamicTile>(pos);
 		}
-	} else if (cachedTile->isStatic) {
-		tile = std::make_shared<StaticTile>(pos);
-	} else {
-		tile = std::make_shared<DynamicTile>(pos);
-	}
-
-	if (cachedTile->ground != nullptr) {
-		tile->internalAddThing(createItem(cachedTile->ground, pos));
-	}
-
-	for (const auto &BasicItemd : cachedTile->items) {
-		tile->internalAddThing(createItem(BasicItemd, pos));
-	}
 
-	tile->setFlag(static_cast<TileFlags_t>(cachedTile->flags));
-
-	tile->safeCall([tile, pos, movedOldCreatureList = std::move(oldCreatureList)]() {
-		for (const auto &creature : movedOldCreatureList) {
-			tile->internalAddThing(creature);
+		if (cachedTile->ground != nullptr) {
+			tile->internalAddThing(createItem(cachedTile->ground, pos));
 		}
 
-		for (const auto &zone : Zone::getZones(pos)) {
-			tile->addZone(zone);
+		for (const auto &BasicItemd : cachedTile->items) {
+			tile->internalAddThing(createItem(BasicItemd, pos));
 		}
-	});
 
-	floor->setTile(x, y, tile);
+		tile->setFlag(static_cast<TileFlags_t>(cachedTile->flags));
 
-	// Remove Tile from cache
-	floor->setTileCache(x, y, nullptr);
+		tile->safeCall([tile, pos, movedOldCreatureList = std::move(oldCreatureList)]() {
+			for (const auto &creature : movedOldCreatureList) {
+				tile->internalAddThing(creature);
+			}
+
+			for (const auto &zone : Zone::getZones(pos)) {
+				tile->addZone(zone);
+			}
+		});
 
-	return tile;
+		return tile;
+	});
 }
 
 void MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile) {
@@ -182,18 +175,21 @@ void MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared
 }
 
 std::shared_ptr<BasicItem> MapCache::tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref) const {
+	// Children are resolved first, since they are part of the parent hash
+	if (ref) {
+		for (auto &item : ref->items) {
+			item = tryReplaceItemFromCache(item);
+		}
+	}
 	return static_tryGetItemFromCache(ref);
 }
 
 MapSector* MapCache::createMapSector(const uint32_t x, const uint32_t y) {
-	const uint32_t index = x / SECTOR_SIZE | y / SECTOR_SIZE << 16;
-	const auto it = mapSectors.find(index);
-	if (it != mapSectors.end()) {
-		return &it->second;
+	const auto [sector, created] = mapSectors.getOrCreate(x, y);
+	if (created) {
+		MapSector::newSector = true;
 	}
-
-	MapSector::newSector = true;
-	return &mapSectors[index];
+	return sector;
 }
 
 MapSector* MapCache::getBestMapSector(uint32_t x, uint32_t y) {
@@ -287,7 +283,7 @@ bool BasicItem::unserializeItemNode(FileStream &stream, uint16_t x, uint16_t y,
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item.", x, y, z));
 		}
 
-		items.emplace_back(static_tryGetItemFromCache(item));
+		items.emplace_back(item);
 
 		if (!stream.endNode()) {
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
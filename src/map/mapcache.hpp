@@ -10,7 +10,7 @@
 #pragma once
 
 #include "items/items_definitions.hpp"
-#include "utils/mapsector.hpp"
+#include "utils/sector_grid.hpp"
 
 class Map;
 class Tile;
@@ -101,19 +101,17 @@ public:
 	 * \returns A pointer to that map sector.
 	 */
 	MapSector* getMapSector(const uint32_t x, const uint32_t y) {
-		const auto it = mapSectors.find(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
-		return it != mapSectors.end() ? &it->second : nullptr;
+		return mapSectors.get(x, y);
 	}
 
 	const MapSector* getMapSector(const uint32_t x, const uint32_t y) const {
-		const auto it = mapSectors.find(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
-		return it != mapSectors.end() ? &it->second : nullptr;
+		return mapSectors.get(x, y);
 	}
 
 protected:
-	std::shared_ptr<Tile> getOrCreateTileFromCache(const std::shared_ptr<Floor> &floor, uint16_t x, uint16_t y);
+	std::shared_ptr<Tile> getOrCreateTileFromCache(Floor* floor, uint16_t x, uint16_t y);
 
-	std::unordered_map<uint32_t, MapSector> mapSectors;
+	SectorGrid mapSectors;
 
 private:
 	void parseItemAttr(const std::shared_ptr<BasicItem> &BasicItem, const std::shared_ptr<Item> &item) const;
@@ -12,10 +12,94 @@
 #include "creatures/creature.hpp"
 #include "game/game.hpp"
 
-phmap::flat_hash_map<Position, SpectatorsCache> Spectators::spectatorsCache;
+struct SpectatorsArea {
+	CreaturePositionIndex::Range range;
+
+	// Corners of the sectors to scan
+	int32_t startX = 0;
+	int32_t startY = 0;
+	int32_t endX = 0;
+	int32_t endY = 0;
+};
+
+namespace {
+	// Positions cached per shard before the shard is dropped
+	constexpr size_t SPECTATORS_CACHE_SHARD_LIMIT = 4096;
+
+	struct SpectatorsCacheShard {
+		std::shared_mutex mutex;
+		phmap::flat_hash_map<Position, SpectatorsCache> positions;
+	};
+
+	std::array<SpectatorsCacheShard, 64> spectatorsCacheShards;
+
+	SpectatorsCacheShard &getCacheShard(const Position &centerPos) {
+		const auto sectorX = static_cast<uint32_t>(centerPos.x / SECTOR_SIZE);
+		const auto sectorY = static_cast<uint32_t>(centerPos.y / SECTOR_SIZE);
+		return spectatorsCacheShards[(sectorX * 31 + sectorY) % spectatorsCacheShards.size()];
+	}
+
+	SpectatorsArea getArea(const Position &centerPos, bool multifloor, uint8_t kinds, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+		uint8_t minRangeZ = centerPos.z;
+		uint8_t maxRangeZ = centerPos.z;
+
+		if (multifloor) {
+			if (centerPos.z > MAP_INIT_SURFACE_LAYER) {
+				minRangeZ = static_cast<uint8_t>(std::max<int8_t>(centerPos.z - MAP_LAYER_VIEW_LIMIT, 0u));
+				maxRangeZ = static_cast<uint8_t>(std::min<int8_t>(centerPos.z + MAP_LAYER_VIEW_LIMIT, MAP_MAX_LAYERS - 1));
+			} else if (centerPos.z == MAP_INIT_SURFACE_LAYER - 1) {
+				minRangeZ = 0;
+				maxRangeZ = (MAP_INIT_SURFACE_LAYER - 1) + MAP_LAYER_VIEW_LIMIT;
+			} else if (centerPos.z == MAP_INIT_SURFACE_LAYER) {
+				minRangeZ = 0;
+				maxRangeZ = MAP_INIT_SURFACE_LAYER + MAP_LAYER_VIEW_LIMIT;
+			} else {
+				minRangeZ = 0;
+				maxRangeZ = MAP_INIT_SURFACE_LAYER;
+			}
+		}
+
+		const int32_t min_y = centerPos.y + minRangeY;
+		const int32_t min_x = centerPos.x + minRangeX;
+		const int32_t max_y = centerPos.y + maxRangeY;
+		const int32_t max_x = centerPos.x + maxRangeX;
+
+		const int32_t minoffset = centerPos.getZ() - maxRangeZ;
+		const int32_t x1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, min_x + minoffset));
+		const int32_t y1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, min_y + minoffset));
+
+		const int32_t maxoffset = centerPos.getZ() - minRangeZ;
+		const int32_t x2 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, max_x + maxoffset));
+		const int32_t y2 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, max_y + maxoffset));
+
+		SpectatorsArea area;
+		area.range.minX = min_x;
+		area.range.minY = min_y;
+		area.range.width = static_cast<uint32_t>(max_x - min_x);
+		area.range.height = static_cast<uint32_t>(max_y - min_y);
+		area.range.minZ = minRangeZ;
+		area.range.depth = static_cast<uint32_t>(maxRangeZ - minRangeZ);
+		area.range.centerZ = centerPos.z;
+		area.range.kinds = kinds;
+		area.startX = x1 - (x1 & SECTOR_MASK);
+		area.startY = y1 - (y1 & SECTOR_MASK);
+		area.endX = x2 - (x2 & SECTOR_MASK);
+		area.endY = y2 - (y2 & SECTOR_MASK);
+		return area;
+	}
+
+	bool matches(const SpectatorsCache::Entry &entry, const SpectatorsArea &area, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+		return entry.kinds == area.range.kinds && entry.multifloor == multifloor
+			&& entry.minRangeX == minRangeX && entry.maxRangeX == maxRangeX
+			&& entry.minRangeY == minRangeY && entry.maxRangeY == maxRangeY;
+	}
+}
 
 void Spectators::clearCache() {
-	spectatorsCache.clear();
+	for (auto &shard : spectatorsCacheShards) {
+		std::unique_lock lock(shard.mutex);
+		shard.positions.clear();
+	}
 }
 
 Spectators Spectators::insert(const std::shared_ptr<Creature> &creature) {
@@ -31,118 +115,49 @@ Spectators Spectators::insertAll(const CreatureVector &list) {
 
 		creatures.insert(creatures.end(), list.begin(), list.end());
 
-		// Remove duplicate
+		// Remove duplicates, keeping the first occurrence of each creature where it was inserted:
+		// this order is the order of packets and events, so it must not follow the allocator
 		if (hasValue) {
-			std::unordered_set uset(creatures.begin(), creatures.end());
-			creatures.clear();
-			creatures.insert(creatures.end(), uset.begin(), uset.end());
-		}
-	}
-	return *this;
-}
-
-bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
-	const auto &list = multifloor || !specData.floor ? specData.multiFloor : specData.floor;
-
-	if (!list) {
-		return false;
-	}
+			// [const Creature* = creature, size_t = index of the entry]
+			std::vector<std::pair<const Creature*, size_t>> entries;
+			entries.reserve(creatures.size());
+			for (size_t i = 0; i < creatures.size(); ++i) {
+				entries.emplace_back(creatures[i].get(), i);
+			}
+			std::ranges::sort(entries);
 
-	if (!multifloor && !specData.floor) {
-		// Force check the distance of creatures as we only need to pick up creatures from the Floor(centerPos.z)
-		checkDistance = true;
-	}
+			std::vector<bool> duplicates(creatures.size());
+			for (size_t i = 1; i < entries.size(); ++i) {
+				if (entries[i].first == entries[i - 1].first) {
+					duplicates[entries[i].second] = true;
+				}
+			}
 
-	if (checkDistance) {
-		CreatureVector spectators;
-		spectators.reserve(creatures.size());
-		for (const auto &creature : *list) {
-			const auto &specPos = creature->getPosition();
-			if ((centerPos.x - specPos.x >= minRangeX
-			     && centerPos.y - specPos.y >= minRangeY
-			     && centerPos.x - specPos.x <= maxRangeX
-			     && centerPos.y - specPos.y <= maxRangeY
-			     && (multifloor || specPos.z == centerPos.z)
-			     && ((onlyPlayers && creature->getPlayer())
-			         || (onlyMonsters && creature->getMonster())
-			         || (onlyNpcs && creature->getNpc())))
-			    || (!onlyPlayers && !onlyMonsters && !onlyNpcs)) {
-				spectators.emplace_back(creature);
+			size_t kept = 0;
+			for (size_t i = 0; i < creatures.size(); ++i) {
+				if (duplicates[i]) {
+					continue;
+				}
+				if (kept != i) {
+					creatures[kept] = std::move(creatures[i]);
+				}
+				++kept;
 			}
+			creatures.resize(kept);
 		}
-		insertAll(spectators);
-	} else {
-		insertAll(*list);
 	}
-
-	return true;
+	return *this;
 }
 
-CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
-	uint8_t minRangeZ = centerPos.z;
-	uint8_t maxRangeZ = centerPos.z;
-
-	if (multifloor) {
-		if (centerPos.z > MAP_INIT_SURFACE_LAYER) {
-			minRangeZ = static_cast<uint8_t>(std::max<int8_t>(centerPos.z - MAP_LAYER_VIEW_LIMIT, 0u));
-			maxRangeZ = static_cast<uint8_t>(std::min<int8_t>(centerPos.z + MAP_LAYER_VIEW_LIMIT, MAP_MAX_LAYERS - 1));
-		} else if (centerPos.z == MAP_INIT_SURFACE_LAYER - 1) {
-			minRangeZ = 0;
-			maxRangeZ = (MAP_INIT_SURFACE_LAYER - 1) + MAP_LAYER_VIEW_LIMIT;
-		} else if (centerPos.z == MAP_INIT_SURFACE_LAYER) {
-			minRangeZ = 0;
-			maxRangeZ = MAP_INIT_SURFACE_LAYER + MAP_LAYER_VIEW_LIMIT;
-		} else {
-			minRangeZ = 0;
-			maxRangeZ = MAP_INIT_SURFACE_LAYER;
-		}
-	}
-
-	const int32_t min_y = centerPos.y + minRangeY;
-	const int32_t min_x = centerPos.x + minRangeX;
-	const int32_t max_y = centerPos.y + maxRangeY;
-	const int32_t max_x = centerPos.x + maxRangeX;
-
-	const auto width = static_cast<uint32_t>(max_x - min_x);
-	const auto height = static_cast<uint32_t>(max_y - min_y);
-	const auto depth = static_cast<uint32_t>(maxRangeZ - minRangeZ);
-
-	const int32_t minoffset = centerPos.getZ() - maxRangeZ;
-	const int32_t x1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, min_x + minoffset));
-	const int32_t y1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, min_y + minoffset));
-
-	const int32_t maxoffset = centerPos.getZ() - minRangeZ;
-	const int32_t x2 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, max_x + maxoffset));
-	const int32_t y2 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, max_y + maxoffset));
-
-	const int32_t startx1 = x1 - (x1 & SECTOR_MASK);
-	const int32_t starty1 = y1 - (y1 & SECTOR_MASK);
-	const int32_t endx2 = x2 - (x2 & SECTOR_MASK);
-	const int32_t endy2 = y2 - (y2 & SECTOR_MASK);
-
-	CreatureVector spectators;
-	spectators.reserve(std::max<uint8_t>(MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_Y) * 2);
-
-	const MapSector* startSector = g_game().map.getMapSector(startx1, starty1);
+template <typename F>
+void Spectators::forEachSector(const SpectatorsArea &area, F &&f) {
+	const MapSector* startSector = g_game().map.getMapSector(area.startX, area.startY);
 	const MapSector* sectorS = startSector;
-	for (int32_t ny = starty1; ny <= endy2; ny += SECTOR_SIZE) {
+	for (int32_t ny = area.startY; ny <= area.endY; ny += SECTOR_SIZE) {
 		const MapSector* sectorE = sectorS;
-		for (int32_t nx = startx1; nx <= endx2; nx += SECTOR_SIZE) {
+		for (int32_t nx = area.startX; nx <= area.endX; nx += SECTOR_SIZE) {
 			if (sectorE) {
-				const auto &nodeList = onlyPlayers ? sectorE->player_list
-					: onlyMonsters                 ? sectorE->monster_list
-					: onlyNpcs                     ? sectorE->npc_list
-												   : sectorE->creature_list;
-
-				for (const auto &creature : nodeList) {
-					const auto &cpos = creature->getPosition();
-					if (static_cast<uint32_t>(static_cast<int32_t>(cpos.z) - minRangeZ) <= depth) {
-						const int_fast16_t offsetZ = Position::getOffsetZ(centerPos, cpos);
-						if (static_cast<uint32_t>(cpos.x - offsetZ - min_x) <= width && static_cast<uint32_t>(cpos.y - offsetZ - min_y) <= height) {
-							spectators.emplace_back(creature);
-						}
-					}
-				}
+				f(*sectorE);
 				sectorE = sectorE->sectorE;
 			} else {
 				sectorE = g_game().map.getMapSector(nx + SECTOR_SIZE, ny);
@@ -152,82 +167,94 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 		if (sectorS) {
 			sectorS = sectorS->sectorS;
 		} else {
-			sectorS = g_game().map.getMapSector(startx1, ny + SECTOR_SIZE);
+			sectorS = g_game().map.getMapSector(area.startX, ny + SECTOR_SIZE);
 		}
 	}
+}
+
+CreatureVector Spectators::getSpectators(const SpectatorsArea &area) {
+	CreatureVector spectators;
+	spectators.reserve(std::max<uint8_t>(MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_Y) * 2);
+
+	forEachSector(area, [&area, &spectators](const MapSector &sector) {
+		const auto &creatureList = sector.creature_list;
+		sector.creaturePositions.forEachInRange(area.range, [&spectators, &creatureList](size_t index) {
+			spectators.emplace_back(creatureList[index]);
+		});
+	});
 
 	return spectators;
 }
 
+uint64_t Spectators::getSectorsVersion(const SpectatorsArea &area) {
+	// Versions only grow, so the sum changes whenever one of them does
+	uint64_t version = 0;
+	forEachSector(area, [&version](const MapSector &sector) {
+		version += sector.getCreatureVersion();
+	});
+	return version;
+}
+
 Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, bool useCache) {
 	minRangeX = (minRangeX == 0 ? -MAP_MAX_VIEW_PORT_X : -minRangeX);
 	maxRangeX = (maxRangeX == 0 ? MAP_MAX_VIEW_PORT_X : maxRangeX);
 	minRangeY = (minRangeY == 0 ? -MAP_MAX_VIEW_PORT_Y : -minRangeY);
 	maxRangeY = (maxRangeY == 0 ? MAP_MAX_VIEW_PORT_Y : maxRangeY);
 
+	const uint8_t kinds = onlyPlayers ? CreaturePositionIndex::KIND_PLAYER
+		: onlyMonsters                ? CreaturePositionIndex::KIND_MONSTER
+		: onlyNpcs                    ? CreaturePositionIndex::KIND_NPC
+									  : CreaturePositionIndex::KIND_ALL;
+	const auto area = getArea(centerPos, multifloor, kinds, minRangeX, maxRangeX, minRangeY, maxRangeY);
+
 	if (!useCache) {
-		insertAll(getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY));
+		insertAll(getSpectators(area));
 		return *this;
 	}
 
-	const auto &it = spectatorsCache.find(centerPos);
-	const bool cacheFound = it != spectatorsCache.end();
-	if (cacheFound) {
-		auto &cache = it->second;
-		if (minRangeX < cache.minRangeX || maxRangeX > cache.maxRangeX || minRangeY < cache.minRangeY || maxRangeY > cache.maxRangeY) {
-			// recache with new range
-			cache.minRangeX = minRangeX = std::min<int32_t>(minRangeX, cache.minRangeX);
-			cache.minRangeY = minRangeY = std::min<int32_t>(minRangeY, cache.minRangeY);
-			cache.maxRangeX = maxRangeX = std::max<int32_t>(maxRangeX, cache.maxRangeX);
-			cache.maxRangeY = maxRangeY = std::max<int32_t>(maxRangeY, cache.maxRangeY);
-		} else {
-			const bool checkDistance = minRangeX != cache.minRangeX || maxRangeX != cache.maxRangeX || minRangeY != cache.minRangeY || maxRangeY != cache.maxRangeY;
-
-			if (onlyPlayers || onlyMonsters || onlyNpcs) {
-				static const SpectatorsCache::FloorData EMPTY_FLOOR_DATA;
-
-				const auto &creaturesCache = onlyPlayers ? cache.players
-					: onlyMonsters                       ? cache.monsters
-					: onlyNpcs                           ? cache.npcs
-														 : EMPTY_FLOOR_DATA;
-
-				// check players/monsters/npcs cache
-				if (checkCache(creaturesCache, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
+	// Read before scanning, so a change made meanwhile leaves the entry stale
+	const uint64_t sectorsVersion = getSectorsVersion(area);
+	auto &shard = getCacheShard(centerPos);
+	{
+		std::shared_lock lock(shard.mutex);
+		if (const auto it = shard.positions.find(centerPos); it != shard.positions.end()) {
+			for (const auto &entry : it->second.entries) {
+				if (entry.sectorsVersion == sectorsVersion && matches(entry, area, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
+					insertAll(entry.creatures);
 					return *this;
 				}
-
-				// if there is no players/monsters/npcs cache, look for players/monsters/npcs in the creatures cache.
-				if (checkCache(cache.creatures, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, true, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-					return *this;
-				}
-				// All Creatures
-			} else if (checkCache(cache.creatures, false, false, false, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-				return *this;
 			}
 		}
 	}
 
-	const auto &spectators = getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY);
+	auto spectators = getSpectators(area);
 
 	// It is necessary to create the cache even if no spectators is found, so that there is no future query.
-	auto &cache = cacheFound ? it->second : spectatorsCache.emplace(centerPos, SpectatorsCache { .minRangeX = minRangeX, .maxRangeX = maxRangeX, .minRangeY = minRangeY, .maxRangeY = maxRangeY, .creatures = {}, .monsters = {}, .npcs = {}, .players = {} }).first->second;
-	auto &creaturesCache = onlyPlayers ? cache.players
-		: onlyMonsters                 ? cache.monsters
-		: onlyNpcs                     ? cache.npcs
-									   : cache.creatures;
-	auto &creatureList = (multifloor ? creaturesCache.multiFloor : creaturesCache.floor);
-	if (creatureList) {
-		creatureList->clear();
-	} else {
-		creatureList.emplace();
-	}
-
-	if (!spectators.empty()) {
-		insertAll(spectators);
+	{
+		std::unique_lock lock(shard.mutex);
+		if (shard.positions.size() >= SPECTATORS_CACHE_SHARD_LIMIT && !shard.positions.contains(centerPos)) {
+			shard.positions.clear();
+		}
 
-		creatureList->insert(creatureList->end(), spectators.begin(), spectators.end());
+		auto &entries = shard.positions[centerPos].entries;
+		auto entryIt = std::ranges::find_if(entries, [&](const SpectatorsCache::Entry &entry) {
+			return matches(entry, area, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY);
+		});
+		if (entryIt == entries.end()) {
+			auto &entry = entries.emplace_back();
+			entry.minRangeX = minRangeX;
+			entry.maxRangeX = maxRangeX;
+			entry.minRangeY = minRangeY;
+			entry.maxRangeY = maxRangeY;
+			entry.kinds = kinds;
+			entry.multifloor = multifloor;
+			entryIt = std::prev(entries.end());
+		}
+		entryIt->sectorsVersion = sectorsVersion;
+		entryIt->creatures = spectators;
 	}
 
+	insertAll(spectators);
 	return *this;
 }
 
@@ -18,25 +18,40 @@ struct Position;
 // Forward declaration para CreatureVector
 using CreatureVector = std::vector<std::shared_ptr<Creature>>;
 
+struct SpectatorsArea;
+
+/**
+ * @brief The cached results of the spectator queries centered on one position.
+ */
 struct SpectatorsCache {
-	struct FloorData {
-		std::optional<CreatureVector> floor;
-		std::optional<CreatureVector> multiFloor;
+	struct Entry {
+		int32_t minRangeX { 0 };
+		int32_t maxRangeX { 0 };
+		int32_t minRangeY { 0 };
+		int32_t maxRangeY { 0 };
+		uint8_t kinds { 0 };
+		bool multifloor { false };
+
+		// Sum of the creature versions of the sectors the query covered
+		uint64_t sectorsVersion { 0 };
+		CreatureVector creatures;
 	};
 
-	int32_t minRangeX { 0 };
-	int32_t maxRangeX { 0 };
-	int32_t minRangeY { 0 };
-	int32_t maxRangeY { 0 };
-
-	FloorData creatures;
-	FloorData monsters;
-	FloorData npcs;
-	FloorData players;
+	std::vector<Entry> entries;
 };
 
+/**
+ * @brief Spectator queries over the creatures of the map sectors.
+ *
+ * Results are cached by center position in shards that can be read from the
+ * parallel task groups. An entry stays valid until a creature enters, leaves
+ * or moves inside one of the sectors its query covered.
+ */
 class Spectators {
 public:
+	/**
+	 * @brief Drops every cached result. Entries are checked against the sector versions, so this is only needed to release memory.
+	 */
 	static void clearCache();
 
 	template <typename T>
@@ -95,14 +110,15 @@ public:
 	}
 
 private:
-	static phmap::flat_hash_map<Position, SpectatorsCache> spectatorsCache;
-
 	Spectators find(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0, bool useCache = true);
-	CreatureVector getSpectators(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
 
-	Spectators filter(bool onlyPlayers, bool onlyMonsters, bool onlyNpcs) const;
+	static CreatureVector getSpectators(const SpectatorsArea &area);
+	static uint64_t getSectorsVersion(const SpectatorsArea &area);
 
-	bool checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
+	template <typename F>
+	static void forEachSector(const SpectatorsArea &area, F &&f);
+
+	Spectators filter(bool onlyPlayers, bool onlyMonsters, bool onlyNpcs) const;
 
 	CreatureVector creatures;
 };
@@ -12,6 +12,107 @@
 #include "creatures/combat/combat.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "items/tile.hpp"
+#include "utils/cpu_features.hpp"
+
+namespace {
+#if defined(SIMD_RUNTIME_DISPATCH) && defined(__SSE2__)
+	// Branchless best node search over calculatedNodes, where closed and unused nodes cost
+	// int32 max. Every kernel reads whole vectors past curNode, which MAX_NODES is a multiple of.
+
+	SIMD_TARGET("sse2") int32_t getBestNodeSSE2(const int32_t* calculatedNodes, int32_t curNode) {
+		auto _mm_sse2_min_epi32 = [](const __m128i a, const __m128i b) {
+			__m128i mask = _mm_cmpgt_epi32(a, b);
+			return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+		};
+
+		auto _mm_sse2_blendv_epi8 = [](const __m128i a, const __m128i b, __m128i mask) {
+			mask = _mm_cmplt_epi8(mask, _mm_setzero_si128());
+			return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));
+		};
+
+		const __m128i increment = _mm_set1_epi32(4);
+		__m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+		__m128i minindices = indices;
+		__m128i minvalues = _mm_load_si128(reinterpret_cast<const __m128i*>(calculatedNodes));
+		for (int32_t pos = 4; pos < curNode; pos += 4) {
+			const __m128i values = _mm_load_si128(reinterpret_cast<const __m128i*>(&calculatedNodes[pos]));
+			indices = _mm_add_epi32(indices, increment);
+			minindices = _mm_sse2_blendv_epi8(minindices, indices, _mm_cmplt_epi32(values, minvalues));
+			minvalues = _mm_sse2_min_epi32(values, minvalues);
+		}
+
+		__m128i res = _mm_sse2_min_epi32(minvalues, _mm_shuffle_epi32(minvalues, _MM_SHUFFLE(2, 3, 0, 1))); // Calculate horizontal minimum
+		res = _mm_sse2_min_epi32(res, _mm_shuffle_epi32(res, _MM_SHUFFLE(0, 1, 2, 3))); // Calculate horizontal minimum
+
+		alignas(16) int32_t indices_array[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(indices_array), minindices);
+
+		return indices_array[(mm_ctz(_mm_movemask_epi8(_mm_cmpeq_epi32(minvalues, res))) >> 2)];
+	}
+
+	SIMD_TARGET("avx2") int32_t getBestNodeAVX2(const int32_t* calculatedNodes, int32_t curNode) {
+		const __m256i increment = _mm256_set1_epi32(8);
+		__m256i indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		__m256i minindices = indices;
+		__m256i minvalues = _mm256_load_si256(reinterpret_cast<const __m256i*>(calculatedNodes));
+		for (int32_t pos = 8; pos < curNode; pos += 8) {
+			const __m256i values = _mm256_load_si256(reinterpret_cast<const __m256i*>(&calculatedNodes[pos]));
+			indices = _mm256_add_epi32(indices, increment);
+			minindices = _mm256_blendv_epi8(minindices, indices, _mm256_cmpgt_epi32(minvalues, values));
+			minvalues = _mm256_min_epi32(values, minvalues);
+		}
+
+		__m256i res = _mm256_min_epi32(minvalues, _mm256_shuffle_epi32(minvalues, _MM_SHUFFLE(2, 3, 0, 1))); // Calculate horizontal minimum
+		res = _mm256_min_epi32(res, _mm256_shuffle_epi32(res, _MM_SHUFFLE(0, 1, 2, 3))); // Calculate horizontal minimum
+		res = _mm256_min_epi32(res, _mm256_permutevar8x32_epi32(res, _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7))); // Calculate horizontal minimum
+
+		alignas(32) int32_t indices_array[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(indices_array), minindices);
+
+		return indices_array[(mm_ctz(_mm256_movemask_epi8(_mm256_cmpeq_epi32(minvalues, res))) >> 2)];
+	}
+
+	SIMD_TARGET("avx512f") int32_t getBestNodeAVX512(const int32_t* calculatedNodes, int32_t curNode) {
+		const __m512i increment = _mm512_set1_epi32(16);
+		__m512i indices = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		__m512i minindices = indices;
+		__m512i minvalues = _mm512_load_si512(reinterpret_cast<const void*>(calculatedNodes));
+		for (int32_t pos = 16; pos < curNode; pos += 16) {
+			const __m512i values = _mm512_load_si512(reinterpret_cast<const void*>(&calculatedNodes[pos]));
+			indices = _mm512_add_epi32(indices, increment);
+			minindices = _mm512_mask_blend_epi32(_mm512_cmplt_epi32_mask(values, minvalues), minindices, indices);
+			minvalues = _mm512_min_epi32(minvalues, values);
+		}
+
+		alignas(64) int32_t values_array[16];
+		alignas(64) int32_t indices_array[16];
+		_mm512_store_si512(reinterpret_cast<void*>(values_array), minvalues);
+		_mm512_store_si512(reinterpret_cast<void*>(indices_array), minindices);
+
+		int32_t best_node = indices_array[0];
+		int32_t best_node_f = values_array[0];
+		for (int32_t i = 1; i < 16; ++i) {
+			int32_t total_cost = values_array[i];
+			best_node = (total_cost < best_node_f ? indices_array[i] : best_node);
+			best_node_f = (total_cost < best_node_f ? total_cost : best_node_f);
+		}
+		return best_node;
+	}
+
+	using BestNodeKernel = int32_t (*)(const int32_t*, int32_t);
+
+	BestNodeKernel selectBestNodeKernel(SimdLevel level) {
+		switch (level) {
+			case SimdLevel::AVX512:
+				return getBestNodeAVX512;
+			case SimdLevel::AVX2:
+				return getBestNodeAVX2;
+			default:
+				return getBestNodeSSE2;
+		}
+	}
+#endif
+}
 
 AStarNodes::AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost) :
 #if defined(__AVX2__) || defined(__SSE2__)
@@ -89,102 +190,9 @@ bool AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_f
 }
 
 AStarNode* AStarNodes::getBestNode() {
-// Branchless best node search
-#if defined(__AVX512F__)
-	const __m512i increment = _mm512_set1_epi32(16);
-	__m512i indices = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
-	__m512i minindices = indices;
-	__m512i minvalues = _mm512_load_si512(reinterpret_cast<const void*>(calculatedNodes));
-	for (int32_t pos = 16; pos < curNode; pos += 16) {
-		const __m512i values = _mm512_load_si512(reinterpret_cast<const void*>(&calculatedNodes[pos]));
-		indices = _mm512_add_epi32(indices, increment);
-		minindices = _mm512_mask_blend_epi32(_mm512_cmplt_epi32_mask(values, minvalues), minindices, indices);
-		minvalues = _mm512_min_epi32(minvalues, values);
-	}
-
-	alignas(64) int32_t values_array[16];
-	alignas(64) int32_t indices_array[16];
-	_mm512_store_si512(reinterpret_cast<void*>(values_array), minvalues);
-	_mm512_store_si512(reinterpret_cast<void*>(indices_array), minindices);
-
-	int32_t best_node = indices_array[0];
-	int32_t best_node_f = values_array[0];
-	for (int32_t i = 1; i < 16; ++i) {
-		int32_t total_cost = values_array[i];
-		best_node = (total_cost < best_node_f ? indices_array[i] : best_node);
-		best_node_f = (total_cost < best_node_f ? total_cost : best_node_f);
-	}
-	return (openNodes[best_node] ? &nodes[best_node] : nullptr);
-#elif defined(__AVX2__)
-	const __m256i increment = _mm256_set1_epi32(8);
-	__m256i indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
-	__m256i minindices = indices;
-	__m256i minvalues = _mm256_load_si256(reinterpret_cast<const __m256i*>(calculatedNodes));
-	for (int32_t pos = 8; pos < curNode; pos += 8) {
-		const __m256i values = _mm256_load_si256(reinterpret_cast<const __m256i*>(&calculatedNodes[pos]));
-		indices = _mm256_add_epi32(indices, increment);
-		minindices = _mm256_blendv_epi8(minindices, indices, _mm256_cmpgt_epi32(minvalues, values));
-		minvalues = _mm256_min_epi32(values, minvalues);
-	}
-
-	__m256i res = _mm256_min_epi32(minvalues, _mm256_shuffle_epi32(minvalues, _MM_SHUFFLE(2, 3, 0, 1))); // Calculate horizontal minimum
-	res = _mm256_min_epi32(res, _mm256_shuffle_epi32(res, _MM_SHUFFLE(0, 1, 2, 3))); // Calculate horizontal minimum
-	res = _mm256_min_epi32(res, _mm256_permutevar8x32_epi32(res, _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7))); // Calculate horizontal minimum
-
-	alignas(32) int32_t indices_array[8];
-	_mm256_store_si256(reinterpret_cast<__m256i*>(indices_array), minindices);
-
-	int32_t best_node = indices_array[(mm_ctz(_mm256_movemask_epi8(_mm256_cmpeq_epi32(minvalues, res))) >> 2)];
-	return (openNodes[best_node] ? &nodes[best_node] : nullptr);
-#elif defined(__SSE4_1__)
-	const __m128i increment = _mm_set1_epi32(4);
-	__m128i indices = _mm_setr_epi32(0, 1, 2, 3);
-	__m128i minindices = indices;
-	__m128i minvalues = _mm_load_si128(reinterpret_cast<const __m128i*>(calculatedNodes));
-	for (int32_t pos = 4; pos < curNode; pos += 4) {
-		const __m128i values = _mm_load_si128(reinterpret_cast<const __m128i*>(&calculatedNodes[pos]));
-		indices = _mm_add_epi32(indices, increment);
-		minindices = _mm_blendv_epi8(minindices, indices, _mm_cmplt_epi32(values, minvalues));
-		minvalues = _mm_min_epi32(values, minvalues);
-	}
-
-	__m128i res = _mm_min_epi32(minvalues, _mm_shuffle_epi32(minvalues, _MM_SHUFFLE(2, 3, 0, 1))); // Calculate horizontal minimum
-	res = _mm_min_epi32(res, _mm_shuffle_epi32(res, _MM_SHUFFLE(0, 1, 2, 3))); // Calculate horizontal minimum
-
-	alignas(16) int32_t indices_array[4];
-	_mm_store_si128(reinterpret_cast<__m128i*>(indices_array), minindices);
-
-	int32_t best_node = indices_array[(mm_ctz(_mm_movemask_epi8(_mm_cmpeq_epi32(minvalues, res))) >> 2)];
-	return (openNodes[best_node] ? &nodes[best_node] : NULL);
-#elif defined(__SSE2__)
-	auto _mm_sse2_min_epi32 = [](const __m128i a, const __m128i b) {
-		__m128i mask = _mm_cmpgt_epi32(a, b);
-		return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
-	};
-
-	auto _mm_sse2_blendv_epi8 = [](const __m128i a, const __m128i b, __m128i mask) {
-		mask = _mm_cmplt_epi8(mask, _mm_setzero_si128());
-		return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));
-	};
-
-	const __m128i increment = _mm_set1_epi32(4);
-	__m128i indices = _mm_setr_epi32(0, 1, 2, 3);
-	__m128i minindices = indices;
-	__m128i minvalues = _mm_load_si128(reinterpret_cast<const __m128i*>(calculatedNodes));
-	for (int32_t pos = 4; pos < curNode; pos += 4) {
-		const __m128i values = _mm_load_si128(reinterpret_cast<const __m128i*>(&calculatedNodes[pos]));
-		indices = _mm_add_epi32(indices, increment);
-		minindices = _mm_sse2_blendv_epi8(minindices, indices, _mm_cmplt_epi32(values, minvalues));
-		minvalues = _mm_sse2_min_epi32(values, minvalues);
-	}
-
-	__m128i res = _mm_sse2_min_epi32(minvalues, _mm_shuffle_epi32(minvalues, _MM_SHUFFLE(2, 3, 0, 1))); // Calculate horizontal minimum
-	res = _mm_sse2_min_epi32(res, _mm_shuffle_epi32(res, _MM_SHUFFLE(0, 1, 2, 3))); // Calculate horizontal minimum
-
-	alignas(16) int32_t indices_array[4];
-	_mm_store_si128(reinterpret_cast<__m128i*>(indices_array), minindices);
-
-	int32_t best_node = indices_array[(mm_ctz(_mm_movemask_epi8(_mm_cmpeq_epi32(minvalues, res))) >> 2)];
+#if defined(SIMD_RUNTIME_DISPATCH) && defined(__SSE2__)
+	static const auto getBestNodeIndex = selectBestNodeKernel(getSimdLevel());
+	const int32_t best_node = getBestNodeIndex(calculatedNodes, curNode);
 	return (openNodes[best_node] ? &nodes[best_node] : nullptr);
 #else
 	int32_t best_node_f = std::numeric_limits<int32_t>::max();
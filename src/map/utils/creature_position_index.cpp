@@ -0,0 +1,159 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/creature_position_index.hpp"
+
+namespace {
+	// The range as inclusive bounds of the coordinates shifted by their floor
+	struct Bounds {
+		int32_t zLow;
+		int32_t zHigh;
+		int32_t xLow;
+		int32_t xHigh;
+		int32_t yLow;
+		int32_t yHigh;
+		int32_t kinds;
+	};
+
+	struct Columns {
+		const int32_t* xs;
+		const int32_t* ys;
+		const int32_t* zs;
+		const int32_t* kinds;
+	};
+
+	void matchScalar(const Bounds &bounds, const Columns &columns, size_t from, size_t count, uint64_t* matches) {
+		for (size_t i = from; i < count; ++i) {
+			const int32_t z = columns.zs[i];
+			const int32_t x = columns.xs[i] + z;
+			const int32_t y = columns.ys[i] + z;
+			if (z >= bounds.zLow && z <= bounds.zHigh && x >= bounds.xLow && x <= bounds.xHigh && y >= bounds.yLow && y <= bounds.yHigh && (columns.kinds[i] & bounds.kinds) != 0) {
+				matches[i / 64] |= uint64_t { 1 } << (i % 64);
+			}
+		}
+	}
+
+#if defined(SIMD_RUNTIME_DISPATCH)
+	// Each kernel matches whole vectors of entries and returns how many it went through.
+	// The lane count divides 64, so the mask of a vector lands inside one bitmap word.
+
+	SIMD_TARGET("sse2") size_t matchSSE2(const Bounds &bounds, const Columns &columns, size_t count, uint64_t* matches) {
+		const __m128i vzLow = _mm_set1_epi32(bounds.zLow - 1);
+		const __m128i vzHigh = _mm_set1_epi32(bounds.zHigh + 1);
+		const __m128i vxLow = _mm_set1_epi32(bounds.xLow - 1);
+		const __m128i vxHigh = _mm_set1_epi32(bounds.xHigh + 1);
+		const __m128i vyLow = _mm_set1_epi32(bounds.yLow - 1);
+		const __m128i vyHigh = _mm_set1_epi32(bounds.yHigh + 1);
+		const __m128i vkinds = _mm_set1_epi32(bounds.kinds);
+		const __m128i zero = _mm_setzero_si128();
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&columns.zs[i]));
+			const __m128i x = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&columns.xs[i])), z);
+			const __m128i y = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&columns.ys[i])), z);
+			const __m128i kind = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&columns.kinds[i]));
+
+			__m128i inside = _mm_and_si128(_mm_cmpgt_epi32(z, vzLow), _mm_cmplt_epi32(z, vzHigh));
+			inside = _mm_and_si128(inside, _mm_and_si128(_mm_cmpgt_epi32(x, vxLow), _mm_cmplt_epi32(x, vxHigh)));
+			inside = _mm_and_si128(inside, _mm_and_si128(_mm_cmpgt_epi32(y, vyLow), _mm_cmplt_epi32(y, vyHigh)));
+			inside = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(kind, vkinds), zero), inside);
+
+			const auto bits = static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(inside)));
+			matches[i / 64] |= bits << (i % 64);
+		}
+		return i;
+	}
+
+	SIMD_TARGET("avx2") size_t matchAVX2(const Bounds &bounds, const Columns &columns, size_t count, uint64_t* matches) {
+		const __m256i vzLow = _mm256_set1_epi32(bounds.zLow - 1);
+		const __m256i vzHigh = _mm256_set1_epi32(bounds.zHigh + 1);
+		const __m256i vxLow = _mm256_set1_epi32(bounds.xLow - 1);
+		const __m256i vxHigh = _mm256_set1_epi32(bounds.xHigh + 1);
+		const __m256i vyLow = _mm256_set1_epi32(bounds.yLow - 1);
+		const __m256i vyHigh = _mm256_set1_epi32(bounds.yHigh + 1);
+		const __m256i vkinds = _mm256_set1_epi32(bounds.kinds);
+		const __m256i zero = _mm256_setzero_si256();
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&columns.zs[i]));
+			const __m256i x = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&columns.xs[i])), z);
+			const __m256i y = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&columns.ys[i])), z);
+			const __m256i kind = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&columns.kinds[i]));
+
+			__m256i inside = _mm256_and_si256(_mm256_cmpgt_epi32(z, vzLow), _mm256_cmpgt_epi32(vzHigh, z));
+			inside = _mm256_and_si256(inside, _mm256_and_si256(_mm256_cmpgt_epi32(x, vxLow), _mm256_cmpgt_epi32(vxHigh, x)));
+			inside = _mm256_and_si256(inside, _mm256_and_si256(_mm256_cmpgt_epi32(y, vyLow), _mm256_cmpgt_epi32(vyHigh, y)));
+			inside = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_and_si256(kind, vkinds), zero), inside);
+
+			const auto bits = static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(inside)));
+			matches[i / 64] |= bits << (i % 64);
+		}
+		return i;
+	}
+
+	SIMD_TARGET("avx512f") size_t matchAVX512(const Bounds &bounds, const Columns &columns, size_t count, uint64_t* matches) {
+		const __m512i vzLow = _mm512_set1_epi32(bounds.zLow);
+		const __m512i vzHigh = _mm512_set1_epi32(bounds.zHigh);
+		const __m512i vxLow = _mm512_set1_epi32(bounds.xLow);
+		const __m512i vxHigh = _mm512_set1_epi32(bounds.xHigh);
+		const __m512i vyLow = _mm512_set1_epi32(bounds.yLow);
+		const __m512i vyHigh = _mm512_set1_epi32(bounds.yHigh);
+		const __m512i vkinds = _mm512_set1_epi32(bounds.kinds);
+
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16) {
+			const __m512i z = _mm512_loadu_si512(&columns.zs[i]);
+			const __m512i x = _mm512_add_epi32(_mm512_loadu_si512(&columns.xs[i]), z);
+			const __m512i y = _mm512_add_epi32(_mm512_loadu_si512(&columns.ys[i]), z);
+			const __m512i kind = _mm512_loadu_si512(&columns.kinds[i]);
+
+			// Mask registers chain the comparisons, each one only tests the lanes still inside
+			__mmask16 inside = _mm512_test_epi32_mask(kind, vkinds);
+			inside = _mm512_mask_cmpge_epi32_mask(inside, z, vzLow);
+			inside = _mm512_mask_cmple_epi32_mask(inside, z, vzHigh);
+			inside = _mm512_mask_cmpge_epi32_mask(inside, x, vxLow);
+			inside = _mm512_mask_cmple_epi32_mask(inside, x, vxHigh);
+			inside = _mm512_mask_cmpge_epi32_mask(inside, y, vyLow);
+			inside = _mm512_mask_cmple_epi32_mask(inside, y, vyHigh);
+
+			matches[i / 64] |= static_cast<uint64_t>(inside) << (i % 64);
+		}
+		return i;
+	}
+#endif
+}
+
+void CreaturePositionIndex::matchRange(const Range &range, size_t begin, size_t count, uint64_t* matches, [[maybe_unused]] SimdLevel level) const {
+	Bounds bounds {};
+	bounds.zLow = range.minZ;
+	bounds.zHigh = range.minZ + static_cast<int32_t>(range.depth);
+	bounds.xLow = range.minX + range.centerZ;
+	bounds.xHigh = bounds.xLow + static_cast<int32_t>(range.width);
+	bounds.yLow = range.minY + range.centerZ;
+	bounds.yHigh = bounds.yLow + static_cast<int32_t>(range.height);
+	bounds.kinds = range.kinds;
+
+	const Columns columns { &xs[begin], &ys[begin], &zs[begin], &kinds[begin] };
+	std::fill_n(matches, (count + 63) / 64, 0);
+
+	size_t done = 0;
+#if defined(SIMD_RUNTIME_DISPATCH)
+	if (level >= SimdLevel::AVX512) {
+		done = matchAVX512(bounds, columns, count, matches);
+	} else if (level >= SimdLevel::AVX2) {
+		done = matchAVX2(bounds, columns, count, matches);
+	} else if (level >= SimdLevel::SSE2) {
+		done = matchSSE2(bounds, columns, count, matches);
+	}
+#endif
+
+	matchScalar(bounds, columns, done, count, matches);
+}
@@ -0,0 +1,115 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+#include "utils/cpu_features.hpp"
+
+/**
+ * @brief Positions of the creatures of a map sector, stored as packed arrays.
+ *
+ * Entry i holds the position and kind of the i-th creature of the sector, so a
+ * spectator query scans contiguous integers, several creatures per instruction,
+ * instead of dereferencing every creature. The scan uses the widest vector
+ * instructions of the CPU, picked at runtime. Removal swaps the last entry
+ * into the hole; the owner mirrors it on its pointer list to stay aligned.
+ */
+class CreaturePositionIndex {
+public:
+	enum Kind : uint8_t {
+		KIND_OTHER = 1 << 0,
+		KIND_PLAYER = 1 << 1,
+		KIND_MONSTER = 1 << 2,
+		KIND_NPC = 1 << 3,
+		KIND_ALL = KIND_OTHER | KIND_PLAYER | KIND_MONSTER | KIND_NPC,
+	};
+
+	/**
+	 * @brief The area of a spectator query, as Spectators::getSpectators computes it.
+	 *
+	 * A creature on floor z matches when z is within [minZ, minZ + depth] and its x and y,
+	 * shifted by one tile per floor of distance to centerZ, are within the rectangle.
+	 */
+	struct Range {
+		int32_t minX = 0;
+		int32_t minY = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		int32_t minZ = 0;
+		uint32_t depth = 0;
+		int32_t centerZ = 0;
+		uint8_t kinds = KIND_ALL;
+	};
+
+	void add(const Position &pos, uint8_t kind) {
+		xs.emplace_back(pos.x);
+		ys.emplace_back(pos.y);
+		zs.emplace_back(pos.z);
+		kinds.emplace_back(kind);
+	}
+
+	/**
+	 * @brief Removes the entry, moving the last entry into its place.
+	 */
+	void remove(size_t index) {
+		xs[index] = xs.back();
+		ys[index] = ys.back();
+		zs[index] = zs.back();
+		kinds[index] = kinds.back();
+
+		xs.pop_back();
+		ys.pop_back();
+		zs.pop_back();
+		kinds.pop_back();
+	}
+
+	void move(size_t index, const Position &pos) {
+		xs[index] = pos.x;
+		ys[index] = pos.y;
+		zs[index] = pos.z;
+	}
+
+	size_t size() const {
+		return xs.size();
+	}
+
+	/**
+	 * @brief Calls f with the index of every entry inside the range, in index order.
+	 * @param level The widest instruction set the matching may use, see getSimdLevel.
+	 */
+	template <typename F>
+	void forEachInRange(const Range &range, F &&f, SimdLevel level = getSimdLevel()) const {
+		std::array<uint64_t, CHUNK_SIZE / 64> matches;
+		for (size_t begin = 0; begin < xs.size(); begin += CHUNK_SIZE) {
+			const size_t count = std::min(CHUNK_SIZE, xs.size() - begin);
+			matchRange(range, begin, count, matches.data(), level);
+			for (size_t word = 0; word * 64 < count; ++word) {
+				for (uint64_t bits = matches[word]; bits != 0; bits &= bits - 1) {
+					f(begin + word * 64 + static_cast<size_t>(std::countr_zero(bits)));
+				}
+			}
+		}
+	}
+
+private:
+	// Entries matched per call of the kernel, as a bitmap on the stack
+	static constexpr size_t CHUNK_SIZE = 256;
+
+	/**
+	 * @brief Sets the bit of every entry from begin to begin + count inside the range.
+	 */
+	void matchRange(const Range &range, size_t begin, size_t count, uint64_t* matches, SimdLevel level) const;
+
+	// int32_t lanes, so a comparison covers the shifted coordinates without widening
+	std::vector<int32_t> xs;
+	std::vector<int32_t> ys;
+	std::vector<int32_t> zs;
+	std::vector<int32_t> kinds;
+};
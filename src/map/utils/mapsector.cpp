@@ -10,60 +10,243 @@
 #include "map/utils/mapsector.hpp"
 
 #include "creatures/creature.hpp"
+#include "items/tile.hpp"
+#include "lib/metrics/metrics.hpp"
 
 bool MapSector::newSector = false;
 
-void MapSector::addCreature(const std::shared_ptr<Creature> &c) {
-	creature_list.emplace_back(c);
+namespace {
+	constexpr size_t MAX_TILE_READERS = 512;
+
+	// Tile a thread is about to take ownership of, see Floor::getTile
+	struct alignas(64) TileHazard {
+		std::atomic<const Tile*> tile { nullptr };
+		std::atomic<bool> claimed { false };
+	};
+
+	TileHazard tileHazards[MAX_TILE_READERS];
+	// Every claimed hazard lies below this index
+	std::atomic<size_t> claimedTileHazards { 0 };
+
+	// Hazard owned by the calling thread until it exits
+	struct TileHazardClaim {
+		TileHazard* hazard = nullptr;
+
+		TileHazardClaim() {
+			for (size_t i = 0; i < MAX_TILE_READERS; ++i) {
+				bool claimed = false;
+				if (!tileHazards[i].claimed.compare_exchange_strong(claimed, true)) {
+					continue;
+				}
+
+				size_t used = claimedTileHazards.load();
+				while (used <= i && !claimedTileHazards.compare_exchange_weak(used, i + 1)) { }
+				hazard = &tileHazards[i];
+				return;
+			}
+		}
+
+		~TileHazardClaim() {
+			if (hazard) {
+				hazard->tile.store(nullptr, std::memory_order_release);
+				hazard->claimed.store(false, std::memory_order_release);
+			}
+		}
+
+		TileHazardClaim(const TileHazardClaim &) = delete;
+		TileHazardClaim &operator=(const TileHazardClaim &) = delete;
+	};
+
+	TileHazard* getTileHazard() {
+		thread_local TileHazardClaim claim;
+		return claim.hazard;
+	}
+
+	bool isTileHazard(const Tile* tile) {
+		const auto used = claimedTileHazards.load();
+		for (size_t i = 0; i < used; ++i) {
+			if (tileHazards[i].tile.load() == tile) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+std::shared_ptr<Tile> Floor::getTile(uint16_t x, uint16_t y) const {
+	const auto slot = getSlot(x, y);
+	const auto hazard = getTileHazard();
+	if (!hazard) {
+		// More reading threads than hazards, rare enough to wait for the writers
+		metrics::lock_latency measureLock("floor_read");
+		std::scoped_lock lock(mutex);
+		measureLock.stop();
+		return ownedTiles[slot];
+	}
+
+	// Once the hazard is announced and the tile is still published, a writer replacing it
+	// keeps it retired instead of freeing it until the hazard moves on
+	Tile* tile = tiles[slot].load(std::memory_order_acquire);
+	while (tile) {
+		hazard->tile.store(tile);
+		Tile* published = tiles[slot].load();
+		if (published == tile) {
+			break;
+		}
+		tile = published;
+	}
+	if (!tile) {
+		hazard->tile.store(nullptr, std::memory_order_release);
+		return nullptr;
+	}
+
+	auto owned = tile->static_self_cast<Tile>();
+	hazard->tile.store(nullptr, std::memory_order_release);
+	return owned;
+}
+
+void Floor::setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
+	metrics::lock_latency measureLock("floor_write");
+	std::scoped_lock lock(mutex);
+	measureLock.stop();
+
+	publishTile(getSlot(x, y), std::move(tile));
+}
+
+void Floor::setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile) {
+	metrics::lock_latency measureLock("floor_write");
+	std::scoped_lock lock(mutex);
+	measureLock.stop();
+
+	const auto slot = getSlot(x, y);
+	tileCaches[slot] = newTile;
+	setTileCacheBit(slot, newTile != nullptr);
+}
+
+std::shared_ptr<Tile> Floor::createTileFromCache(uint16_t x, uint16_t y, const CreateTile &create) {
+	metrics::lock_latency measureLock("floor_write");
+	std::scoped_lock lock(mutex);
+	measureLock.stop();
+
+	const auto slot = getSlot(x, y);
+	const auto cachedTile = std::move(tileCaches[slot]);
+	if (!cachedTile) {
+		return ownedTiles[slot];
+	}
+
+	auto tile = create(cachedTile, ownedTiles[slot]);
+	publishTile(slot, tile);
+	setTileCacheBit(slot, false);
+	return tile;
+}
+
+void Floor::updateTileBits(uint16_t x, uint16_t y, const Tile* tile) {
+	metrics::lock_latency measureLock("floor_write");
+	std::scoped_lock lock(mutex);
+	measureLock.stop();
+
+	// Under the mutex so a tile replaced meanwhile cannot overwrite the bits of its successor
+	const auto slot = getSlot(x, y);
+	if (ownedTiles[slot].get() == tile) {
+		storeTileBits(slot, getTileBits(tile));
+	}
+}
+
+uint8_t Floor::getTileBits(const Tile* tile) {
+	if (!tile) {
+		return TILE_BLOCKS_PATH;
+	}
+
+	uint8_t bits = 0;
+	if (!tile->getGround() || tile->hasFlag(TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT)) {
+		bits |= TILE_BLOCKS_PATH;
+	}
+	if (tile->hasFlag(TILESTATE_BLOCKPROJECTILE)) {
+		bits |= TILE_BLOCKS_PROJECTILE;
+	}
+	if (tile->getCreatureCount() != 0) {
+		bits |= TILE_HAS_CREATURE;
+	}
+	if (tile->hasFlag(TILESTATE_PROTECTIONZONE)) {
+		bits |= TILE_PROTECTION_ZONE;
+	}
+	return bits;
+}
+
+void Floor::publishTile(size_t slot, std::shared_ptr<Tile> tile) {
+	const auto bits = getTileBits(tile.get());
+	tiles[slot].store(tile.get());
+	auto replaced = std::exchange(ownedTiles[slot], std::move(tile));
+	storeTileBits(slot, bits);
+
+	if (replaced) {
+		retiredTiles.emplace_back(std::move(replaced));
+		reclaimTiles();
+	}
+}
+
+void Floor::reclaimTiles() {
+	std::erase_if(retiredTiles, [](const std::shared_ptr<Tile> &tile) {
+		return !isTileHazard(tile.get());
+	});
+}
+
+void Floor::setTileCacheBit(size_t slot, bool cached) {
+	const auto mask = uint64_t { 1 } << (slot % 64);
+	if (cached) {
+		cachedTiles[slot / 64].fetch_or(mask, std::memory_order_release);
+	} else {
+		cachedTiles[slot / 64].fetch_and(~mask, std::memory_order_release);
+	}
+}
+
+void Floor::storeTileBits(size_t slot, uint8_t bits) {
+	const auto mask = uint64_t { 1 } << (slot % 64);
+	for (size_t kind = 0; kind < TILE_BITS_COUNT; ++kind) {
+		if ((bits >> kind) & 1) {
+			tileBits[kind][slot / 64].fetch_or(mask, std::memory_order_release);
+		} else {
+			tileBits[kind][slot / 64].fetch_and(~mask, std::memory_order_release);
+		}
+	}
+}
+
+void MapSector::addCreature(const std::shared_ptr<Creature> &c, const Position &pos) {
+	uint8_t kind = CreaturePositionIndex::KIND_OTHER;
 	if (c->getPlayer()) {
-		player_list.emplace_back(c);
+		kind = CreaturePositionIndex::KIND_PLAYER;
 	} else if (c->getMonster()) {
-		monster_list.emplace_back(c);
+		kind = CreaturePositionIndex::KIND_MONSTER;
 	} else if (c->getNpc()) {
-		npc_list.emplace_back(c);
+		kind = CreaturePositionIndex::KIND_NPC;
 	}
+
+	creature_list.emplace_back(c);
+	creaturePositions.add(pos, kind);
+	creatureVersion.fetch_add(1, std::memory_order_release);
 }
 
 void MapSector::removeCreature(const std::shared_ptr<Creature> &c) {
-	auto iter = std::ranges::find(creature_list, c);
+	const auto iter = std::ranges::find(creature_list, c);
 	if (iter == creature_list.end()) {
 		g_logger().error("[{}]: Creature not found in creature_list!", __FUNCTION__);
 		return;
 	}
 
-	assert(iter != creature_list.end());
+	const auto index = static_cast<size_t>(iter - creature_list.begin());
 	*iter = creature_list.back();
 	creature_list.pop_back();
+	creaturePositions.remove(index);
+	creatureVersion.fetch_add(1, std::memory_order_release);
+}
 
-	if (c->getPlayer()) {
-		iter = std::ranges::find(player_list, c);
-		if (iter == player_list.end()) {
-			g_logger().error("[{}]: Player not found in player_list!", __FUNCTION__);
-			return;
-		}
-
-		assert(iter != player_list.end());
-		*iter = player_list.back();
-		player_list.pop_back();
-	} else if (c->getMonster()) {
-		iter = std::ranges::find(monster_list, c);
-		if (iter == monster_list.end()) {
-			g_logger().error("[{}]: Monster not found in player_list!", __FUNCTION__);
-			return;
-		}
-
-		assert(iter != monster_list.end());
-		*iter = monster_list.back();
-		monster_list.pop_back();
-	} else if (c->getNpc()) {
-		iter = std::ranges::find(npc_list, c);
-		if (iter == npc_list.end()) {
-			g_logger().error("[{}]: NPC not found in player_list!", __FUNCTION__);
-			return;
-		}
-
-		assert(iter != npc_list.end());
-		*iter = npc_list.back();
-		npc_list.pop_back();
+void MapSector::moveCreature(const std::shared_ptr<Creature> &c, const Position &pos) {
+	const auto iter = std::ranges::find(creature_list, c);
+	if (iter == creature_list.end()) {
+		g_logger().error("[{}]: Creature not found in creature_list!", __FUNCTION__);
+		return;
 	}
+
+	creaturePositions.move(static_cast<size_t>(iter - creature_list.begin()), pos);
+	creatureVersion.fetch_add(1, std::memory_order_release);
 }
@@ -10,50 +10,113 @@
 #pragma once
 
 #include "map/map_const.hpp"
+#include "map/utils/creature_position_index.hpp"
 
 class Creature;
 class Tile;
 struct BasicTile;
 
+/**
+ * @brief Tiles of a map sector on one floor.
+ *
+ * Reads never take a lock: each slot publishes a raw pointer to its tile (and a bit
+ * telling whether a cached tile is waiting to be created), which writers only replace
+ * under the floor mutex. A reader announces the tile in its thread's hazard pointer
+ * before taking ownership of it, and a writer keeps a replaced tile retired while any
+ * hazard still points at it, then drops it to its remaining owners.
+ *
+ * Next to the tiles, one bitset per TileBits kind mirrors what sight lines and
+ * path searches ask of each tile, so they test a bit instead of dereferencing it.
+ */
 struct Floor {
-	explicit Floor(uint8_t z) :
-		z(z) { }
+	using CreateTile = std::function<std::shared_ptr<Tile>(const std::shared_ptr<BasicTile> &, const std::shared_ptr<Tile> &)>;
 
-	std::shared_ptr<Tile> getTile(uint16_t x, uint16_t y) const {
-		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].first;
-	}
+	enum TileBits : uint8_t {
+		// No tile, no ground, a floor change or a teleport: no path search walks in
+		TILE_BLOCKS_PATH = 1 << 0,
+		TILE_BLOCKS_PROJECTILE = 1 << 1,
+		TILE_HAS_CREATURE = 1 << 2,
+		TILE_PROTECTION_ZONE = 1 << 3,
+	};
+	static constexpr size_t TILE_BITS_COUNT = 4;
 
-	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
-		tiles[x & SECTOR_MASK][y & SECTOR_MASK].first = std::move(tile);
+	explicit Floor(uint8_t z) :
+		z(z) {
+		// Every slot starts without a tile
+		for (auto &word : tileBits[std::countr_zero(static_cast<uint8_t>(TILE_BLOCKS_PATH))]) {
+			word.store(~uint64_t { 0 }, std::memory_order_relaxed);
+		}
 	}
 
-	std::shared_ptr<BasicTile> getTileCache(uint16_t x, uint16_t y) const {
-		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].second;
-	}
+	std::shared_ptr<Tile> getTile(uint16_t x, uint16_t y) const;
+
+	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile);
 
-	void setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile) {
-		tiles[x & SECTOR_MASK][y & SECTOR_MASK].second = newTile;
+	bool hasTileCache(uint16_t x, uint16_t y) const {
+		const auto bit = getSlot(x, y);
+		return (cachedTiles[bit / 64].load(std::memory_order_acquire) >> (bit % 64)) & 1;
 	}
 
-	const auto &getTiles() const {
-		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles;
+	void setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile);
+
+	/**
+	 * @brief Creates the tile from its cached version, once even with concurrent callers.
+	 *
+	 * @param create Receives the cached tile and the tile it replaces, runs under the floor mutex.
+	 * @return The created tile, or the current one when another caller created it first.
+	 */
+	std::shared_ptr<Tile> createTileFromCache(uint16_t x, uint16_t y, const CreateTile &create);
+
+	/**
+	 * @brief Whether the tile has any of the TileBits, without locking or touching the tile.
+	 *
+	 * Only holds for the published tile: while hasTileCache(x, y) the tile is not built yet.
+	 */
+	bool hasAnyTileBit(uint16_t x, uint16_t y, uint8_t bits) const {
+		const auto slot = getSlot(x, y);
+		for (; bits != 0; bits &= bits - 1) {
+			if ((tileBits[std::countr_zero(bits)][slot / 64].load(std::memory_order_acquire) >> (slot % 64)) & 1) {
+				return true;
+			}
+		}
+		return false;
 	}
 
+	/**
+	 * @brief Mirrors the tile into its bits, ignored unless it is the published tile of the slot.
+	 *
+	 * Takes the floor mutex, like every other writer of the bits.
+	 */
+	void updateTileBits(uint16_t x, uint16_t y, const Tile* tile);
+
 	uint8_t getZ() const {
 		return z;
 	}
 
-	auto &getMutex() const {
-		return mutex;
+private:
+	static size_t getSlot(uint16_t x, uint16_t y) {
+		return (x & SECTOR_MASK) * SECTOR_SIZE + (y & SECTOR_MASK);
 	}
 
-private:
-	std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[SECTOR_SIZE][SECTOR_SIZE] = {};
+	static uint8_t getTileBits(const Tile* tile);
 
-	mutable std::shared_mutex mutex;
+	void publishTile(size_t slot, std::shared_ptr<Tile> tile);
+	void setTileCacheBit(size_t slot, bool cached);
+	void storeTileBits(size_t slot, uint8_t bits);
+	void reclaimTiles();
+
+	// Guarded by mutex
+	std::shared_ptr<BasicTile> tileCaches[SECTOR_SIZE * SECTOR_SIZE] = {};
+	std::shared_ptr<Tile> ownedTiles[SECTOR_SIZE * SECTOR_SIZE] = {};
+	// Replaced tiles a reader may be about to take ownership of
+	std::vector<std::shared_ptr<Tile>> retiredTiles;
+
+	// Read without locking, only stored under mutex
+	std::atomic<Tile*> tiles[SECTOR_SIZE * SECTOR_SIZE] = {};
+	std::atomic<uint64_t> cachedTiles[SECTOR_SIZE * SECTOR_SIZE / 64] = {};
+	std::atomic<uint64_t> tileBits[TILE_BITS_COUNT][SECTOR_SIZE * SECTOR_SIZE / 64] = {};
+
+	mutable std::mutex mutex;
 
 	uint8_t z { 0 };
 };
@@ -67,47 +130,71 @@ public:
 	MapSector(const MapSector &&) = delete;
 	MapSector &operator=(const MapSector &&) = delete;
 
-	std::shared_ptr<Floor> createFloor(uint32_t z) {
+	Floor* createFloor(uint32_t z) {
 		if (z >= MAP_MAX_LAYERS) {
 			g_logger().error("Attempt to create floor on invalid coordinate: {}", z);
 			return nullptr;
 		}
 		std::scoped_lock lock(floors_mutex);
-		if (!floors[z]) {
-			floors[z] = std::make_shared<Floor>(static_cast<uint8_t>(z));
+		if (!ownedFloors[z]) {
+			ownedFloors[z] = std::make_unique<Floor>(static_cast<uint8_t>(z));
+			floors[z].store(ownedFloors[z].get(), std::memory_order_release);
 		}
-		return floors[z];
+		return ownedFloors[z].get();
 	}
 
-	std::shared_ptr<Floor> getFloor(uint8_t z) {
+	// Floors live as long as their sector, so readers get them without locking
+	Floor* getFloor(uint8_t z) const {
 		if (z >= MAP_MAX_LAYERS) {
 			g_logger().error("Attempt to get floor on invalid coordinate: {}", z);
 			return nullptr;
 		}
-		std::scoped_lock lock(floors_mutex);
-		return floors[z];
+		return floors[z].load(std::memory_order_acquire);
 	}
 
-	void addCreature(const std::shared_ptr<Creature> &c);
+	void addCreature(const std::shared_ptr<Creature> &c, const Position &pos);
 
 	void removeCreature(const std::shared_ptr<Creature> &c);
 
+	/**
+	 * @brief Updates the indexed position of a creature moving inside the sector.
+	 */
+	void moveCreature(const std::shared_ptr<Creature> &c, const Position &pos);
+
+	/**
+	 * @brief Increases every time a creature enters, leaves or moves inside the sector.
+	 */
+	uint32_t getCreatureVersion() const {
+		return creatureVersion.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief Increases every time a tile of the sector is replaced or its items change its flags.
+	 */
+	uint32_t getTileVersion() const {
+		return tileVersion.load(std::memory_order_acquire);
+	}
+
+	void onTileChange() {
+		tileVersion.fetch_add(1, std::memory_order_release);
+	}
+
 private:
 	static bool newSector;
 
 	MapSector* sectorS = nullptr;
 	MapSector* sectorE = nullptr;
 
+	// creature_list[i] is the creature of creaturePositions entry i
 	std::vector<std::shared_ptr<Creature>> creature_list;
-	std::vector<std::shared_ptr<Creature>> player_list;
-	std::vector<std::shared_ptr<Creature>> monster_list;
-	std::vector<std::shared_ptr<Creature>> npc_list;
-
-	mutable std::mutex floors_mutex;
+	CreaturePositionIndex creaturePositions;
+	std::atomic<uint32_t> creatureVersion { 0 };
+	std::atomic<uint32_t> tileVersion { 0 };
 
-	std::shared_ptr<Floor> floors[MAP_MAX_LAYERS] = {};
+	std::mutex floors_mutex;
 
-	uint32_t floorBits = 0;
+	std::unique_ptr<Floor> ownedFloors[MAP_MAX_LAYERS] = {};
+	std::atomic<Floor*> floors[MAP_MAX_LAYERS] = {};
 
 	friend class Spectators;
 	friend class MapCache;
@@ -0,0 +1,96 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/path_cache.hpp"
+
+#include "lib/metrics/metrics.hpp"
+#include "map/map_const.hpp"
+#include "utils/tools.hpp"
+
+size_t PathCache::KeyHash::operator()(const Key &key) const noexcept {
+	constexpr std::hash<Position> hashPosition;
+	size_t hash = hashPosition(key.start);
+	hash = hash * 31 + hashPosition(key.goal);
+	hash = hash * 31 + ((static_cast<size_t>(key.walkFlags) << 8) | key.searchFlags);
+	hash = hash * 31 + static_cast<size_t>(key.maxSearchDist);
+	hash = hash * 31 + ((static_cast<size_t>(static_cast<uint32_t>(key.minTargetDist)) << 16) ^ static_cast<uint32_t>(key.maxTargetDist));
+	return hash;
+}
+
+std::optional<PathCache::Hit> PathCache::find(const Key &key, std::chrono::steady_clock::time_point now /* = std::chrono::steady_clock::now()*/) {
+	auto &shard = getShard(key.start);
+	std::shared_lock lock(shard.mutex);
+	const auto it = shard.entries.find(key);
+	if (it == shard.entries.end() || it->second.expires <= now) {
+		return std::nullopt;
+	}
+	return Hit { it->second.path, it->second.offset };
+}
+
+void PathCache::insert(const Key &key, std::vector<Direction> directions, bool shareSuffixes, std::chrono::steady_clock::time_point now /* = std::chrono::steady_clock::now()*/) {
+	auto path = std::make_shared<Path>();
+	path->positions.reserve(directions.size());
+	Position pos = key.start;
+	for (auto it = directions.rbegin(); it != directions.rend(); ++it) {
+		pos = getNextPosition(*it, pos);
+		path->positions.emplace_back(pos);
+	}
+	path->directions = std::move(directions);
+
+	const std::shared_ptr<const Path> shared = std::move(path);
+	const auto expires = now + PATH_TTL;
+	// The last position is the goal itself, nothing to walk from there
+	const size_t starts = shareSuffixes && !shared->positions.empty() ? shared->positions.size() : 1;
+
+	Key suffixKey = key;
+	for (size_t offset = 0; offset < starts; ++offset) {
+		suffixKey.start = offset == 0 ? key.start : shared->positions[offset - 1];
+
+		auto &shard = getShard(suffixKey.start);
+		std::unique_lock lock(shard.mutex);
+		if (shard.entries.size() >= SHARD_LIMIT && !shard.entries.contains(suffixKey)) {
+			shard.entries.clear();
+		}
+		shard.entries[suffixKey] = Entry { shared, static_cast<uint32_t>(offset), expires };
+	}
+}
+
+void PathCache::reject(const Key &key) {
+	stale.fetch_add(1, std::memory_order_relaxed);
+
+	auto &shard = getShard(key.start);
+	std::unique_lock lock(shard.mutex);
+	shard.entries.erase(key);
+}
+
+void PathCache::clear() {
+	for (auto &shard : shards) {
+		std::unique_lock lock(shard.mutex);
+		shard.entries.clear();
+	}
+}
+
+void PathCache::reportMetrics() {
+	if (const auto searches = misses.exchange(0, std::memory_order_relaxed)) {
+		g_metrics().addCounter("map_path_cache_misses", static_cast<double>(searches));
+		g_metrics().addCounter("map_path_nodes_expanded", static_cast<double>(nodesExpanded.exchange(0, std::memory_order_relaxed)));
+	}
+	if (const auto served = hits.exchange(0, std::memory_order_relaxed)) {
+		g_metrics().addCounter("map_path_cache_hits", static_cast<double>(served));
+	}
+	if (const auto rejected = stale.exchange(0, std::memory_order_relaxed)) {
+		g_metrics().addCounter("map_path_cache_stale", static_cast<double>(rejected));
+	}
+}
+
+PathCache::Shard &PathCache::getShard(const Position &start) {
+	const auto sectorX = static_cast<uint32_t>(start.x / SECTOR_SIZE);
+	const auto sectorY = static_cast<uint32_t>(start.y / SECTOR_SIZE);
+	return shards[(sectorX * 31 + sectorY) % shards.size()];
+}
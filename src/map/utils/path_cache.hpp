@@ -0,0 +1,152 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+/**
+ * @brief Recently found paths, keyed by start, goal, walk flags and search parameters.
+ *
+ * Lets the creatures chasing the same target along the same way reuse a search
+ * instead of running A* again. Every position a stored path steps on starts an
+ * entry for the rest of the path, so a creature standing on the path of another
+ * also gets it. Entries expire after PATH_TTL; a path is only a candidate, and
+ * Map checks its tiles again before using it, dropping it when they changed.
+ * Thread safe, pathfinding runs on the dispatcher and on its async tasks.
+ */
+class PathCache {
+public:
+	// How long a path is reused before it is searched again
+	static constexpr auto PATH_TTL = std::chrono::milliseconds(1000);
+	// Entries per shard before the shard is dropped
+	static constexpr size_t SHARD_LIMIT = 4096;
+
+	/**
+	 * @brief What decides which tiles a creature can walk on, for the key.
+	 */
+	enum WalkFlags : uint32_t {
+		WALK_PLAYER = 1 << 0,
+		WALK_MONSTER = 1 << 1,
+		WALK_NPC = 1 << 2,
+		WALK_SUMMON = 1 << 3,
+		WALK_PUSH_ITEMS = 1 << 4,
+		WALK_PUSH_CREATURES = 1 << 5,
+		WALK_FIRE_FIELDS = 1 << 6,
+		WALK_ENERGY_FIELDS = 1 << 7,
+		WALK_POISON_FIELDS = 1 << 8,
+	};
+
+	enum SearchFlags : uint32_t {
+		SEARCH_FULL_PATH = 1 << 0,
+		SEARCH_CLEAR_SIGHT = 1 << 1,
+		SEARCH_ALLOW_DIAGONAL = 1 << 2,
+		SEARCH_KEEP_DISTANCE = 1 << 3,
+		// Searched by Map::getPathMatchingCond, bounded by maxSearchDist
+		SEARCH_BOUNDED = 1 << 4,
+	};
+
+	struct Key {
+		Position start;
+		Position goal;
+		uint32_t walkFlags = 0;
+		uint32_t searchFlags = 0;
+		int32_t maxSearchDist = 0;
+		int32_t minTargetDist = 0;
+		int32_t maxTargetDist = 0;
+
+		bool operator==(const Key &) const = default;
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key &key) const noexcept;
+	};
+
+	/**
+	 * @brief A found path: the positions it steps on in walking order, and its
+	 * directions as Map::getPathMatching lists them, last step first.
+	 */
+	struct Path {
+		std::vector<Position> positions;
+		std::vector<Direction> directions;
+	};
+
+	/**
+	 * @brief The part of a stored path left after its first offset steps.
+	 */
+	struct Hit {
+		std::shared_ptr<const Path> path;
+		size_t offset = 0;
+
+		std::span<const Position> getPositions() const {
+			return std::span(path->positions).subspan(offset);
+		}
+
+		std::span<const Direction> getDirections() const {
+			return std::span(path->directions).first(path->directions.size() - offset);
+		}
+	};
+
+	std::optional<Hit> find(const Key &key, std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+	/**
+	 * @brief Stores a path found from key.start.
+	 *
+	 * @param directions As Map::getPathMatching lists them, last step first.
+	 * @param shareSuffixes Whether the positions of the path start entries for
+	 * the rest of it, which is only right when the goal does not depend on the start.
+	 */
+	void insert(const Key &key, std::vector<Direction> directions, bool shareSuffixes, std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+	/**
+	 * @brief Drops a path whose tiles changed, counting it as stale.
+	 */
+	void reject(const Key &key);
+
+	void clear();
+
+	void onHit() {
+		hits.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Counts a search that ran A*, and the nodes it expanded.
+	 */
+	void onSearch(uint32_t expandedNodes) {
+		misses.fetch_add(1, std::memory_order_relaxed);
+		nodesExpanded.fetch_add(expandedNodes, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Reports map_path_cache_hits, map_path_cache_misses, map_path_cache_stale
+	 * and map_path_nodes_expanded since the previous report.
+	 */
+	void reportMetrics();
+
+private:
+	struct Entry {
+		std::shared_ptr<const Path> path;
+		uint32_t offset = 0;
+		std::chrono::steady_clock::time_point expires;
+	};
+
+	struct Shard {
+		std::shared_mutex mutex;
+		phmap::flat_hash_map<Key, Entry, KeyHash> entries;
+	};
+
+	Shard &getShard(const Position &start);
+
+	std::array<Shard, 64> shards;
+
+	std::atomic<uint64_t> hits = 0;
+	std::atomic<uint64_t> misses = 0;
+	std::atomic<uint64_t> stale = 0;
+	std::atomic<uint64_t> nodesExpanded = 0;
+};
@@ -0,0 +1,108 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "map/utils/mapsector.hpp"
+
+/**
+ * @brief Sparse-paged 2D array of map sectors, indexed with tile coordinates.
+ *
+ * A fixed table of pages covers the whole position range, each page holding
+ * 64x64 sector slots and allocated when its first sector is created. A lookup is
+ * bounds checks and two dependent loads, without hashing. Reads are lock-free,
+ * creation is serialized, and sectors keep their address until the grid is destroyed.
+ */
+class SectorGrid {
+public:
+	SectorGrid() = default;
+	~SectorGrid() {
+		for (auto &page : pages) {
+			if (const auto sectors = page.load(std::memory_order_relaxed)) {
+				for (auto &sector : sectors->slots) {
+					delete sector.load(std::memory_order_relaxed);
+				}
+				delete sectors;
+			}
+		}
+	}
+
+	// Ensures that we don't accidentally copy it
+	SectorGrid(const SectorGrid &) = delete;
+	SectorGrid &operator=(const SectorGrid &) = delete;
+
+	MapSector* get(uint32_t x, uint32_t y) const {
+		if (x > MAX_COORDINATE || y > MAX_COORDINATE) {
+			return nullptr;
+		}
+
+		const uint32_t sectorX = x / SECTOR_SIZE;
+		const uint32_t sectorY = y / SECTOR_SIZE;
+		const auto page = pages[getPageIndex(sectorX, sectorY)].load(std::memory_order_acquire);
+		return page ? page->slots[getSlotIndex(sectorX, sectorY)].load(std::memory_order_acquire) : nullptr;
+	}
+
+	/**
+	 * @return The sector and whether it was just created, nullptr for coordinates out of bounds.
+	 */
+	std::pair<MapSector*, bool> getOrCreate(uint32_t x, uint32_t y) {
+		if (x > MAX_COORDINATE || y > MAX_COORDINATE) {
+			return { nullptr, false };
+		}
+
+		std::scoped_lock lock(mutex);
+		const uint32_t sectorX = x / SECTOR_SIZE;
+		const uint32_t sectorY = y / SECTOR_SIZE;
+
+		auto &page = pages[getPageIndex(sectorX, sectorY)];
+		auto sectors = page.load(std::memory_order_relaxed);
+		if (!sectors) {
+			sectors = new Page();
+			page.store(sectors, std::memory_order_release);
+		}
+
+		auto &slot = sectors->slots[getSlotIndex(sectorX, sectorY)];
+		if (const auto sector = slot.load(std::memory_order_relaxed)) {
+			return { sector, false };
+		}
+
+		const auto sector = new MapSector();
+		slot.store(sector, std::memory_order_release);
+		++count;
+		return { sector, true };
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+private:
+	static constexpr uint32_t MAX_COORDINATE = std::numeric_limits<uint16_t>::max();
+	static constexpr uint32_t SECTORS_PER_AXIS = (MAX_COORDINATE + 1) / SECTOR_SIZE;
+	static constexpr uint32_t PAGE_BITS = 6;
+	static constexpr uint32_t PAGE_SIZE = 1 << PAGE_BITS;
+	static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+	static constexpr uint32_t PAGES_PER_AXIS = SECTORS_PER_AXIS / PAGE_SIZE;
+
+	struct Page {
+		std::array<std::atomic<MapSector*>, PAGE_SIZE * PAGE_SIZE> slots {};
+	};
+
+	static uint32_t getPageIndex(uint32_t sectorX, uint32_t sectorY) {
+		return (sectorY >> PAGE_BITS) * PAGES_PER_AXIS + (sectorX >> PAGE_BITS);
+	}
+
+	static uint32_t getSlotIndex(uint32_t sectorX, uint32_t sectorY) {
+		return ((sectorY & PAGE_MASK) << PAGE_BITS) | (sectorX & PAGE_MASK);
+	}
+
+	std::array<std::atomic<Page*>, PAGES_PER_AXIS * PAGES_PER_AXIS> pages {};
+	std::mutex mutex;
+	size_t count = 0;
+};
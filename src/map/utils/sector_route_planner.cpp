@@ -0,0 +1,303 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/sector_route_planner.hpp"
+
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	struct OpenPortal {
+		uint32_t f;
+		uint32_t g;
+		Position pos;
+
+		bool operator>(const OpenPortal &other) const {
+			return f > other.f;
+		}
+	};
+
+	struct PortalNode {
+		uint32_t g = 0;
+		Position parent;
+		// Reached from the start tile, parent is unused
+		bool fromStart = false;
+		// Reached crossing into its sector
+		bool entered = false;
+		bool closed = false;
+	};
+
+	uint32_t getHeuristic(const Position &pos, const Position &goal) {
+		return static_cast<uint32_t>(std::max(Position::getDistanceX(pos, goal), Position::getDistanceY(pos, goal))) * SectorRoutePlanner::STRAIGHT_COST;
+	}
+}
+
+std::vector<Position> SectorRoutePlanner::findRoute(const Position &start, const Position &goal) {
+	if (start.z != goal.z) {
+		return {};
+	}
+
+	routes.fetch_add(1, std::memory_order_relaxed);
+
+	// Sectors looked at by this search, so each is fetched from the cache once
+	phmap::flat_hash_map<uint64_t, std::shared_ptr<const Sector>> visited;
+	const auto getVisited = [this, &visited](const Position &pos) -> const Sector & {
+		auto &sector = visited[getSectorKey(pos.x, pos.y, pos.z)];
+		if (!sector) {
+			sector = getSector(pos.x, pos.y, pos.z);
+		}
+		return *sector;
+	};
+
+	const uint64_t goalKey = getSectorKey(goal.x, goal.y, goal.z);
+	const auto goalCosts = getCostsFrom(getVisited(goal), goal);
+
+	uint32_t goalCost = NO_ROUTE;
+	Position goalParent;
+	bool goalFromStart = false;
+
+	phmap::flat_hash_map<Position, PortalNode> nodes;
+	std::priority_queue<OpenPortal, std::vector<OpenPortal>, std::greater<>> open;
+	const auto relax = [&](const Position &pos, uint32_t g, const Position &parent, bool fromStart, bool entered) {
+		auto [it, inserted] = nodes.try_emplace(pos);
+		if (!inserted && it->second.g <= g) {
+			return;
+		}
+		it->second = PortalNode { g, parent, fromStart, entered, false };
+		open.push({ g + getHeuristic(pos, goal), g, pos });
+	};
+
+	const auto &startSector = getVisited(start);
+	const auto startCosts = getCostsFrom(startSector, start);
+	if (getSectorKey(start.x, start.y, start.z) == goalKey && startCosts[getSlot(goal.x, goal.y)] != NO_ROUTE) {
+		goalCost = startCosts[getSlot(goal.x, goal.y)];
+		goalFromStart = true;
+	}
+	for (const auto &portal : startSector.portals) {
+		if (const auto cost = startCosts[getSlot(portal.pos.x, portal.pos.y)]; cost != NO_ROUTE) {
+			relax(portal.pos, cost, start, true, false);
+		}
+	}
+
+	uint32_t expanded = 0;
+	while (!open.empty() && expanded < MAX_EXPANDED_PORTALS) {
+		const auto current = open.top();
+		open.pop();
+		if (current.f >= goalCost) {
+			break;
+		}
+
+		auto &node = nodes[current.pos];
+		if (node.closed || node.g != current.g) {
+			continue;
+		}
+		node.closed = true;
+		++expanded;
+
+		const Position pos = current.pos;
+		const uint32_t g = current.g;
+		if (getSectorKey(pos.x, pos.y, pos.z) == goalKey) {
+			if (const auto cost = goalCosts[getSlot(pos.x, pos.y)]; cost != NO_ROUTE && g + cost < goalCost) {
+				goalCost = g + cost;
+				goalParent = pos;
+				goalFromStart = false;
+			}
+		}
+
+		const auto &sector = getVisited(pos);
+		const auto it = std::ranges::find(sector.portals, pos, &Portal::pos);
+		if (it == sector.portals.end()) {
+			// The sector was rebuilt and the border moved, only its neighbour knows this tile
+			continue;
+		}
+
+		const auto index = static_cast<size_t>(std::distance(sector.portals.begin(), it));
+		const size_t count = sector.portals.size();
+		for (size_t other = 0; other < count; ++other) {
+			if (const auto cost = sector.costs[index * count + other]; other != index && cost != NO_ROUTE) {
+				relax(sector.portals[other].pos, g + cost, pos, false, false);
+			}
+		}
+
+		if ((it->sides & SIDE_NORTH) && pos.y > 0) {
+			relax(Position(pos.x, pos.y - 1, pos.z), g + STRAIGHT_COST, pos, false, true);
+		}
+		if ((it->sides & SIDE_EAST) && pos.x < std::numeric_limits<uint16_t>::max()) {
+			relax(Position(pos.x + 1, pos.y, pos.z), g + STRAIGHT_COST, pos, false, true);
+		}
+		if ((it->sides & SIDE_SOUTH) && pos.y < std::numeric_limits<uint16_t>::max()) {
+			relax(Position(pos.x, pos.y + 1, pos.z), g + STRAIGHT_COST, pos, false, true);
+		}
+		if ((it->sides & SIDE_WEST) && pos.x > 0) {
+			relax(Position(pos.x - 1, pos.y, pos.z), g + STRAIGHT_COST, pos, false, true);
+		}
+	}
+	portalsExpanded.fetch_add(expanded, std::memory_order_relaxed);
+
+	if (goalCost == NO_ROUTE) {
+		return {};
+	}
+
+	std::vector<Position> route { goal };
+	std::optional<Position> step;
+	if (!goalFromStart) {
+		step = goalParent;
+	}
+	while (step) {
+		const auto &node = nodes.at(*step);
+		if (node.entered) {
+			route.emplace_back(*step);
+		}
+		step = node.fromStart ? std::nullopt : std::optional<Position>(node.parent);
+	}
+	std::ranges::reverse(route);
+	return route;
+}
+
+void SectorRoutePlanner::clear() {
+	std::scoped_lock lock(mutex);
+	sectors.clear();
+}
+
+void SectorRoutePlanner::reportMetrics() {
+	if (const auto planned = routes.exchange(0, std::memory_order_relaxed)) {
+		g_metrics().addCounter("map_path_sector_routes", static_cast<double>(planned));
+		g_metrics().addCounter("map_path_sector_portals_expanded", static_cast<double>(portalsExpanded.exchange(0, std::memory_order_relaxed)));
+	}
+}
+
+std::array<uint32_t, SectorRoutePlanner::SECTOR_TILES> SectorRoutePlanner::getCostsFrom(const Sector &sector, const Position &from) {
+	std::array<uint32_t, SECTOR_TILES> costs;
+	costs.fill(NO_ROUTE);
+
+	// Dijkstra over the tiles of the sector, the first one counts as walkable
+	using Step = std::pair<uint32_t, size_t>;
+	std::priority_queue<Step, std::vector<Step>, std::greater<>> open;
+	const size_t first = getSlot(from.x, from.y);
+	costs[first] = 0;
+	open.emplace(0, first);
+	while (!open.empty()) {
+		const auto [cost, slot] = open.top();
+		open.pop();
+		if (cost != costs[slot]) {
+			continue;
+		}
+
+		const auto x = static_cast<int32_t>(slot % SECTOR_SIZE);
+		const auto y = static_cast<int32_t>(slot / SECTOR_SIZE);
+		for (int32_t dy = -1; dy <= 1; ++dy) {
+			for (int32_t dx = -1; dx <= 1; ++dx) {
+				const int32_t nx = x + dx;
+				const int32_t ny = y + dy;
+				if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= SECTOR_SIZE || ny >= SECTOR_SIZE) {
+					continue;
+				}
+
+				const auto next = static_cast<size_t>(ny * SECTOR_SIZE + nx);
+				const uint32_t nextCost = cost + (dx != 0 && dy != 0 ? DIAGONAL_COST : STRAIGHT_COST);
+				if (sector.walkable.test(next) && nextCost < costs[next]) {
+					costs[next] = nextCost;
+					open.emplace(nextCost, next);
+				}
+			}
+		}
+	}
+	return costs;
+}
+
+std::shared_ptr<const SectorRoutePlanner::Sector> SectorRoutePlanner::getSector(uint16_t x, uint16_t y, uint8_t z) {
+	const auto baseX = static_cast<uint16_t>(x - (x & SECTOR_MASK));
+	const auto baseY = static_cast<uint16_t>(y - (y & SECTOR_MASK));
+	// Read before building, so a change made meanwhile leaves the sector stale
+	const uint32_t version = getSectorVersion(baseX, baseY);
+	const uint64_t key = getSectorKey(x, y, z);
+	{
+		std::scoped_lock lock(mutex);
+		if (const auto it = sectors.find(key); it != sectors.end() && it->second->version == version) {
+			return it->second;
+		}
+	}
+
+	std::shared_ptr<const Sector> sector = buildSector(baseX, baseY, z, version);
+
+	std::scoped_lock lock(mutex);
+	if (sectors.size() >= MAX_CACHED_SECTORS && !sectors.contains(key)) {
+		sectors.clear();
+	}
+	sectors[key] = sector;
+	return sector;
+}
+
+std::shared_ptr<SectorRoutePlanner::Sector> SectorRoutePlanner::buildSector(uint16_t baseX, uint16_t baseY, uint8_t z, uint32_t version) const {
+	auto sector = std::make_shared<Sector>();
+	sector->version = version;
+	for (int32_t y = 0; y < SECTOR_SIZE; ++y) {
+		for (int32_t x = 0; x < SECTOR_SIZE; ++x) {
+			sector->walkable.set(static_cast<size_t>(y * SECTOR_SIZE + x), isWalkable(baseX + x, baseY + y, z));
+		}
+	}
+
+	// One portal in the middle of every run of walkable tiles along a border
+	const auto addPortals = [this, &sector, z](Side side, int32_t insideX, int32_t insideY, int32_t stepX, int32_t stepY, int32_t outX, int32_t outY) {
+		int32_t runStart = -1;
+		for (int32_t i = 0; i <= SECTOR_SIZE; ++i) {
+			const int32_t x = insideX + stepX * i;
+			const int32_t y = insideY + stepY * i;
+			const int32_t ox = x + outX;
+			const int32_t oy = y + outY;
+			const bool crossing = i < SECTOR_SIZE && ox >= 0 && oy >= 0 && ox <= std::numeric_limits<uint16_t>::max() && oy <= std::numeric_limits<uint16_t>::max()
+				&& sector->walkable.test(getSlot(static_cast<uint16_t>(x), static_cast<uint16_t>(y))) && isWalkable(static_cast<uint16_t>(ox), static_cast<uint16_t>(oy), z);
+			if (crossing && runStart < 0) {
+				runStart = i;
+			} else if (!crossing && runStart >= 0) {
+				const int32_t middle = (runStart + i - 1) / 2;
+				const Position pos(static_cast<uint16_t>(insideX + stepX * middle), static_cast<uint16_t>(insideY + stepY * middle), z);
+				if (const auto it = std::ranges::find(sector->portals, pos, &Portal::pos); it != sector->portals.end()) {
+					it->sides |= side;
+				} else {
+					sector->portals.push_back({ pos, static_cast<uint8_t>(side) });
+				}
+				runStart = -1;
+			}
+		}
+	};
+	const int32_t lastX = baseX + SECTOR_SIZE - 1;
+	const int32_t lastY = baseY + SECTOR_SIZE - 1;
+	addPortals(SIDE_NORTH, baseX, baseY, 1, 0, 0, -1);
+	addPortals(SIDE_EAST, lastX, baseY, 0, 1, 1, 0);
+	addPortals(SIDE_SOUTH, baseX, lastY, 1, 0, 0, 1);
+	addPortals(SIDE_WEST, baseX, baseY, 0, 1, -1, 0);
+
+	const size_t count = sector->portals.size();
+	sector->costs.resize(count * count, NO_ROUTE);
+	for (size_t from = 0; from < count; ++from) {
+		const auto costs = getCostsFrom(*sector, sector->portals[from].pos);
+		for (size_t to = 0; to < count; ++to) {
+			sector->costs[from * count + to] = costs[getSlot(sector->portals[to].pos.x, sector->portals[to].pos.y)];
+		}
+	}
+	return sector;
+}
+
+uint32_t SectorRoutePlanner::getSectorVersion(uint16_t baseX, uint16_t baseY) const {
+	// Portals also depend on the border tiles of the four neighbours
+	uint32_t version = getVersion(baseX, baseY);
+	if (baseX >= SECTOR_SIZE) {
+		version += getVersion(baseX - SECTOR_SIZE, baseY);
+	}
+	if (baseY >= SECTOR_SIZE) {
+		version += getVersion(baseX, baseY - SECTOR_SIZE);
+	}
+	if (baseX + SECTOR_SIZE <= std::numeric_limits<uint16_t>::max()) {
+		version += getVersion(baseX + SECTOR_SIZE, baseY);
+	}
+	if (baseY + SECTOR_SIZE <= std::numeric_limits<uint16_t>::max()) {
+		version += getVersion(baseX, baseY + SECTOR_SIZE);
+	}
+	return version;
+}
@@ -0,0 +1,107 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+#include "map/map_const.hpp"
+
+/**
+ * @brief Plans routes too long for the tile search over a graph of map sectors.
+ *
+ * Where a run of walkable tiles crosses the border of two sectors of a floor,
+ * the tile in the middle of the run is a portal of both. Portals of a sector are
+ * linked by their walking cost inside it, and a route is an A* search over the
+ * portals, so its cost grows with the sectors it crosses instead of the tiles.
+ *
+ * Walkability is static: creatures and what only blocks some of them are left
+ * to the tile search that walks each leg. The portals of a sector are cached
+ * and rebuilt when the tile version of the sector or of a neighbour changes.
+ * Thread safe.
+ */
+class SectorRoutePlanner {
+public:
+	using IsWalkable = std::function<bool(uint16_t x, uint16_t y, uint8_t z)>;
+	// Version of the tiles of the sector holding the position, growing with every change
+	using GetVersion = std::function<uint32_t(uint16_t x, uint16_t y)>;
+
+	// Portals expanded by a route search before it gives up
+	static constexpr uint32_t MAX_EXPANDED_PORTALS = 4096;
+	static constexpr size_t MAX_CACHED_SECTORS = 16384;
+	// As AStarNodes::getMapWalkCost
+	static constexpr uint32_t STRAIGHT_COST = 10;
+	static constexpr uint32_t DIAGONAL_COST = 35;
+
+	SectorRoutePlanner(IsWalkable isWalkable, GetVersion getVersion) :
+		isWalkable(std::move(isWalkable)), getVersion(std::move(getVersion)) { }
+
+	/**
+	 * @return Where the route enters each sector after the first, followed by
+	 * the goal. Empty when there is no route or start and goal are on different floors.
+	 */
+	std::vector<Position> findRoute(const Position &start, const Position &goal);
+
+	void clear();
+
+	/**
+	 * @brief Reports map_path_sector_routes and map_path_sector_portals_expanded since the previous report.
+	 */
+	void reportMetrics();
+
+private:
+	static constexpr uint32_t NO_ROUTE = std::numeric_limits<uint32_t>::max();
+	static constexpr size_t SECTOR_TILES = SECTOR_SIZE * SECTOR_SIZE;
+
+	enum Side : uint8_t {
+		SIDE_NORTH = 1 << 0,
+		SIDE_EAST = 1 << 1,
+		SIDE_SOUTH = 1 << 2,
+		SIDE_WEST = 1 << 3,
+	};
+
+	struct Portal {
+		Position pos;
+		// Sides it crosses, a corner tile can cross two
+		uint8_t sides = 0;
+	};
+
+	struct Sector {
+		uint32_t version = 0;
+		std::bitset<SECTOR_TILES> walkable;
+		std::vector<Portal> portals;
+		// costs[i * portals.size() + j], walking from portal i to portal j inside the sector
+		std::vector<uint32_t> costs;
+	};
+
+	static uint64_t getSectorKey(uint16_t x, uint16_t y, uint8_t z) {
+		return (static_cast<uint64_t>(x / SECTOR_SIZE) << 24) | (static_cast<uint64_t>(y / SECTOR_SIZE) << 8) | z;
+	}
+
+	static size_t getSlot(uint16_t x, uint16_t y) {
+		return (y & SECTOR_MASK) * SECTOR_SIZE + (x & SECTOR_MASK);
+	}
+
+	/**
+	 * @brief Walking costs from a tile to every tile of its sector, NO_ROUTE where it cannot get.
+	 */
+	static std::array<uint32_t, SECTOR_TILES> getCostsFrom(const Sector &sector, const Position &from);
+
+	std::shared_ptr<const Sector> getSector(uint16_t x, uint16_t y, uint8_t z);
+	std::shared_ptr<Sector> buildSector(uint16_t baseX, uint16_t baseY, uint8_t z, uint32_t version) const;
+	uint32_t getSectorVersion(uint16_t baseX, uint16_t baseY) const;
+
+	IsWalkable isWalkable;
+	GetVersion getVersion;
+
+	std::mutex mutex;
+	phmap::flat_hash_map<uint64_t, std::shared_ptr<const Sector>> sectors;
+
+	std::atomic<uint64_t> routes = 0;
+	std::atomic<uint64_t> portalsExpanded = 0;
+};
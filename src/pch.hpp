@@ -45,6 +45,7 @@
 #include <numeric>
 #include <cmath>
 #include <mutex>
+#include <shared_mutex>
 #include <stack>
 #include <source_location>
 #include <span>
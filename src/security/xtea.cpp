@@ -0,0 +1,175 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "security/xtea.hpp"
+
+#include "utils/simd.hpp"
+
+namespace {
+	constexpr uint32_t delta = 0x61C88647;
+	constexpr size_t rounds = 32;
+
+	// The key and sum of each half round, in the order they are applied
+	using RoundKeys = std::array<std::array<uint32_t, 2>, rounds>;
+
+	RoundKeys getRoundKeys(const XTEA::Key &key, bool encrypt) {
+		RoundKeys roundKeys;
+		uint32_t sum = encrypt ? 0 : 0xC6EF3720;
+		if (encrypt) {
+			for (size_t i = 0; i < rounds; ++i) {
+				roundKeys[i][0] = sum + key[sum & 3];
+				sum -= delta;
+				roundKeys[i][1] = sum + key[(sum >> 11) & 3];
+			}
+		} else {
+			for (size_t i = 0; i < rounds; ++i) {
+				roundKeys[i][0] = sum + key[(sum >> 11) & 3];
+				sum += delta;
+				roundKeys[i][1] = sum + key[sum & 3];
+			}
+		}
+		return roundKeys;
+	}
+
+	void transformScalar(uint8_t* buffer, size_t blocks, const RoundKeys &roundKeys, bool encrypt) {
+		for (size_t block = 0; block < blocks; ++block) {
+			uint8_t* data = buffer + block * 8;
+			uint32_t v0;
+			uint32_t v1;
+			std::memcpy(&v0, data, sizeof(v0));
+			std::memcpy(&v1, data + 4, sizeof(v1));
+
+			if (encrypt) {
+				for (const auto &[key0, key1] : roundKeys) {
+					v0 += ((v1 << 4 ^ v1 >> 5) + v1) ^ key0;
+					v1 += ((v0 << 4 ^ v0 >> 5) + v0) ^ key1;
+				}
+			} else {
+				for (const auto &[key0, key1] : roundKeys) {
+					v1 -= ((v0 << 4 ^ v0 >> 5) + v0) ^ key0;
+					v0 -= ((v1 << 4 ^ v1 >> 5) + v1) ^ key1;
+				}
+			}
+
+			std::memcpy(data, &v0, sizeof(v0));
+			std::memcpy(data + 4, &v1, sizeof(v1));
+		}
+	}
+
+#if defined(SIMD_RUNTIME_DISPATCH)
+	// Each kernel loads two registers of interleaved blocks, splits them into the
+	// first and second words of every block and interleaves them back. Shuffles
+	// and unpacks work per 128 bit lane, so the round trip keeps the block order.
+	// Returns how many blocks it transformed.
+
+	SIMD_TARGET("sse2") size_t transformSSE2(uint8_t* buffer, size_t blocks, const RoundKeys &roundKeys, bool encrypt) {
+		constexpr size_t lanes = 4;
+		const size_t count = blocks - blocks % lanes;
+		for (size_t block = 0; block < count; block += lanes) {
+			auto* data = reinterpret_cast<__m128i*>(buffer + block * 8);
+			const __m128 low = _mm_castsi128_ps(_mm_loadu_si128(data));
+			const __m128 high = _mm_castsi128_ps(_mm_loadu_si128(data + 1));
+			__m128i v0 = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+			__m128i v1 = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+			if (encrypt) {
+				for (const auto &[key0, key1] : roundKeys) {
+					v0 = _mm_add_epi32(v0, _mm_xor_si128(_mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v1, 4), _mm_srli_epi32(v1, 5)), v1), _mm_set1_epi32(static_cast<int>(key0))));
+					v1 = _mm_add_epi32(v1, _mm_xor_si128(_mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v0, 4), _mm_srli_epi32(v0, 5)), v0), _mm_set1_epi32(static_cast<int>(key1))));
+				}
+			} else {
+				for (const auto &[key0, key1] : roundKeys) {
+					v1 = _mm_sub_epi32(v1, _mm_xor_si128(_mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v0, 4), _mm_srli_epi32(v0, 5)), v0), _mm_set1_epi32(static_cast<int>(key0))));
+					v0 = _mm_sub_epi32(v0, _mm_xor_si128(_mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v1, 4), _mm_srli_epi32(v1, 5)), v1), _mm_set1_epi32(static_cast<int>(key1))));
+				}
+			}
+
+			_mm_storeu_si128(data, _mm_unpacklo_epi32(v0, v1));
+			_mm_storeu_si128(data + 1, _mm_unpackhi_epi32(v0, v1));
+		}
+		return count;
+	}
+
+	SIMD_TARGET("avx2") size_t transformAVX2(uint8_t* buffer, size_t blocks, const RoundKeys &roundKeys, bool encrypt) {
+		constexpr size_t lanes = 8;
+		const size_t count = blocks - blocks % lanes;
+		for (size_t block = 0; block < count; block += lanes) {
+			auto* data = reinterpret_cast<__m256i*>(buffer + block * 8);
+			const __m256 low = _mm256_castsi256_ps(_mm256_loadu_si256(data));
+			const __m256 high = _mm256_castsi256_ps(_mm256_loadu_si256(data + 1));
+			__m256i v0 = _mm256_castps_si256(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+			__m256i v1 = _mm256_castps_si256(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+			if (encrypt) {
+				for (const auto &[key0, key1] : roundKeys) {
+					v0 = _mm256_add_epi32(v0, _mm256_xor_si256(_mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v1, 4), _mm256_srli_epi32(v1, 5)), v1), _mm256_set1_epi32(static_cast<int>(key0))));
+					v1 = _mm256_add_epi32(v1, _mm256_xor_si256(_mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v0, 4), _mm256_srli_epi32(v0, 5)), v0), _mm256_set1_epi32(static_cast<int>(key1))));
+				}
+			} else {
+				for (const auto &[key0, key1] : roundKeys) {
+					v1 = _mm256_sub_epi32(v1, _mm256_xor_si256(_mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v0, 4), _mm256_srli_epi32(v0, 5)), v0), _mm256_set1_epi32(static_cast<int>(key0))));
+					v0 = _mm256_sub_epi32(v0, _mm256_xor_si256(_mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v1, 4), _mm256_srli_epi32(v1, 5)), v1), _mm256_set1_epi32(static_cast<int>(key1))));
+				}
+			}
+
+			_mm256_storeu_si256(data, _mm256_unpacklo_epi32(v0, v1));
+			_mm256_storeu_si256(data + 1, _mm256_unpackhi_epi32(v0, v1));
+		}
+		return count;
+	}
+
+	SIMD_TARGET("avx512f") size_t transformAVX512(uint8_t* buffer, size_t blocks, const RoundKeys &roundKeys, bool encrypt) {
+		constexpr size_t lanes = 16;
+		const size_t count = blocks - blocks % lanes;
+		for (size_t block = 0; block < count; block += lanes) {
+			uint8_t* data = buffer + block * 8;
+			const __m512 low = _mm512_castsi512_ps(_mm512_loadu_si512(data));
+			const __m512 high = _mm512_castsi512_ps(_mm512_loadu_si512(data + 64));
+			__m512i v0 = _mm512_castps_si512(_mm512_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+			__m512i v1 = _mm512_castps_si512(_mm512_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+			if (encrypt) {
+				for (const auto &[key0, key1] : roundKeys) {
+					v0 = _mm512_add_epi32(v0, _mm512_xor_si512(_mm512_add_epi32(_mm512_xor_si512(_mm512_slli_epi32(v1, 4), _mm512_srli_epi32(v1, 5)), v1), _mm512_set1_epi32(static_cast<int>(key0))));
+					v1 = _mm512_add_epi32(v1, _mm512_xor_si512(_mm512_add_epi32(_mm512_xor_si512(_mm512_slli_epi32(v0, 4), _mm512_srli_epi32(v0, 5)), v0), _mm512_set1_epi32(static_cast<int>(key1))));
+				}
+			} else {
+				for (const auto &[key0, key1] : roundKeys) {
+					v1 = _mm512_sub_epi32(v1, _mm512_xor_si512(_mm512_add_epi32(_mm512_xor_si512(_mm512_slli_epi32(v0, 4), _mm512_srli_epi32(v0, 5)), v0), _mm512_set1_epi32(static_cast<int>(key0))));
+					v0 = _mm512_sub_epi32(v0, _mm512_xor_si512(_mm512_add_epi32(_mm512_xor_si512(_mm512_slli_epi32(v1, 4), _mm512_srli_epi32(v1, 5)), v1), _mm512_set1_epi32(static_cast<int>(key1))));
+				}
+			}
+
+			_mm512_storeu_si512(data, _mm512_unpacklo_epi32(v0, v1));
+			_mm512_storeu_si512(data + 64, _mm512_unpackhi_epi32(v0, v1));
+		}
+		return count;
+	}
+#endif
+}
+
+void XTEA::transform(uint8_t* buffer, size_t length, const Key &key, bool encrypt, [[maybe_unused]] SimdLevel level) {
+	const RoundKeys roundKeys = getRoundKeys(key, encrypt);
+	const size_t blocks = length / 8;
+	size_t done = 0;
+
+#if defined(SIMD_RUNTIME_DISPATCH)
+	if (level >= SimdLevel::AVX512) {
+		done += transformAVX512(buffer, blocks, roundKeys, encrypt);
+	}
+	if (level >= SimdLevel::AVX2) {
+		done += transformAVX2(buffer + done * 8, blocks - done, roundKeys, encrypt);
+	}
+	if (level >= SimdLevel::SSE2) {
+		done += transformSSE2(buffer + done * 8, blocks - done, roundKeys, encrypt);
+	}
+#endif
+
+	transformScalar(buffer + done * 8, blocks - done, roundKeys, encrypt);
+}
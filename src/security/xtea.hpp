@@ -0,0 +1,40 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "utils/cpu_features.hpp"
+
+/**
+ * @brief XTEA with 32 cycles over the 8 byte blocks of a message, as the client uses it.
+ *
+ * Blocks are independent, so they are transformed 16, 8 or 4 at a time with
+ * AVX-512, AVX2 or SSE2, the widest getSimdLevel() allows, and the rest one by
+ * one. Every path gives the same bytes.
+ */
+class XTEA {
+public:
+	using Key = std::array<uint32_t, 4>;
+
+	/**
+	 * @param length Bytes to transform, a multiple of 8.
+	 */
+	static void encrypt(uint8_t* buffer, size_t length, const Key &key) {
+		transform(buffer, length, key, true, getSimdLevel());
+	}
+
+	static void decrypt(uint8_t* buffer, size_t length, const Key &key) {
+		transform(buffer, length, key, false, getSimdLevel());
+	}
+
+	/**
+	 * @brief Transforms with at most the given instruction set, which must be supported by the CPU.
+	 */
+	static void transform(uint8_t* buffer, size_t length, const Key &key, bool encrypt, SimdLevel level);
+};
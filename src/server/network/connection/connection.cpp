@@ -8,6 +8,7 @@
  */
 
 #include "server/network/connection/connection.hpp"
+#include "server/network/connection/io_shard.hpp"
 
 #include "config/configmanager.hpp"
 #include "lib/di/container.hpp"
@@ -23,8 +24,8 @@ ConnectionManager &ConnectionManager::getInstance() {
 	return inject<ConnectionManager>();
 }
 
-Connection_ptr ConnectionManager::createConnection(asio::io_service &io_service, const ConstServicePort_ptr &servicePort) {
-	auto connection = std::make_shared<Connection>(io_service, servicePort);
+Connection_ptr ConnectionManager::createConnection(const std::shared_ptr<IOShard> &shard, const ConstServicePort_ptr &servicePort) {
+	auto connection = std::make_shared<Connection>(shard, servicePort);
 	connections.emplace(connection);
 	return connection;
 }
@@ -51,11 +52,16 @@ void ConnectionManager::closeAll() {
 	connections.clear();
 }
 
-Connection::Connection(asio::io_service &initIoService, ConstServicePort_ptr initservicePort) :
-	readTimer(initIoService),
-	writeTimer(initIoService),
+Connection::Connection(std::shared_ptr<IOShard> initShard, ConstServicePort_ptr initservicePort) :
+	shard(std::move(initShard)),
+	readTimer(shard->getContext()),
+	writeTimer(shard->getContext()),
 	service_port(std::move(initservicePort)),
-	socket(initIoService), m_msg() {
+	socket(shard->getContext()), m_msg() {
+}
+
+Connection::~Connection() {
+	shard->addQueuedMessages(-static_cast<int64_t>(messageQueue.size()));
 }
 
 void Connection::close(bool force) {
@@ -159,6 +165,7 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 					readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 					// Read the remainder of proxy identification
+					m_msg.reserve(remainder);
 					asio::async_read(socket, asio::buffer(m_msg.getBuffer(), remainder), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseProxyIdentification(error); });
 				} catch (const std::system_error &e) {
 					g_logger().error("Connection::parseProxyIdentification] - error: {}", e.what());
@@ -184,6 +191,7 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 }
 
 void Connection::parseHeader(const std::error_code &error) {
+	const auto busy = shard->measureBusy();
 	std::scoped_lock lock(connectionLock);
 	readTimer.cancel();
 
@@ -224,6 +232,7 @@ void Connection::parseHeader(const std::error_code &error) {
 		readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 		// Read packet content
+		m_msg.reserve(size + HEADER_LENGTH);
 		m_msg.setLength(size + HEADER_LENGTH);
 		// Read the remainder of proxy identification
 		asio::async_read(socket, asio::buffer(m_msg.getBodyBuffer(), size), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parsePacket(error); });
@@ -234,6 +243,7 @@ void Connection::parseHeader(const std::error_code &error) {
 }
 
 void Connection::parsePacket(const std::error_code &error) {
+	const auto busy = shard->measureBusy();
 	std::scoped_lock lock(connectionLock);
 	readTimer.cancel();
 
@@ -320,6 +330,7 @@ void Connection::send(const OutputMessage_ptr &outputMessage) {
 
 	bool noPendingWrite = messageQueue.empty();
 	messageQueue.emplace_back(outputMessage);
+	shard->addQueuedMessages(1);
 
 	if (noPendingWrite) {
 		if (socket.is_open()) {
@@ -337,6 +348,7 @@ void Connection::send(const OutputMessage_ptr &outputMessage) {
 }
 
 void Connection::internalWorker() {
+	const auto busy = shard->measureBusy();
 	std::unique_lock lock(connectionLock);
 	if (messageQueue.empty()) {
 		if (connectionState == CONNECTION_STATE_CLOSED) {
@@ -345,12 +357,7 @@ void Connection::internalWorker() {
 		return;
 	}
 
-	const auto &outputMessage = messageQueue.front();
-	lock.unlock();
-	protocol->onSendMessage(outputMessage);
-	lock.lock();
-
-	internalSend(outputMessage);
+	internalSend(lock);
 }
 
 uint32_t Connection::getIP() {
@@ -369,12 +376,36 @@ uint32_t Connection::getIP() {
 	return ip;
 }
 
-void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
+void Connection::internalSend(std::unique_lock<std::recursive_mutex> &lock) {
+	// Gathers the queued messages into one write, up to maxBytesPerFlush of compressed and encrypted
+	// bytes unless a single message is bigger. Messages are encoded in queue order, as the sequence
+	// checksum requires: the one that does not fit stays encoded at the front of the queue for the next write.
+	const auto maxBytes = static_cast<size_t>(std::max<int32_t>(0, g_configManager().getNumber(MAX_BYTES_PER_FLUSH)));
+	writeBuffers.clear();
+	size_t batchBytes = 0;
+	size_t index = 0;
+	for (auto it = messageQueue.begin(); it != messageQueue.end(); ++it, ++index) {
+		const auto outputMessage = *it;
+		if (index >= encodedMessages) {
+			lock.unlock();
+			protocol->onSendMessage(outputMessage);
+			lock.lock();
+			++encodedMessages;
+		}
+
+		if (!writeBuffers.empty() && batchBytes + outputMessage->getLength() > maxBytes) {
+			break;
+		}
+		batchBytes += outputMessage->getLength();
+		writeBuffers.emplace_back(outputMessage->getOutputBuffer(), outputMessage->getLength());
+	}
+	shard->addWrite(writeBuffers.size(), batchBytes);
+
 	writeTimer.expires_from_now(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
 	writeTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 	try {
-		asio::async_write(socket, asio::buffer(outputMessage->getOutputBuffer(), outputMessage->getLength()), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error); });
+		asio::async_write(socket, writeBuffers, [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error); });
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::internalSend] - Exception in async_write: {}", e.what());
 		close(FORCE_CLOSE);
@@ -382,24 +413,27 @@ void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
 }
 
 void Connection::onWriteOperation(const std::error_code &error) {
+	const auto busy = shard->measureBusy();
 	std::unique_lock lock(connectionLock);
 	writeTimer.cancel();
 
 	if (error) {
 		g_logger().error("[Connection::onWriteOperation] - Write error: {}", error.message());
+		shard->addQueuedMessages(-static_cast<int64_t>(messageQueue.size()));
 		messageQueue.clear();
+		encodedMessages = 0;
 		close(FORCE_CLOSE);
 		return;
 	}
 
-	messageQueue.pop_front();
+	const auto written = std::min(writeBuffers.size(), messageQueue.size());
+	messageQueue.erase(messageQueue.begin(), std::next(messageQueue.begin(), static_cast<std::ptrdiff_t>(written)));
+	encodedMessages -= std::min(encodedMessages, written);
+	shard->addQueuedMessages(-static_cast<int64_t>(written));
+	writeBuffers.clear();
 
 	if (!messageQueue.empty()) {
-		const auto &outputMessage = messageQueue.front();
-		lock.unlock();
-		protocol->onSendMessage(outputMessage);
-		lock.lock();
-		internalSend(outputMessage);
+		internalSend(lock);
 	} else if (connectionState == CONNECTION_STATE_CLOSED) {
 		closeSocket();
 	}
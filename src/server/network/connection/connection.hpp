@@ -31,6 +31,7 @@ class ServicePort;
 using ServicePort_ptr = std::shared_ptr<ServicePort>;
 using ConstServicePort_ptr = std::shared_ptr<const ServicePort>;
 class NetworkMessage;
+class IOShard;
 
 class ConnectionManager {
 public:
@@ -38,7 +39,7 @@ public:
 
 	static ConnectionManager &getInstance();
 
-	Connection_ptr createConnection(asio::io_service &io_service, const ConstServicePort_ptr &servicePort);
+	Connection_ptr createConnection(const std::shared_ptr<IOShard> &shard, const ConstServicePort_ptr &servicePort);
 	void releaseConnection(const Connection_ptr &connection);
 	void closeAll();
 
@@ -49,11 +50,11 @@ private:
 class Connection : public std::enable_shared_from_this<Connection> {
 public:
 	// Constructor
-	Connection(asio::io_service &initIoService, ConstServicePort_ptr initservicePort);
+	Connection(std::shared_ptr<IOShard> initShard, ConstServicePort_ptr initservicePort);
 	// Constructor end
 
 	// Destructor
-	~Connection() = default;
+	~Connection();
 
 	// Singleton - ensures we don't accidentally copy it
 	Connection(const Connection &) = delete;
@@ -70,6 +71,10 @@ public:
 
 	uint32_t getIP();
 
+	IOShard &getShard() const {
+		return *shard;
+	}
+
 private:
 	void parseProxyIdentification(const std::error_code &error);
 	void parseHeader(const std::error_code &error);
@@ -81,18 +86,26 @@ private:
 
 	void closeSocket();
 	void internalWorker();
-	void internalSend(const OutputMessage_ptr &outputMessage);
+	void internalSend(std::unique_lock<std::recursive_mutex> &lock);
 
 	asio::ip::tcp::socket &getSocket() {
 		return socket;
 	}
 
+	// Keeps the io_context of the socket and timers alive, even past the shutdown of the shards.
+	// It runs on a single thread, so the handlers of the connection never run concurrently.
+	std::shared_ptr<IOShard> shard;
+
 	asio::high_resolution_timer readTimer;
 	asio::high_resolution_timer writeTimer;
 
 	std::recursive_mutex connectionLock;
 
 	std::list<OutputMessage_ptr> messageQueue;
+	// Messages at the front of the queue already compressed and encrypted
+	size_t encodedMessages = 0;
+	// Buffers of the messages at the front of the queue being written
+	std::vector<asio::const_buffer> writeBuffers;
 
 	ConstServicePort_ptr service_port;
 	Protocol_ptr protocol;
@@ -0,0 +1,122 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/connection/io_shard.hpp"
+
+#include "lib/metrics/metrics.hpp"
+#include "server/network/message/message_buffer.hpp"
+
+IOShard::IOShard(uint16_t id) :
+	work(asio::make_work_guard(context)),
+	metricsTimer(context),
+	id(id),
+	label(std::to_string(id)) {
+}
+
+IOShard::~IOShard() {
+	stop();
+}
+
+void IOShard::start() {
+	if (thread.joinable()) {
+		return;
+	}
+
+	scheduleMetrics();
+	thread = std::thread([this] {
+		try {
+			context.run();
+		} catch (const std::exception &e) {
+			g_logger().error("[IOShard::start] - Shard {} stopped on exception: {}", id, e.what());
+		}
+	});
+}
+
+void IOShard::stop() {
+	work.reset();
+	context.stop();
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+void IOShard::scheduleMetrics() {
+	metricsTimer.expires_after(std::chrono::seconds(1));
+	metricsTimer.async_wait([this](const std::error_code &error) {
+		if (error == asio::error::operation_aborted) {
+			return;
+		}
+		reportMetrics();
+		scheduleMetrics();
+	});
+}
+
+void IOShard::reportMetrics() {
+	const auto busy = busyNanos.exchange(0, std::memory_order_relaxed);
+	g_metrics().addCounter("network_shard_busy_ms", static_cast<double>(busy) / 1e6, { { "shard", label } });
+	// Busy nanoseconds of a one second interval, per thousand
+	load.store(static_cast<uint32_t>(std::min<uint64_t>(busy / 1000000, 1000)), std::memory_order_relaxed);
+
+	if (const auto inputBytes = compressionInputBytes.exchange(0, std::memory_order_relaxed)) {
+		g_metrics().addCounter("network_compression_input_bytes", static_cast<double>(inputBytes), { { "shard", label } });
+		g_metrics().addCounter("network_compression_output_bytes", static_cast<double>(compressionOutputBytes.exchange(0, std::memory_order_relaxed)), { { "shard", label } });
+		g_metrics().addCounter("network_compression_cpu_us", static_cast<double>(compressionNanos.exchange(0, std::memory_order_relaxed)) / 1e3, { { "shard", label } });
+	}
+	if (const auto skippedBytes = uncompressedBytes.exchange(0, std::memory_order_relaxed)) {
+		g_metrics().addCounter("network_compression_skipped_bytes", static_cast<double>(skippedBytes), { { "shard", label } });
+	}
+
+	if (const auto shardWrites = writes.exchange(0, std::memory_order_relaxed)) {
+		g_metrics().addCounter("network_shard_writes", static_cast<double>(shardWrites), { { "shard", label } });
+		g_metrics().addCounter("network_shard_write_messages", static_cast<double>(writtenMessages.exchange(0, std::memory_order_relaxed)), { { "shard", label } });
+		g_metrics().addCounter("network_shard_write_bytes", static_cast<double>(writtenBytes.exchange(0, std::memory_order_relaxed)), { { "shard", label } });
+	}
+
+	// Message blocks are shared by every shard, the first one reports them
+	if (id == 0) {
+		MessageBuffer::reportMetrics();
+	}
+
+	const auto queued = queuedMessages.load(std::memory_order_relaxed);
+	if (queued != reportedQueuedMessages) {
+		g_metrics().addUpDownCounter("network_shard_queue_depth", static_cast<int>(queued - reportedQueuedMessages), { { "shard", label } });
+		reportedQueuedMessages = queued;
+	}
+}
+
+IOShards::~IOShards() {
+	stop();
+}
+
+void IOShards::init(size_t count) {
+	if (!shards.empty()) {
+		return;
+	}
+
+	if (count == 0) {
+		count = std::clamp<size_t>(std::thread::hardware_concurrency() / 4, 1, 8);
+	}
+
+	shards.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		shards.emplace_back(std::make_shared<IOShard>(static_cast<uint16_t>(i)))->start();
+	}
+
+	g_logger().info("Running network I/O on {} thread{}", count, count > 1 ? "s" : "");
+}
+
+void IOShards::stop() {
+	for (const auto &shard : shards) {
+		shard->stop();
+	}
+}
+
+std::shared_ptr<IOShard> IOShards::next() {
+	return shards[nextShard.fetch_add(1, std::memory_order_relaxed) % shards.size()];
+}
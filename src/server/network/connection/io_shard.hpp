@@ -0,0 +1,156 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * @brief An io_context with its own thread, running the socket work of the connections assigned to it.
+ *
+ * Header parsing, XTEA decryption, compression and encryption of every connection
+ * of the shard run on its thread. The shard keeps the time its connections spent
+ * in those handlers, the number of output messages waiting to be written and
+ * the socket writes, reported every second as the network_shard_busy_ms,
+ * network_shard_queue_depth, network_shard_writes, network_shard_write_messages
+ * and network_shard_write_bytes metrics. Output compression of its connections
+ * is reported as network_compression_input_bytes, network_compression_output_bytes,
+ * network_compression_skipped_bytes and network_compression_cpu_us. The first shard
+ * also reports the message blocks of every size class, see MessageBuffer::reportMetrics.
+ */
+class IOShard {
+public:
+	/**
+	 * @brief Accumulates the time until destruction as busy time of the shard.
+	 */
+	class BusyScope {
+	public:
+		explicit BusyScope(IOShard &shard) :
+			shard(shard), start(std::chrono::steady_clock::now()) { }
+		~BusyScope() {
+			shard.busyNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+		}
+
+		BusyScope(const BusyScope &) = delete;
+		BusyScope &operator=(const BusyScope &) = delete;
+
+	private:
+		IOShard &shard;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	explicit IOShard(uint16_t id);
+	~IOShard();
+
+	// non-copyable
+	IOShard(const IOShard &) = delete;
+	IOShard &operator=(const IOShard &) = delete;
+
+	void start();
+	void stop();
+
+	asio::io_context &getContext() {
+		return context;
+	}
+
+	uint16_t getId() const {
+		return id;
+	}
+
+	[[nodiscard]] BusyScope measureBusy() {
+		return BusyScope(*this);
+	}
+
+	void addQueuedMessages(int64_t count) {
+		queuedMessages.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	void addWrite(size_t messages, size_t bytes) {
+		writes.fetch_add(1, std::memory_order_relaxed);
+		writtenMessages.fetch_add(messages, std::memory_order_relaxed);
+		writtenBytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	void addCompression(size_t inputBytes, size_t outputBytes, std::chrono::nanoseconds time) {
+		compressionInputBytes.fetch_add(inputBytes, std::memory_order_relaxed);
+		compressionOutputBytes.fetch_add(outputBytes, std::memory_order_relaxed);
+		compressionNanos.fetch_add(time.count(), std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Counts a message the compression policy sent as it was.
+	 */
+	void addUncompressed(size_t bytes) {
+		uncompressedBytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Busy time of the shard thread per thousand, over the last metrics interval.
+	 */
+	uint32_t getLoad() const {
+		return load.load(std::memory_order_relaxed);
+	}
+
+private:
+	void scheduleMetrics();
+	void reportMetrics();
+
+	asio::io_context context;
+	asio::executor_work_guard<asio::io_context::executor_type> work;
+	asio::steady_timer metricsTimer;
+	std::thread thread;
+
+	std::atomic<uint64_t> busyNanos = 0;
+	std::atomic<int64_t> queuedMessages = 0;
+	std::atomic<uint64_t> writes = 0;
+	std::atomic<uint64_t> writtenMessages = 0;
+	std::atomic<uint64_t> writtenBytes = 0;
+	std::atomic<uint64_t> compressionInputBytes = 0;
+	std::atomic<uint64_t> compressionOutputBytes = 0;
+	std::atomic<uint64_t> compressionNanos = 0;
+	std::atomic<uint64_t> uncompressedBytes = 0;
+	std::atomic<uint32_t> load = 0;
+	// Only touched by the thread of the shard
+	int64_t reportedQueuedMessages = 0;
+
+	const uint16_t id;
+	const std::string label;
+};
+
+/**
+ * @brief The I/O shards of the server, new connections are assigned to them round-robin.
+ */
+class IOShards {
+public:
+	IOShards() = default;
+	~IOShards();
+
+	// non-copyable
+	IOShards(const IOShards &) = delete;
+	IOShards &operator=(const IOShards &) = delete;
+
+	/**
+	 * @brief Creates and starts the shards, a count of 0 picks one per four hardware threads.
+	 *
+	 * Does nothing once the shards exist.
+	 */
+	void init(size_t count);
+	void stop();
+
+	/**
+	 * @brief Shared with the connections assigned to it, which may outlive the shards.
+	 */
+	std::shared_ptr<IOShard> next();
+
+	size_t size() const {
+		return shards.size();
+	}
+
+private:
+	std::vector<std::shared_ptr<IOShard>> shards;
+	std::atomic<size_t> nextShard = 0;
+};
@@ -0,0 +1,179 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/message/message_buffer.hpp"
+
+#include "lib/metrics/metrics.hpp"
+
+#include <atomic_queue/atomic_queue.h>
+
+namespace {
+	// Free blocks kept per size class, roughly 4 MB, 8 MB and 16 MB
+	constexpr std::array<size_t, MessageBuffer::SIZE_CLASSES.size()> FREE_LIST_CAPACITIES = { 8192, 2048, 256 };
+
+	template <size_t CAPACITY>
+	using FreeList = atomic_queue::AtomicQueue2<uint8_t*, CAPACITY>;
+
+	std::atomic<size_t> allocatedBytes = 0;
+	// Per size class, may briefly lag the free lists while a block moves in or out of them
+	std::array<std::atomic<int64_t>, MessageBuffer::SIZE_CLASSES.size()> inUseBlocks {};
+	std::array<std::atomic<int64_t>, MessageBuffer::SIZE_CLASSES.size()> freeBlocks {};
+	// Only touched by MessageBuffer::reportMetrics
+	std::array<int64_t, MessageBuffer::SIZE_CLASSES.size()> reportedInUseBlocks {};
+	std::array<int64_t, MessageBuffer::SIZE_CLASSES.size()> reportedFreeBlocks {};
+
+	template <size_t SIZE_CLASS>
+	auto &getFreeList() {
+		static FreeList<FREE_LIST_CAPACITIES[SIZE_CLASS]> freeList;
+		return freeList;
+	}
+
+	template <typename F>
+	decltype(auto) withFreeList(size_t sizeClass, F &&f) {
+		switch (sizeClass) {
+			case 0:
+				return f(getFreeList<0>());
+			case 1:
+				return f(getFreeList<1>());
+			default:
+				return f(getFreeList<2>());
+		}
+	}
+}
+
+MessageBuffer::MessageBuffer() :
+	bytes(acquire(0)), capacity(SIZE_CLASSES[0]), used(HEADER_SIZE) { }
+
+MessageBuffer::~MessageBuffer() {
+	recycle(bytes, sizeClass);
+}
+
+MessageBuffer::MessageBuffer(const MessageBuffer &other) :
+	bytes(acquire(other.sizeClass)), capacity(SIZE_CLASSES[other.sizeClass]), used(std::max(other.used, HEADER_SIZE)), sizeClass(other.sizeClass) {
+	std::copy_n(other.bytes, other.used, bytes);
+}
+
+MessageBuffer &MessageBuffer::operator=(const MessageBuffer &other) {
+	if (this == &other) {
+		return *this;
+	}
+
+	if (!bytes || sizeClass != other.sizeClass) {
+		recycle(bytes, sizeClass);
+		bytes = acquire(other.sizeClass);
+		capacity = SIZE_CLASSES[other.sizeClass];
+		sizeClass = other.sizeClass;
+	}
+	std::copy_n(other.bytes, other.used, bytes);
+	used = std::max(other.used, HEADER_SIZE);
+	return *this;
+}
+
+MessageBuffer::MessageBuffer(MessageBuffer &&other) noexcept :
+	bytes(std::exchange(other.bytes, nullptr)), capacity(std::exchange(other.capacity, 0)), used(std::exchange(other.used, 0)), sizeClass(std::exchange(other.sizeClass, 0)) { }
+
+MessageBuffer &MessageBuffer::operator=(MessageBuffer &&other) noexcept {
+	if (this == &other) {
+		return *this;
+	}
+
+	recycle(bytes, sizeClass);
+	bytes = std::exchange(other.bytes, nullptr);
+	capacity = std::exchange(other.capacity, 0);
+	used = std::exchange(other.used, 0);
+	sizeClass = std::exchange(other.sizeClass, 0);
+	return *this;
+}
+
+bool MessageBuffer::reserve(size_t size) {
+	if (size <= capacity) {
+		used = std::max(used, size);
+		return true;
+	}
+
+	// A moved from buffer starts over from the smallest class
+	auto newClass = static_cast<uint8_t>(bytes ? sizeClass + 1 : 0);
+	while (newClass < SIZE_CLASSES.size() && SIZE_CLASSES[newClass] < size) {
+		++newClass;
+	}
+	if (newClass >= SIZE_CLASSES.size()) {
+		return false;
+	}
+
+	const auto block = acquire(newClass);
+	std::copy_n(bytes, used, block);
+	recycle(bytes, sizeClass);
+
+	bytes = block;
+	capacity = SIZE_CLASSES[newClass];
+	used = std::max(size, HEADER_SIZE);
+	sizeClass = newClass;
+	return true;
+}
+
+size_t MessageBuffer::getAllocatedBytes() {
+	return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+std::array<MessageBuffer::SizeClassUsage, MessageBuffer::SIZE_CLASSES.size()> MessageBuffer::getSizeClassUsage() {
+	std::array<SizeClassUsage, SIZE_CLASSES.size()> usage;
+	for (size_t i = 0; i < SIZE_CLASSES.size(); ++i) {
+		usage[i].blockSize = SIZE_CLASSES[i];
+		usage[i].inUse = static_cast<size_t>(std::max<int64_t>(0, inUseBlocks[i].load(std::memory_order_relaxed)));
+		usage[i].free = static_cast<size_t>(std::max<int64_t>(0, freeBlocks[i].load(std::memory_order_relaxed)));
+	}
+	return usage;
+}
+
+void MessageBuffer::reportMetrics() {
+	const auto usage = getSizeClassUsage();
+	for (size_t i = 0; i < usage.size(); ++i) {
+		const std::map<std::string, std::string> attrs { { "size_class", std::to_string(usage[i].blockSize) } };
+		const auto inUse = static_cast<int64_t>(usage[i].inUse);
+		if (inUse != reportedInUseBlocks[i]) {
+			g_metrics().addUpDownCounter("network_message_blocks_in_use", static_cast<int>(inUse - reportedInUseBlocks[i]), attrs);
+			reportedInUseBlocks[i] = inUse;
+		}
+		const auto free = static_cast<int64_t>(usage[i].free);
+		if (free != reportedFreeBlocks[i]) {
+			g_metrics().addUpDownCounter("network_message_blocks_free", static_cast<int>(free - reportedFreeBlocks[i]), attrs);
+			reportedFreeBlocks[i] = free;
+		}
+	}
+}
+
+uint8_t* MessageBuffer::acquire(size_t sizeClass) {
+	uint8_t* block;
+	if (withFreeList(sizeClass, [&block](auto &freeList) { return freeList.try_pop(block); })) {
+		freeBlocks[sizeClass].fetch_sub(1, std::memory_order_relaxed);
+	} else {
+		allocatedBytes.fetch_add(SIZE_CLASSES[sizeClass], std::memory_order_relaxed);
+		block = static_cast<uint8_t*>(::operator new(SIZE_CLASSES[sizeClass]));
+	}
+	inUseBlocks[sizeClass].fetch_add(1, std::memory_order_relaxed);
+
+	// A recycled block still holds the headers of its previous message
+	std::fill_n(block, HEADER_SIZE, 0);
+	return block;
+}
+
+void MessageBuffer::recycle(uint8_t* block, size_t sizeClass) {
+	if (!block) {
+		return;
+	}
+
+	inUseBlocks[sizeClass].fetch_sub(1, std::memory_order_relaxed);
+	if (withFreeList(sizeClass, [block](auto &freeList) { return freeList.try_push(block); })) {
+		freeBlocks[sizeClass].fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	allocatedBytes.fetch_sub(SIZE_CLASSES[sizeClass], std::memory_order_relaxed);
+	::operator delete(block);
+}
@@ -0,0 +1,133 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "utils/const.hpp"
+
+/**
+ * @brief Byte storage of a network message, sized by class and promoted as the message grows.
+ *
+ * A buffer starts with the smallest size class and moves to the next one, copying
+ * its bytes, when a write needs more room. Blocks of every class are recycled
+ * through lock-free free lists, so most messages, which are a few hundred bytes,
+ * no longer pin a whole NETWORKMESSAGE_MAXSIZE block.
+ *
+ * Every write is preceded by a reserve, so the largest reserved size is the part of
+ * the block holding message bytes, and the only part copies and promotions carry over.
+ */
+class MessageBuffer {
+public:
+	static constexpr std::array<size_t, 3> SIZE_CLASSES = { 512, 4096, NETWORKMESSAGE_MAXSIZE };
+
+	// Start of every block, zeroed on acquire: the headers OutputMessage prepends to the body live here
+	static constexpr size_t HEADER_SIZE = 8;
+
+	MessageBuffer();
+	~MessageBuffer();
+
+	MessageBuffer(const MessageBuffer &other);
+	MessageBuffer &operator=(const MessageBuffer &other);
+
+	// The moved from buffer is left without a block until its next reserve
+	MessageBuffer(MessageBuffer &&other) noexcept;
+	MessageBuffer &operator=(MessageBuffer &&other) noexcept;
+
+	uint8_t* data() {
+		return bytes;
+	}
+
+	const uint8_t* data() const {
+		return bytes;
+	}
+
+	/**
+	 * @return The capacity of the current block.
+	 */
+	size_t size() const {
+		return capacity;
+	}
+
+	/**
+	 * @return The largest size reserved so far, the bytes from the start of the block that hold the message.
+	 */
+	size_t getUsedBytes() const {
+		return used;
+	}
+
+	uint8_t* begin() {
+		return bytes;
+	}
+
+	uint8_t* end() {
+		return bytes + capacity;
+	}
+
+	const uint8_t* begin() const {
+		return bytes;
+	}
+
+	const uint8_t* end() const {
+		return bytes + capacity;
+	}
+
+	uint8_t &operator[](size_t index) {
+		return bytes[index];
+	}
+
+	uint8_t operator[](size_t index) const {
+		return bytes[index];
+	}
+
+	uint8_t &at(size_t index) {
+		if (index >= capacity) {
+			throw std::out_of_range("MessageBuffer::at");
+		}
+		return bytes[index];
+	}
+
+	/**
+	 * @brief Promotes the buffer to the smallest size class holding the given size, keeping its bytes.
+	 * @return False if the size exceeds the largest class.
+	 */
+	bool reserve(size_t size);
+
+	/**
+	 * @return The bytes of every block currently allocated, in use or waiting in a free list.
+	 */
+	static size_t getAllocatedBytes();
+
+	struct SizeClassUsage {
+		size_t blockSize = 0;
+		// Blocks held by buffers
+		size_t inUse = 0;
+		// Blocks waiting in the free list
+		size_t free = 0;
+	};
+
+	/**
+	 * @return The blocks of every size class, held by buffers or waiting in its free list.
+	 */
+	static std::array<SizeClassUsage, SIZE_CLASSES.size()> getSizeClassUsage();
+
+	/**
+	 * @brief Reports getSizeClassUsage as the network_message_blocks_in_use and
+	 * network_message_blocks_free metrics, per size_class. Called from one thread.
+	 */
+	static void reportMetrics();
+
+private:
+	static uint8_t* acquire(size_t sizeClass);
+	static void recycle(uint8_t* block, size_t sizeClass);
+
+	uint8_t* bytes = nullptr;
+	size_t capacity = 0;
+	size_t used = 0;
+	uint8_t sizeClass = 0;
+};
@@ -160,6 +160,10 @@ void NetworkMessage::addString(const std::string &value, const std::source_locat
 		g_logger().trace("[{}] called line '{}:{}' in '{}'", __FUNCTION__, location.line(), location.column(), location.function_name());
 	}
 
+	if (!buffer.reserve(info.position + stringLen + 2)) {
+		return;
+	}
+
 	auto len = static_cast<uint16_t>(stringLen);
 	add<uint16_t>(len);
 	// Using to copy the string into the buffer
@@ -195,6 +199,7 @@ void NetworkMessage::addByte(uint8_t value, std::source_location location /*= st
 
 	g_logger().trace("[{}] called line '{}:{}' in '{}'", __FUNCTION__, location.line(), location.column(), location.function_name());
 	try {
+		buffer.reserve(info.position + 1);
 		buffer.at(info.position++) = value;
 		info.length++;
 	} catch (const std::out_of_range &e) {
@@ -215,6 +220,9 @@ void NetworkMessage::addBytes(const char* bytes, size_t size) {
 		g_logger().error("[NetworkMessage::addBytes] - Exceded NetworkMessage max size: {}, actually size: {}", NETWORKMESSAGE_MAXSIZE, size);
 		return;
 	}
+	if (!buffer.reserve(info.position + size)) {
+		return;
+	}
 
 	if (std::memcpy(buffer.data() + info.position, bytes, size) == nullptr) {
 		g_logger().error("[NetworkMessage::addBytes] - memcpy failed while adding bytes");
@@ -229,6 +237,9 @@ void NetworkMessage::addPaddingBytes(size_t n) {
 		g_logger().error("[NetworkMessage::addPaddingBytes] - Cannot add padding bytes, buffer overflow");
 		return;
 	}
+	if (!buffer.reserve(info.position + n)) {
+		return;
+	}
 
 	std::fill(buffer.begin() + info.position, buffer.begin() + info.position + n, 0x33);
 	info.position += n;
@@ -284,6 +295,10 @@ bool NetworkMessage::canAdd(size_t size) const {
 	return (size + info.position) < MAX_BODY_LENGTH;
 }
 
+bool NetworkMessage::reserve(size_t size) {
+	return buffer.reserve(size);
+}
+
 bool NetworkMessage::canRead(int32_t size) const {
 	return size <= (info.length - (info.position - INITIAL_BUFFER_POSITION));
 }
@@ -299,6 +314,9 @@ void NetworkMessage::append(const NetworkMessage &other) {
 		std::cerr << "Cannot append message: not enough space in buffer.\n";
 		return;
 	}
+	if (!buffer.reserve(info.position + otherLength)) {
+		return;
+	}
 
 	if (std::memcpy(buffer.data() + info.position, other.getBuffer() + otherStartPos, otherLength) == nullptr) {
 		g_logger().error("[{}] memcpy failed while appending message", __FUNCTION__);
@@ -11,6 +11,7 @@
 
 #include "utils/const.hpp"
 #include "declarations.hpp"
+#include "server/network/message/message_buffer.hpp"
 
 class Item;
 class Creature;
@@ -27,6 +28,7 @@ public:
 	// 4 bytes for checksum
 	// 1 byte for padding message size
 	static constexpr MsgSize_t INITIAL_BUFFER_POSITION = 7;
+	static_assert(INITIAL_BUFFER_POSITION <= MessageBuffer::HEADER_SIZE, "Output headers must fit in the zeroed start of the buffer");
 
 	int32_t decodeHeader();
 
@@ -79,7 +81,7 @@ public:
 			return;
 		}
 
-		if (info.position + sizeof(T) > buffer.size()) {
+		if (!buffer.reserve(info.position + sizeof(T))) {
 			g_logger().error("Buffer overflow detected, current position: '{}', value size: '{}', buffer size: '{}'. Called at line '{}:{}' in '{}'", info.position, sizeof(T), buffer.size(), location.line(), location.column(), location.function_name());
 			return;
 		}
@@ -167,6 +169,11 @@ public:
 
 	bool canAdd(size_t size) const;
 
+	/**
+	 * @brief Grows the buffer to hold size bytes from its start, for reads into getBuffer or getBodyBuffer.
+	 */
+	bool reserve(size_t size);
+
 	bool canRead(int32_t size) const;
 
 	void append(const NetworkMessage &other);
@@ -179,5 +186,5 @@ protected:
 	};
 
 	NetworkMessageInfo info;
-	std::array<uint8_t, NETWORKMESSAGE_MAXSIZE> buffer = {};
+	MessageBuffer buffer;
 };
@@ -47,6 +47,10 @@ public:
 
 	void append(const NetworkMessage &msg) {
 		auto msgLen = msg.getLength();
+		if (!canAdd(msgLen) || !buffer.reserve(info.position + msgLen)) {
+			g_logger().error("[{}] not enough space to append message of length {}", __FUNCTION__, msgLen);
+			return;
+		}
 		if (std::memcpy(buffer.data() + info.position, msg.getBuffer() + INITIAL_BUFFER_POSITION, msgLen) == nullptr) {
 			g_logger().error("[{}] memcpy failed while appending message", __FUNCTION__);
 			return;
@@ -57,6 +61,10 @@ public:
 
 	void append(const OutputMessage_ptr &msg) {
 		auto msgLen = msg->getLength();
+		if (!canAdd(msgLen) || !buffer.reserve(info.position + msgLen)) {
+			g_logger().error("[{}] not enough space to append output message of length {}", __FUNCTION__, msgLen);
+			return;
+		}
 		if (std::memcpy(buffer.data() + info.position, msg->getBuffer() + INITIAL_BUFFER_POSITION, msgLen) == nullptr) {
 			g_logger().error("[{}] memcpy failed while appending output message", __FUNCTION__);
 			return;
@@ -0,0 +1,58 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/protocol/compression_policy.hpp"
+
+bool CompressionPolicy::shouldCompress(size_t size) {
+	if (size < MIN_SIZE) {
+		skippedBytes.fetch_add(size, std::memory_order_relaxed);
+		return false;
+	}
+
+	if (skipRemaining > 0) {
+		--skipRemaining;
+		skippedBytes.fetch_add(size, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+void CompressionPolicy::onCompressed(size_t inputSize, size_t outputSize, std::chrono::nanoseconds time) {
+	if (inputSize == 0) {
+		return;
+	}
+
+	inputBytes.fetch_add(inputSize, std::memory_order_relaxed);
+	outputBytes.fetch_add(outputSize, std::memory_order_relaxed);
+	compressionNanos.fetch_add(time.count(), std::memory_order_relaxed);
+
+	const auto sample = static_cast<uint32_t>(std::min<size_t>(outputSize * 1000 / inputSize, 2000));
+	ratio = (ratio * 7 + sample) / 8;
+	if (ratio > POOR_RATIO) {
+		skipRemaining = SKIP_MESSAGES;
+	}
+}
+
+int32_t CompressionPolicy::getLevel(int32_t configuredLevel, uint32_t loadPermille) {
+	if (loadPermille >= OVERLOADED_LOAD) {
+		return 1;
+	}
+	if (loadPermille >= BUSY_LOAD) {
+		return std::min(configuredLevel, 3);
+	}
+	return configuredLevel;
+}
+
+uint32_t CompressionPolicy::getTotalRatio() const {
+	const auto input = getInputBytes();
+	if (input == 0) {
+		return 0;
+	}
+	return static_cast<uint32_t>(getOutputBytes() * 1000 / input);
+}
@@ -0,0 +1,86 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * @brief Decides which output messages of a connection are deflated, and how hard.
+ *
+ * Messages under MIN_SIZE are sent as they are. The compression ratio of the
+ * recent messages is averaged, and while it is worse than POOR_RATIO the
+ * connection sends the next SKIP_MESSAGES messages uncompressed before trying
+ * again. The zlib level goes down from the configured one as the network
+ * thread of the connection gets busy.
+ *
+ * It also keeps the compression totals of its connection, next to the per
+ * shard metrics of IOShard: the shard sums show how much CPU compression costs
+ * a network thread, these show which connections it is spent on. They are
+ * written by the shard thread of the connection and may be read from any thread.
+ */
+class CompressionPolicy {
+public:
+	static constexpr size_t MIN_SIZE = 128;
+	// Compressed size per thousand bytes of input
+	static constexpr uint32_t POOR_RATIO = 900;
+	static constexpr uint32_t SKIP_MESSAGES = 32;
+	// Busy time of the network thread per thousand, from which the level is lowered
+	static constexpr uint32_t BUSY_LOAD = 500;
+	static constexpr uint32_t OVERLOADED_LOAD = 750;
+
+	bool shouldCompress(size_t size);
+
+	/**
+	 * @brief Records the result of deflating a message.
+	 * @param time Time spent in deflate for it.
+	 */
+	void onCompressed(size_t inputSize, size_t outputSize, std::chrono::nanoseconds time = {});
+
+	/**
+	 * @param loadPermille Busy time of the network thread per thousand, see IOShard::getLoad.
+	 */
+	static int32_t getLevel(int32_t configuredLevel, uint32_t loadPermille);
+
+	uint32_t getRatio() const {
+		return ratio;
+	}
+
+	uint64_t getInputBytes() const {
+		return inputBytes.load(std::memory_order_relaxed);
+	}
+
+	uint64_t getOutputBytes() const {
+		return outputBytes.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Bytes of the messages sent as they were, too small or skipped for a poor ratio.
+	 */
+	uint64_t getSkippedBytes() const {
+		return skippedBytes.load(std::memory_order_relaxed);
+	}
+
+	std::chrono::nanoseconds getCompressionTime() const {
+		return std::chrono::nanoseconds(compressionNanos.load(std::memory_order_relaxed));
+	}
+
+	/**
+	 * @return Compressed size per thousand bytes over every message of the connection, 0 before the first one.
+	 */
+	uint32_t getTotalRatio() const;
+
+private:
+	// Moving average of the compressed size per thousand bytes, starting as if messages compress well
+	uint32_t ratio = 0;
+	uint32_t skipRemaining = 0;
+
+	std::atomic<uint64_t> inputBytes = 0;
+	std::atomic<uint64_t> outputBytes = 0;
+	std::atomic<uint64_t> skippedBytes = 0;
+	std::atomic<uint64_t> compressionNanos = 0;
+};
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "server/server_definitions.hpp"
+#include "server/network/protocol/compression_policy.hpp"
 
 class OutputMessage;
 using OutputMessage_ptr = std::shared_ptr<OutputMessage>;
@@ -52,6 +53,13 @@ public:
 
 	void send(OutputMessage_ptr msg) const;
 
+	/**
+	 * @brief Output compression of this connection: its ratio, totals and deflate time.
+	 */
+	const CompressionPolicy &getCompressionPolicy() const {
+		return compressionPolicy;
+	}
+
 protected:
 	void disconnect() const;
 
@@ -87,17 +95,19 @@ private:
 
 		std::unique_ptr<z_stream> stream;
 		std::array<char, NETWORKMESSAGE_MAXSIZE> buffer {};
+		int32_t configuredLevel = 0;
+		int32_t level = 0;
 	};
 
-	void XTEA_transform(uint8_t* buffer, size_t messageLength, bool encrypt) const;
 	void XTEA_encrypt(OutputMessage &msg) const;
 	bool XTEA_decrypt(NetworkMessage &msg) const;
-	bool compression(OutputMessage &msg) const;
+	bool compression(OutputMessage &msg);
 
 	OutputMessage_ptr outputBuffer;
 
 	const ConnectionWeak_ptr connectionPtr;
 	std::array<uint32_t, 4> key = {};
+	CompressionPolicy compressionPolicy;
 	uint32_t serverSequenceNumber = 0;
 	uint32_t clientSequenceNumber = 0;
 	std::underlying_type_t<ChecksumMethods_t> checksumMethod = CHECKSUM_METHOD_NONE;
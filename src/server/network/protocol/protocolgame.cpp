@@ -39,11 +39,14 @@
 #include "io/iologindata.hpp"
 #include "io/iomarket.hpp"
 #include "io/ioprey.hpp"
+#include "io/login_pipeline.hpp"
 #include "items/items_classification.hpp"
 #include "items/weapons/weapons.hpp"
 #include "lua/creature/creatureevent.hpp"
 #include "lua/modules/modules.hpp"
 #include "server/network/message/outputmessage.hpp"
+#include "server/network/protocol/tile_description.hpp"
+#include "server/network/protocol/tile_effects.hpp"
 #include "utils/tools.hpp"
 #include "creatures/players/vocations/vocation.hpp"
 
@@ -621,40 +624,13 @@ void ProtocolGame::login(const std::string &name, uint32_t accountId, OperatingS
 			return;
 		}
 
-		if (!IOLoginData::loadPlayerById(player, player->getGUID(), false)) {
-			disconnectClient("Your character could not be loaded, please contact an adminstrator.");
-			return;
-		}
-
 		player->setOperatingSystem(operatingSystem);
 
-		const auto tile = g_game().map.getOrCreateTile(player->getLoginPosition());
-		// moving from a pz tile to a non-pz tile
-		if (maxOnline > 1 && player->getAccountType() < ACCOUNT_TYPE_GAMEMASTER && !tile->hasFlag(TILESTATE_PROTECTIONZONE)) {
-			auto maxOutsizePZ = g_configManager().getNumber(MAX_PLAYERS_OUTSIDE_PZ_PER_ACCOUNT);
-			auto accountPlayers = g_game().getPlayersByAccount(player->getAccount());
-			int countOutsizePZ = 0;
-			for (const auto &accountPlayer : accountPlayers) {
-				if (accountPlayer != player && accountPlayer->getTile() && !accountPlayer->getTile()->hasFlag(TILESTATE_PROTECTIONZONE)) {
-					++countOutsizePZ;
-				}
-			}
-			if (countOutsizePZ >= maxOutsizePZ) {
-				disconnectClient(fmt::format("You can only have {} character{} from your account outside of a protection zone.", maxOutsizePZ == 1 ? "one" : std::to_string(maxOutsizePZ), maxOutsizePZ > 1 ? "s" : ""));
-				return;
-			}
-		}
-
-		if (!g_game().placeCreature(player, player->getLoginPosition()) && !g_game().placeCreature(player, player->getTemplePosition(), false, true)) {
-			disconnectClient("Temple position is wrong. Please, contact the administrator.");
-			g_logger().warn("Player {} temple position is wrong", player->getName());
-			return;
+		// The queries and item deserialization run on the thread pool, placement continues in onPlayerLoaded
+		if (!g_loginPipeline().load(player, [self = getThis()](bool loaded) { self->onPlayerLoaded(loaded); })) {
+			disconnectClient("You are already logged in.");
 		}
-
-		player->lastIP = player->getIP();
-		player->lastLoginSaved = std::max<time_t>(time(nullptr), player->lastLoginSaved + 1);
-		player->loginProtectionTime = OTSYS_TIME() + g_configManager().getNumber(LOGIN_PROTECTION_TIME);
-		acceptPackets = true;
+		return;
 	} else {
 		if (eventConnect != 0 || !g_configManager().getBoolean(REPLACE_KICK_ON_LOGIN)) {
 			// Already trying to connect
@@ -678,6 +654,50 @@ void ProtocolGame::login(const std::string &name, uint32_t accountId, OperatingS
 	sendBosstiaryCooldownTimer();
 }
 
+void ProtocolGame::onPlayerLoaded(bool loaded) {
+	// dispatcher thread
+	if (isConnectionExpired() || !player) {
+		// The client left while its character was loading
+		return;
+	}
+
+	if (!loaded) {
+		disconnectClient("Your character could not be loaded, please contact an adminstrator.");
+		return;
+	}
+
+	const auto maxOnline = g_configManager().getNumber(MAX_PLAYERS_PER_ACCOUNT);
+	const auto tile = g_game().map.getOrCreateTile(player->getLoginPosition());
+	// moving from a pz tile to a non-pz tile
+	if (maxOnline > 1 && player->getAccountType() < ACCOUNT_TYPE_GAMEMASTER && !tile->hasFlag(TILESTATE_PROTECTIONZONE)) {
+		auto maxOutsizePZ = g_configManager().getNumber(MAX_PLAYERS_OUTSIDE_PZ_PER_ACCOUNT);
+		auto accountPlayers = g_game().getPlayersByAccount(player->getAccount());
+		int countOutsizePZ = 0;
+		for (const auto &accountPlayer : accountPlayers) {
+			if (accountPlayer != player && accountPlayer->getTile() && !accountPlayer->getTile()->hasFlag(TILESTATE_PROTECTIONZONE)) {
+				++countOutsizePZ;
+			}
+		}
+		if (countOutsizePZ >= maxOutsizePZ) {
+			disconnectClient(fmt::format("You can only have {} character{} from your account outside of a protection zone.", maxOutsizePZ == 1 ? "one" : std::to_string(maxOutsizePZ), maxOutsizePZ > 1 ? "s" : ""));
+			return;
+		}
+	}
+
+	if (!g_game().placeCreature(player, player->getLoginPosition()) && !g_game().placeCreature(player, player->getTemplePosition(), false, true)) {
+		disconnectClient("Temple position is wrong. Please, contact the administrator.");
+		g_logger().warn("Player {} temple position is wrong", player->getName());
+		return;
+	}
+
+	player->lastIP = player->getIP();
+	player->lastLoginSaved = std::max<time_t>(time(nullptr), player->lastLoginSaved + 1);
+	player->loginProtectionTime = OTSYS_TIME() + g_configManager().getNumber(LOGIN_PROTECTION_TIME);
+	acceptPackets = true;
+	OutputMessagePool::getInstance().addProtocolToAutosend(shared_from_this());
+	sendBosstiaryCooldownTimer();
+}
+
 void ProtocolGame::connect(const std::string &playerName, OperatingSystem_t operatingSystem) {
 	eventConnect = 0;
 
@@ -1469,25 +1489,41 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 		msg.add<uint16_t>(0x00); // Env effects
 	}
 
-	int32_t count;
-	std::shared_ptr<Item> ground = tile->getGround();
-	if (ground) {
-		AddItem(msg, ground);
-		count = 1;
-	} else {
-		count = 0;
-	}
+	// OTCR item shaders are per item, those clients always encode
+	const auto description = isOTCR ? nullptr : TileDescription::get(tile);
+	const bool cached = description && description->isCacheable();
 
+	int32_t count = 0;
 	const TileItemVector* items = tile->getItemList();
-	if (items) {
-		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-			AddItem(msg, *it);
+	if (cached) {
+		// Same limits as below, the player tile keeps a slot for the player
+		auto topItems = description->getTopItems();
+		if (tile->getPosition() == player->getPosition()) {
+			topItems = std::min<size_t>(topItems, 9);
+		} else if (topItems >= 10) {
+			description->write(msg, oldProtocol, 0, 10);
+			return;
+		}
 
-			count++;
-			if (count == 9 && tile->getPosition() == player->getPosition()) {
-				break;
-			} else if (count == 10) {
-				return;
+		description->write(msg, oldProtocol, 0, topItems);
+		count = static_cast<int32_t>(topItems);
+	} else {
+		std::shared_ptr<Item> ground = tile->getGround();
+		if (ground) {
+			AddItem(msg, ground);
+			count = 1;
+		}
+
+		if (items) {
+			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				AddItem(msg, *it);
+
+				count++;
+				if (count == 9 && tile->getPosition() == player->getPosition()) {
+					break;
+				} else if (count == 10) {
+					return;
+				}
 			}
 		}
 	}
@@ -1522,7 +1558,10 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 		}
 	}
 
-	if (items) {
+	if (cached) {
+		const auto first = description->getTopItems();
+		description->write(msg, oldProtocol, first, first + std::min<size_t>(description->getDownItems(), 10 - count));
+	} else if (items) {
 		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
 			AddItem(msg, *it);
 
@@ -6769,6 +6808,26 @@ void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendTileEffects(const TileEffects &effects, SourceEffect_t source) {
+	const auto &playerPos = player->getPosition();
+	NetworkMessage msg;
+	for (const auto &pos : effects.getPositions()) {
+		if (!canSee(pos)) {
+			continue;
+		}
+
+		if (!msg.canAdd(TileEffects::MAX_TILE_SIZE)) {
+			writeToOutputBuffer(msg);
+			msg.reset();
+		}
+		effects.write(msg, pos, oldProtocol, pos.z == playerPos.z, source);
+	}
+
+	if (msg.getLength() > 0) {
+		writeToOutputBuffer(msg);
+	}
+}
+
 void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 	if (oldProtocol && type > 0xFF) {
 		return;
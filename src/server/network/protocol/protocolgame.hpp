@@ -37,6 +37,7 @@ enum class HouseAuctionType : uint8_t;
 class NetworkMessage;
 class Player;
 class VIPGroup;
+class TileEffects;
 class Game;
 class House;
 class Container;
@@ -119,6 +120,7 @@ private:
 		return std::static_pointer_cast<ProtocolGame>(shared_from_this());
 	}
 	void connect(const std::string &playerName, OperatingSystem_t operatingSystem);
+	void onPlayerLoaded(bool loaded);
 	void disconnectClient(const std::string &message) const;
 	void writeToOutputBuffer(NetworkMessage &msg);
 
@@ -313,6 +315,7 @@ private:
 	void sendAllowBugReport();
 	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type);
 	void sendMagicEffect(const Position &pos, uint16_t type);
+	void sendTileEffects(const TileEffects &effects, SourceEffect_t source);
 	void removeMagicEffect(const Position &pos, uint16_t type);
 	void sendRestingStatus(uint8_t protection);
 	void sendCreatureHealth(const std::shared_ptr<Creature> &creature);
@@ -38,4 +38,6 @@ public:
 
 private:
 	static std::map<uint32_t, int64_t> ipConnectMap;
+	// Status requests are parsed on the threads of the network I/O shards
+	static std::mutex ipConnectMutex;
 };
@@ -0,0 +1,117 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/protocol/tile_description.hpp"
+
+#include "items/item.hpp"
+#include "items/tile.hpp"
+#include "server/network/message/networkmessage.hpp"
+
+std::shared_ptr<const TileDescription> TileDescription::get(const std::shared_ptr<Tile> &tile) {
+	const uint32_t version = tile->getDescriptionVersion();
+	if (auto cached = tile->getCachedDescription(); cached && cached->version == version) {
+		return cached;
+	}
+
+	auto description = build(tile, version);
+	tile->setCachedDescription(description);
+	return description;
+}
+
+bool TileDescription::isCacheable(const ItemType &it) {
+	return !it.isContainer() && !it.isPodium && it.upgradeClassification == 0 && !it.expire && !it.expireStop && !it.clockExpire && !it.wearOut && !it.isWrapKit;
+}
+
+void TileDescription::write(NetworkMessage &msg, bool oldProtocol, size_t first, size_t last) const {
+	const auto &encoding = encodings[oldProtocol ? 1 : 0];
+	last = std::min(last, encoding.offsets.size() - 1);
+	if (first >= last) {
+		return;
+	}
+
+	const auto begin = encoding.offsets[first];
+	msg.addBytes(reinterpret_cast<const char*>(encoding.bytes.data() + begin), encoding.offsets[last] - begin);
+}
+
+// Same layout as ProtocolGame::AddItem for the items accepted by isCacheable
+void TileDescription::Encoding::append(const ItemType &it, const Item &item, bool oldProtocol) {
+	const auto id = std::bit_cast<std::array<uint8_t, sizeof(uint16_t)>>(it.id);
+	bytes.insert(bytes.end(), id.begin(), id.end());
+
+	if (oldProtocol) {
+		bytes.push_back(0xFF);
+	}
+
+	if (it.stackable) {
+		bytes.push_back(static_cast<uint8_t>(std::min<uint16_t>(std::numeric_limits<uint8_t>::max(), item.getItemCount())));
+	}
+
+	if (it.isSplash() || it.isFluidContainer()) {
+		bytes.push_back(item.getAttribute<uint8_t>(ItemAttribute_t::FLUIDTYPE));
+	}
+
+	if (oldProtocol) {
+		if (it.animationType == ANIMATION_RANDOM) {
+			bytes.push_back(0xFE);
+		} else if (it.animationType == ANIMATION_DESYNC) {
+			bytes.push_back(0xFF);
+		}
+	}
+
+	offsets.push_back(static_cast<uint16_t>(bytes.size()));
+}
+
+std::shared_ptr<const TileDescription> TileDescription::build(const std::shared_ptr<Tile> &tile, uint32_t version) {
+	auto description = std::make_shared<TileDescription>();
+	description->version = version;
+
+	const auto uncacheable = [&description] {
+		description->cacheable = false;
+		description->encodings = {};
+		return description;
+	};
+
+	if (const auto &ground = tile->getGround()) {
+		if (!description->append(ground)) {
+			return uncacheable();
+		}
+		++description->topItems;
+	}
+
+	const TileItemVector* items = tile->getItemList();
+	if (!items) {
+		return description;
+	}
+
+	for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end && description->topItems < MAX_THINGS; ++it) {
+		if (!description->append(*it)) {
+			return uncacheable();
+		}
+		++description->topItems;
+	}
+
+	for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end && description->downItems < MAX_THINGS; ++it) {
+		if (!description->append(*it)) {
+			return uncacheable();
+		}
+		++description->downItems;
+	}
+	return description;
+}
+
+bool TileDescription::append(const std::shared_ptr<Item> &item) {
+	const ItemType &it = Item::items[item->getID()];
+	if (!isCacheable(it)) {
+		return false;
+	}
+
+	encodings[0].append(it, *item, false);
+	encodings[1].append(it, *item, true);
+	return true;
+}
@@ -0,0 +1,85 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Item;
+class ItemType;
+class NetworkMessage;
+class Tile;
+
+/**
+ * @brief Serialized items of a tile, as ProtocolGame::GetTileDescription writes them.
+ *
+ * Built once per tile version and shared by every client, so sending a map
+ * window only copies bytes for tiles nobody changed. Items whose bytes depend on
+ * the viewer or on the time (containers, podiums, timers, charges, tiers, wrap
+ * kits) make the whole tile uncacheable, as do OTCR item shaders.
+ *
+ * Ground and top items come first, then down items; creatures are written by the
+ * caller in between. Each section keeps at most MAX_THINGS items, the client
+ * never shows more than that per tile.
+ */
+class TileDescription {
+public:
+	static constexpr size_t MAX_THINGS = 10;
+
+	/**
+	 * @brief Returns the up-to-date description of the tile, building it when the cached one is stale.
+	 */
+	static std::shared_ptr<const TileDescription> get(const std::shared_ptr<Tile> &tile);
+
+	/**
+	 * @brief Whether the item is encoded the same way for every viewer.
+	 */
+	static bool isCacheable(const ItemType &it);
+
+	bool isCacheable() const {
+		return cacheable;
+	}
+
+	uint32_t getVersion() const {
+		return version;
+	}
+
+	/**
+	 * @brief Ground (when present) plus top items.
+	 */
+	size_t getTopItems() const {
+		return topItems;
+	}
+
+	size_t getDownItems() const {
+		return downItems;
+	}
+
+	/**
+	 * @brief Appends items [first, last) of the description, down items start at getTopItems().
+	 */
+	void write(NetworkMessage &msg, bool oldProtocol, size_t first, size_t last) const;
+
+private:
+	struct Encoding {
+		std::vector<uint8_t> bytes;
+		std::vector<uint16_t> offsets { 0 };
+
+		void append(const ItemType &it, const Item &item, bool oldProtocol);
+	};
+
+	static std::shared_ptr<const TileDescription> build(const std::shared_ptr<Tile> &tile, uint32_t version);
+
+	bool append(const std::shared_ptr<Item> &item);
+
+	uint32_t version = 0;
+	bool cacheable = true;
+	uint8_t topItems = 0;
+	uint8_t downItems = 0;
+	// Indexed by ProtocolGame::oldProtocol
+	std::array<Encoding, 2> encodings;
+};
@@ -0,0 +1,51 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/protocol/tile_effects.hpp"
+
+#include "server/network/message/networkmessage.hpp"
+#include "server/server_definitions.hpp"
+
+void TileEffects::write(NetworkMessage &msg, const Position &pos, bool oldProtocol, bool withSound, SourceEffect_t source) const {
+	if (oldProtocol) {
+		// Old clients have no sounds and a single byte effect
+		if (effect != CONST_ME_NONE && effect <= 0xFF) {
+			msg.addByte(0x83);
+			msg.addPosition(pos);
+			msg.addByte(static_cast<uint8_t>(effect));
+		}
+		return;
+	}
+
+	// Combat::combatTileEffects played the main sound alone when there was no secondary one
+	const bool doubleSound = withSound && secondarySound != SoundEffect_t::SILENCE;
+	const bool singleSound = withSound && !doubleSound && mainSound != SoundEffect_t::SILENCE;
+	if (effect == CONST_ME_NONE && !doubleSound && !singleSound) {
+		return;
+	}
+
+	msg.addByte(0x83);
+	msg.addPosition(pos);
+	if (effect != CONST_ME_NONE) {
+		msg.addByte(MAGIC_EFFECTS_CREATE_EFFECT);
+		msg.add<uint16_t>(effect);
+	}
+	if (doubleSound || singleSound) {
+		msg.addByte(MAGIC_EFFECTS_CREATE_SOUND_MAIN_EFFECT);
+		msg.addByte(static_cast<uint8_t>(source));
+		msg.add<uint16_t>(static_cast<uint16_t>(mainSound));
+	}
+	if (doubleSound) {
+		msg.addByte(MAGIC_EFFECTS_CREATE_SOUND_SECONDARY_EFFECT);
+		msg.addByte(0x01);
+		msg.addByte(static_cast<uint8_t>(source));
+		msg.add<uint16_t>(static_cast<uint16_t>(secondarySound));
+	}
+	msg.addByte(MAGIC_EFFECTS_END_LOOP);
+}
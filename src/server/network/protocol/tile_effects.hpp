@@ -0,0 +1,62 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "creatures/creatures_definitions.hpp"
+#include "game/movement/position.hpp"
+#include "utils/utils_definitions.hpp"
+
+class NetworkMessage;
+
+/**
+ * @brief The impact effect and sounds shown on the tiles hit by an area combat.
+ *
+ * Combat::CombatFunc collects the consecutive tiles hit without any damage or
+ * field in between, and each spectator receives them in one message write,
+ * instead of a magic effect and a sound packet per tile.
+ * Every tile is still its own 0x83 packet, carrying the effect and the sounds
+ * together as ProtocolGame::sendMagicEffect and sendDoubleSoundEffect write them.
+ */
+class TileEffects {
+public:
+	// 0x83, position, effect, main sound, secondary sound and the end of the loop
+	static constexpr size_t MAX_TILE_SIZE = 1 + 5 + 3 + 4 + 5 + 1;
+
+	TileEffects(uint16_t effect, SoundEffect_t mainSound, SoundEffect_t secondarySound) :
+		effect(effect), mainSound(mainSound), secondarySound(secondarySound) { }
+
+	void addPosition(const Position &pos) {
+		positions.emplace_back(pos);
+	}
+
+	const std::vector<Position> &getPositions() const {
+		return positions;
+	}
+
+	void clear() {
+		positions.clear();
+	}
+
+	bool empty() const {
+		return positions.empty() || (effect == CONST_ME_NONE && mainSound == SoundEffect_t::SILENCE && secondarySound == SoundEffect_t::SILENCE);
+	}
+
+	/**
+	 * @brief Appends the packet of one tile, if the client has anything to show for it.
+	 * @param withSound False for viewers on another floor, sounds are only played on the floor they come from.
+	 */
+	void write(NetworkMessage &msg, const Position &pos, bool oldProtocol, bool withSound, SourceEffect_t source) const;
+
+private:
+	std::vector<Position> positions;
+	uint16_t effect = CONST_ME_NONE;
+	SoundEffect_t mainSound = SoundEffect_t::SILENCE;
+	SoundEffect_t secondarySound = SoundEffect_t::SILENCE;
+};
@@ -26,6 +26,10 @@ void ServiceManager::die() {
 	io_service.stop();
 }
 
+void ServiceManager::initShards() {
+	shards.init(static_cast<size_t>(std::max<int32_t>(0, g_configManager().getNumber(NETWORK_IO_THREADS))));
+}
+
 void ServiceManager::run() {
 	if (running) {
 		g_logger().error("ServiceManager is already running!", __FUNCTION__);
@@ -35,6 +39,7 @@ void ServiceManager::run() {
 	assert(!running);
 	running = true;
 	io_service.run();
+	shards.stop();
 }
 
 void ServiceManager::stop() {
@@ -87,7 +92,7 @@ void ServicePort::accept() {
 		return;
 	}
 
-	auto connection = ConnectionManager::getInstance().createConnection(io_service, shared_from_this());
+	auto connection = ConnectionManager::getInstance().createConnection(shards.next(), shared_from_this());
 	acceptor->async_accept(connection->getSocket(), [self = shared_from_this(), connection](const std::error_code &error) { self->onAccept(connection, error); });
 }
 
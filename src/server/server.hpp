@@ -11,6 +11,7 @@
 
 #include "lib/metrics/metrics.hpp"
 #include "server/network/connection/connection.hpp"
+#include "server/network/connection/io_shard.hpp"
 #include "server/signals.hpp"
 
 class Protocol;
@@ -49,8 +50,8 @@ public:
 
 class ServicePort : public std::enable_shared_from_this<ServicePort> {
 public:
-	explicit ServicePort(asio::io_service &init_io_service) :
-		io_service(init_io_service) { }
+	ServicePort(asio::io_service &init_io_service, IOShards &init_shards) :
+		io_service(init_io_service), shards(init_shards) { }
 	~ServicePort();
 
 	// non-copyable
@@ -73,6 +74,7 @@ private:
 	void accept();
 
 	asio::io_service &io_service;
+	IOShards &shards;
 	std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
 	std::vector<Service_ptr> services;
 
@@ -101,10 +103,14 @@ public:
 
 private:
 	void die();
+	void initShards();
 
 	phmap::flat_hash_map<uint16_t, ServicePort_ptr> acceptors;
 
+	// Accepts connections, handles signals and the shutdown timer
 	asio::io_service io_service;
+	// Runs the socket work of the accepted connections
+	IOShards shards;
 	Signals signals { io_service };
 	asio::high_resolution_timer death_timer { io_service };
 	bool running = false;
@@ -119,12 +125,14 @@ bool ServiceManager::add(uint16_t port) {
 		return false;
 	}
 
+	initShards();
+
 	ServicePort_ptr service_port;
 
 	const auto foundServicePort = acceptors.find(port);
 
 	if (foundServicePort == acceptors.end()) {
-		service_port = std::make_shared<ServicePort>(io_service);
+		service_port = std::make_shared<ServicePort>(io_service, shards);
 		service_port->open(port);
 		acceptors[port] = service_port;
 	} else {
@@ -0,0 +1,80 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "utils/cpu_features.hpp"
+
+#include "utils/simd.hpp"
+
+namespace {
+	SimdLevel detectSimdLevel() {
+#if defined(SIMD_RUNTIME_DISPATCH) && defined(_MSC_VER)
+		std::array<int, 4> regs {};
+		__cpuid(regs.data(), 0);
+		const int maxLeaf = regs[0];
+
+		__cpuid(regs.data(), 1);
+		const bool sse2 = (regs[3] & (1 << 26)) != 0;
+		const bool osxsave = (regs[2] & (1 << 27)) != 0;
+		const bool avx = (regs[2] & (1 << 28)) != 0;
+		if (!sse2) {
+			return SimdLevel::Scalar;
+		}
+		if (!osxsave || !avx || maxLeaf < 7) {
+			return SimdLevel::SSE2;
+		}
+
+		// The operating system has to save the ymm (and zmm) registers
+		const auto xcr0 = _xgetbv(0);
+		if ((xcr0 & 0x6) != 0x6) {
+			return SimdLevel::SSE2;
+		}
+
+		__cpuidex(regs.data(), 7, 0);
+		const bool avx2 = (regs[1] & (1 << 5)) != 0;
+		const bool avx512f = (regs[1] & (1 << 16)) != 0;
+		if (avx512f && (xcr0 & 0xE6) == 0xE6) {
+			return SimdLevel::AVX512;
+		}
+		return avx2 ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#elif defined(SIMD_RUNTIME_DISPATCH)
+		// Checks the operating system support as well
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f")) {
+			return SimdLevel::AVX512;
+		}
+		if (__builtin_cpu_supports("avx2")) {
+			return SimdLevel::AVX2;
+		}
+		if (__builtin_cpu_supports("sse2")) {
+			return SimdLevel::SSE2;
+		}
+		return SimdLevel::Scalar;
+#else
+		return SimdLevel::Scalar;
+#endif
+	}
+}
+
+SimdLevel getSimdLevel() {
+	static const SimdLevel level = detectSimdLevel();
+	return level;
+}
+
+std::string_view getSimdLevelName(SimdLevel level) {
+	switch (level) {
+		case SimdLevel::SSE2:
+			return "SSE2";
+		case SimdLevel::AVX2:
+			return "AVX2";
+		case SimdLevel::AVX512:
+			return "AVX-512";
+		default:
+			return "scalar";
+	}
+}
@@ -0,0 +1,29 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+enum class SimdLevel : uint8_t {
+	Scalar,
+	SSE2,
+	AVX2,
+	AVX512,
+};
+
+/**
+ * @brief The widest vector instruction set of the CPU running the server.
+ *
+ * Detected once with cpuid, including the operating system support for the
+ * wider registers. Release builds target generic x86-64, so kernels compiled
+ * with SIMD_TARGET use this to pick the fastest variant the machine has.
+ * Always Scalar when SIMD_RUNTIME_DISPATCH is not defined.
+ */
+SimdLevel getSimdLevel();
+
+std::string_view getSimdLevelName(SimdLevel level);
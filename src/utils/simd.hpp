@@ -52,6 +52,17 @@
 	#if defined(__AVX__) || defined(__AVX2__) || defined(__AVX512F__)
 		#include <immintrin.h>
 	#endif
+
+	// Kernels for wider instruction sets than the build targets, picked at runtime through getSimdLevel()
+	#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+		#define SIMD_RUNTIME_DISPATCH 1
+		#define SIMD_TARGET(isa) __attribute__((target(isa)))
+		#include <immintrin.h>
+	#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		#define SIMD_RUNTIME_DISPATCH 1
+		#define SIMD_TARGET(isa)
+		#include <immintrin.h>
+	#endif
 #endif
 
 #ifdef _MSC_VER
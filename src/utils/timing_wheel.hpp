@@ -0,0 +1,233 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019–present OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// timing_wheel is a hierarchical timer wheel with O(1) insert and cancel.
+// Entries live in a slab and are linked into intrusive per-slot lists, the handle
+// returned by insert is the slab index. The first level covers 256 ticks and each
+// of the next three levels covers 64 times the previous one; entries further away
+// are parked in the last level and cascaded down again until they are near.
+// Note: an entry never expires before its timestamp, at most one tick after it.
+
+namespace stdext {
+	template <typename T>
+	class timing_wheel {
+	public:
+		using handle = uint32_t;
+		static constexpr handle INVALID_HANDLE = std::numeric_limits<handle>::max();
+
+		explicit timing_wheel(int64_t tickMs) :
+			tickMs(std::max<int64_t>(tickMs, 1)) {
+			heads.fill(INVALID_HANDLE);
+		}
+
+		handle insert(int64_t now, int64_t timestamp, T value) {
+			if (count == 0) {
+				currentTick = std::max(currentTick, floorTick(now));
+			}
+
+			handle id;
+			if (freeHead != INVALID_HANDLE) {
+				id = freeHead;
+				freeHead = entries[id].next;
+			} else {
+				id = static_cast<handle>(entries.size());
+				entries.emplace_back();
+			}
+
+			auto &entry = entries[id];
+			entry.value = std::move(value);
+			entry.timestamp = timestamp;
+			entry.active = true;
+			link(id);
+			++count;
+			return id;
+		}
+
+		bool cancel(handle id) {
+			if (id >= entries.size() || !entries[id].active) {
+				return false;
+			}
+
+			unlink(id);
+			release(id);
+			return true;
+		}
+
+		// Moves every entry due at `now` into `expired`, ordered by timestamp.
+		void advance(int64_t now, std::vector<T> &expired) {
+			const int64_t target = floorTick(now);
+			collect(DUE_LIST);
+
+			while (currentTick < target) {
+				if (count == 0) {
+					currentTick = target;
+					break;
+				}
+
+				++currentTick;
+				if ((currentTick & LEVEL0_MASK) == 0) {
+					cascade();
+				}
+				collect(static_cast<uint32_t>(currentTick & LEVEL0_MASK));
+				collect(DUE_LIST);
+			}
+
+			std::ranges::stable_sort(due, {}, &std::pair<int64_t, T>::first);
+			expired.reserve(expired.size() + due.size());
+			for (auto &[_, value] : due) {
+				expired.emplace_back(std::move(value));
+			}
+			due.clear();
+		}
+
+		size_t size() const {
+			return count;
+		}
+
+		bool empty() const {
+			return count == 0;
+		}
+
+	private:
+		static constexpr int64_t LEVEL0_BITS = 8;
+		static constexpr int64_t LEVELN_BITS = 6;
+		static constexpr int64_t LEVELS = 4;
+		static constexpr int64_t LEVEL0_SIZE = 1 << LEVEL0_BITS;
+		static constexpr int64_t LEVELN_SIZE = 1 << LEVELN_BITS;
+		static constexpr int64_t LEVEL0_MASK = LEVEL0_SIZE - 1;
+		static constexpr int64_t LEVELN_MASK = LEVELN_SIZE - 1;
+		static constexpr int64_t MAX_DELTA = int64_t { 1 } << (LEVEL0_BITS + (LEVELS - 1) * LEVELN_BITS);
+		static constexpr uint32_t SLOTS = LEVEL0_SIZE + (LEVELS - 1) * LEVELN_SIZE;
+		static constexpr uint32_t DUE_LIST = SLOTS;
+
+		struct Entry {
+			T value {};
+			int64_t timestamp = 0;
+			handle prev = INVALID_HANDLE;
+			handle next = INVALID_HANDLE;
+			uint32_t list = 0;
+			bool active = false;
+		};
+
+		int64_t floorTick(int64_t timestamp) const {
+			return timestamp / tickMs;
+		}
+
+		int64_t ceilTick(int64_t timestamp) const {
+			return (timestamp + tickMs - 1) / tickMs;
+		}
+
+		uint32_t slotFor(int64_t expireTick) const {
+			if (expireTick <= currentTick) {
+				return DUE_LIST;
+			}
+
+			const int64_t delta = std::min(expireTick - currentTick, MAX_DELTA - 1);
+			if (delta < LEVEL0_SIZE) {
+				return static_cast<uint32_t>(expireTick & LEVEL0_MASK);
+			}
+
+			// Far entries are clamped to the last slot reachable and re-cascaded later
+			const int64_t tick = currentTick + delta;
+			int64_t shift = LEVEL0_BITS;
+			uint32_t base = LEVEL0_SIZE;
+			for (int64_t level = 1; level < LEVELS; ++level) {
+				if (delta < (int64_t { 1 } << (shift + LEVELN_BITS)) || level == LEVELS - 1) {
+					return base + static_cast<uint32_t>((tick >> shift) & LEVELN_MASK);
+				}
+				shift += LEVELN_BITS;
+				base += LEVELN_SIZE;
+			}
+			return DUE_LIST;
+		}
+
+		void link(handle id) {
+			auto &entry = entries[id];
+			entry.list = slotFor(ceilTick(entry.timestamp));
+			entry.prev = INVALID_HANDLE;
+			entry.next = heads[entry.list];
+			if (entry.next != INVALID_HANDLE) {
+				entries[entry.next].prev = id;
+			}
+			heads[entry.list] = id;
+		}
+
+		void unlink(handle id) {
+			const auto &entry = entries[id];
+			if (entry.prev != INVALID_HANDLE) {
+				entries[entry.prev].next = entry.next;
+			} else {
+				heads[entry.list] = entry.next;
+			}
+			if (entry.next != INVALID_HANDLE) {
+				entries[entry.next].prev = entry.prev;
+			}
+		}
+
+		void release(handle id) {
+			auto &entry = entries[id];
+			entry.value = T {};
+			entry.active = false;
+			entry.prev = INVALID_HANDLE;
+			entry.next = freeHead;
+			freeHead = id;
+			--count;
+		}
+
+		// Re-distributes the slots of the upper levels that start at the current tick
+		void cascade() {
+			int64_t shift = LEVEL0_BITS;
+			uint32_t base = LEVEL0_SIZE;
+			for (int64_t level = 1; level < LEVELS; ++level) {
+				const auto index = static_cast<uint32_t>((currentTick >> shift) & LEVELN_MASK);
+				handle id = std::exchange(heads[base + index], INVALID_HANDLE);
+				while (id != INVALID_HANDLE) {
+					const handle next = entries[id].next;
+					link(id);
+					id = next;
+				}
+
+				if (index != 0) {
+					break;
+				}
+				shift += LEVELN_BITS;
+				base += LEVELN_SIZE;
+			}
+		}
+
+		void collect(uint32_t list) {
+			handle id = std::exchange(heads[list], INVALID_HANDLE);
+			while (id != INVALID_HANDLE) {
+				auto &entry = entries[id];
+				const handle next = entry.next;
+				due.emplace_back(entry.timestamp, std::move(entry.value));
+				release(id);
+				id = next;
+			}
+		}
+
+		int64_t tickMs;
+		int64_t currentTick = 0;
+		size_t count = 0;
+		handle freeHead = INVALID_HANDLE;
+
+		std::vector<Entry> entries;
+		std::array<handle, SLOTS + 1> heads {};
+		std::vector<std::pair<int64_t, T>> due;
+	};
+}
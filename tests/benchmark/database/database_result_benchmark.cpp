@@ -0,0 +1,63 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "database/database.hpp"
+
+// Reads the numeric columns of a synthetic player_items result the way
+// IOLoginDataLoad::loadItems does. Compares the lookup by name and std::stoul
+// parsing used before with resolved column indexes and DBResult::parseNumber.
+// The cells are plain strings: this times the column lookup and the parsing,
+// not the MySQL row fetch, which is the same for both.
+TEST(DatabaseResultBenchmark, PlayerItemsColumns) {
+	constexpr size_t rows = 200000;
+	const std::array<std::string_view, 5> columns { "player_id", "pid", "sid", "itemtype", "count" };
+
+	std::mt19937 rng { 17 };
+	std::vector<std::array<std::string, 5>> cells(rows);
+	for (size_t i = 0; i < rows; ++i) {
+		cells[i] = { "123456", std::to_string(i / 20 + 1), std::to_string(i + 101), std::to_string(rng() % 60000), std::to_string(rng() % 100 + 1) };
+	}
+
+	std::map<std::string_view, size_t> listNames;
+	for (size_t i = 0; i < columns.size(); ++i) {
+		listNames[columns[i]] = i;
+	}
+
+	using clock = std::chrono::steady_clock;
+	uint64_t namedSum = 0;
+	const auto namedStart = clock::now();
+	for (const auto &row : cells) {
+		namedSum += static_cast<uint32_t>(std::stoul(row[listNames.find("sid")->second]));
+		namedSum += static_cast<uint32_t>(std::stoul(row[listNames.find("pid")->second]));
+		namedSum += static_cast<uint16_t>(std::stoul(row[listNames.find("itemtype")->second]));
+		namedSum += static_cast<uint16_t>(std::stoul(row[listNames.find("count")->second]));
+	}
+	const auto namedTime = clock::now() - namedStart;
+
+	uint64_t indexedSum = 0;
+	const auto indexedStart = clock::now();
+	const size_t sid = listNames.find("sid")->second;
+	const size_t pid = listNames.find("pid")->second;
+	const size_t itemtype = listNames.find("itemtype")->second;
+	const size_t count = listNames.find("count")->second;
+	for (const auto &row : cells) {
+		indexedSum += DBResult::parseNumber<uint32_t>(row[sid]).value_or(0);
+		indexedSum += DBResult::parseNumber<uint32_t>(row[pid]).value_or(0);
+		indexedSum += DBResult::parseNumber<uint16_t>(row[itemtype]).value_or(0);
+		indexedSum += DBResult::parseNumber<uint16_t>(row[count]).value_or(0);
+	}
+	const auto indexedTime = clock::now() - indexedStart;
+
+	EXPECT_EQ(namedSum, indexedSum);
+
+	using ms = std::chrono::duration<double, std::milli>;
+	RecordProperty("named_stoul_ms", fmt::format("{:.2f}", ms(namedTime).count()));
+	RecordProperty("indexed_from_chars_ms", fmt::format("{:.2f}", ms(indexedTime).count()));
+	fmt::print("[ BENCH    ] {} player_items rows: by name with std::stoul {:.2f} ms, by index with std::from_chars {:.2f} ms\n", rows, ms(namedTime).count(), ms(indexedTime).count());
+}
@@ -0,0 +1,68 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/zones/zone.hpp"
+
+namespace {
+	std::shared_ptr<Zone> makeZone(const std::string &name, uint32_t id, Area area) {
+		auto zone = Zone::addZone(name, id);
+		for (const auto &position : area) {
+			zone->addPosition(position);
+		}
+		return zone;
+	}
+}
+
+// Datapack-like layout: hundreds of small zones spread over the map, queried the
+// way Map::refreshZones and tile creation do. Checks the results against a scan of
+// every zone area and reports both timings.
+TEST(ZoneBenchmark, GetZonesAgainstAreaScan) {
+	constexpr uint32_t zoneCount = 400;
+	constexpr size_t queries = 200000;
+	std::mt19937 rng { 7 };
+
+	std::vector<std::pair<std::shared_ptr<Zone>, Area>> created;
+	created.reserve(zoneCount);
+	for (uint32_t i = 0; i < zoneCount; ++i) {
+		const auto x = static_cast<uint16_t>(1000 + rng() % 2000);
+		const auto y = static_cast<uint16_t>(1000 + rng() % 2000);
+		const auto z = static_cast<uint8_t>(rng() % 16);
+		const Area area(Position(x, y, z), Position(x + 1 + rng() % 15, y + 1 + rng() % 15, z));
+		created.emplace_back(makeZone(fmt::format("zone-bench-{}", i), 0xB0000 + i, area), area);
+	}
+
+	std::vector<Position> positions(queries);
+	for (auto &position : positions) {
+		position = Position(static_cast<uint16_t>(1000 + rng() % 2016), static_cast<uint16_t>(1000 + rng() % 2016), static_cast<uint8_t>(rng() % 16));
+	}
+
+	using clock = std::chrono::steady_clock;
+	size_t indexedHits = 0;
+	const auto indexedStart = clock::now();
+	for (const auto &position : positions) {
+		indexedHits += Zone::getZones(position).size();
+	}
+	const auto indexedTime = clock::now() - indexedStart;
+
+	size_t scannedHits = 0;
+	const auto scanStart = clock::now();
+	for (const auto &position : positions) {
+		for (const auto &[zone, area] : created) {
+			scannedHits += area.contains(position) ? 1 : 0;
+		}
+	}
+	const auto scanTime = clock::now() - scanStart;
+
+	EXPECT_EQ(scannedHits, indexedHits);
+
+	using ms = std::chrono::duration<double, std::milli>;
+	RecordProperty("indexed_ms", fmt::format("{:.2f}", ms(indexedTime).count()));
+	RecordProperty("area_scan_ms", fmt::format("{:.2f}", ms(scanTime).count()));
+	fmt::print("[ BENCH    ] {} zones, {} queries: sector index {:.2f} ms, area scan {:.2f} ms\n", zoneCount, queries, ms(indexedTime).count(), ms(scanTime).count());
+}
@@ -0,0 +1,73 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/thread/work_stealing_loop.hpp"
+
+namespace {
+	constexpr size_t kWorkers = 4;
+
+	// Runs the loop on `threads` threads, the remaining workers never show up
+	void runOn(WorkStealingLoop &loop, size_t threads, const std::function<void(size_t)> &f) {
+		std::vector<std::thread> helpers;
+		for (size_t worker = 1; worker < threads; ++worker) {
+			helpers.emplace_back([&loop, &f, worker] { loop.run(worker, f); });
+		}
+		loop.run(0, f);
+		loop.wait();
+		for (auto &helper : helpers) {
+			helper.join();
+		}
+	}
+
+	void spin(std::chrono::microseconds duration) {
+		const auto until = std::chrono::steady_clock::now() + duration;
+		while (std::chrono::steady_clock::now() < until) { }
+	}
+}
+
+// Skewed costs, as when a few monsters run long pathfinds: the costly tasks are
+// all at the front, so a static split gives them to a single thread. Compares
+// against the equal chunks the dispatcher used before. The number of steals
+// depends on scheduling, so it is only reported.
+TEST(WorkStealingLoopBenchmark, SkewedCosts) {
+	constexpr size_t size = 20000;
+	constexpr size_t costly = 400;
+	const auto cost = [](size_t i) {
+		spin(std::chrono::microseconds(i < costly ? 100 : 1));
+	};
+
+	using clock = std::chrono::steady_clock;
+	const auto staticStart = clock::now();
+	{
+		std::vector<std::thread> threads;
+		const size_t chunk = (size + kWorkers - 1) / kWorkers;
+		for (size_t begin = 0; begin < size; begin += chunk) {
+			threads.emplace_back([&cost, begin, end = std::min(size, begin + chunk)] {
+				for (size_t i = begin; i < end; ++i) {
+					cost(i);
+				}
+			});
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+	}
+	const auto staticTime = clock::now() - staticStart;
+
+	WorkStealingLoop loop { kWorkers, size };
+	const auto stealingStart = clock::now();
+	runOn(loop, kWorkers, cost);
+	const auto stealingTime = clock::now() - stealingStart;
+
+	using ms = std::chrono::duration<double, std::milli>;
+	RecordProperty("static_chunks_ms", fmt::format("{:.2f}", ms(staticTime).count()));
+	RecordProperty("work_stealing_ms", fmt::format("{:.2f}", ms(stealingTime).count()));
+	RecordProperty("steals", std::to_string(loop.getSteals()));
+	fmt::print("[ BENCH    ] {} tasks ({} costly) on {} workers: static chunks {:.2f} ms, work stealing {:.2f} ms, {} steals\n", size, costly, kWorkers, ms(staticTime).count(), ms(stealingTime).count(), loop.getSteals());
+}
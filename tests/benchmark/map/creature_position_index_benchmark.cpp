@@ -0,0 +1,117 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/creature_position_index.hpp"
+
+namespace {
+	struct IndexedCreature {
+		Position pos;
+		uint8_t kind;
+	};
+
+	std::vector<SimdLevel> supportedLevels() {
+		std::vector<SimdLevel> levels;
+		for (const auto level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+			if (level <= getSimdLevel()) {
+				levels.emplace_back(level);
+			}
+		}
+		return levels;
+	}
+
+	// The check Spectators::getSpectators did on every creature of a sector
+	bool isInRange(const CreaturePositionIndex::Range &range, const Position &cpos) {
+		if (static_cast<uint32_t>(static_cast<int32_t>(cpos.z) - range.minZ) > range.depth) {
+			return false;
+		}
+		const int_fast16_t offsetZ = range.centerZ - cpos.z;
+		return static_cast<uint32_t>(cpos.x - offsetZ - range.minX) <= range.width && static_cast<uint32_t>(cpos.y - offsetZ - range.minY) <= range.height;
+	}
+
+	std::vector<IndexedCreature> makeCreatures(std::mt19937 &rng, size_t count) {
+		const std::array<uint8_t, 4> kinds { CreaturePositionIndex::KIND_OTHER, CreaturePositionIndex::KIND_PLAYER, CreaturePositionIndex::KIND_MONSTER, CreaturePositionIndex::KIND_NPC };
+		std::vector<IndexedCreature> creatures;
+		creatures.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			const Position pos(static_cast<uint16_t>(1000 + rng() % 64), static_cast<uint16_t>(1000 + rng() % 64), static_cast<uint8_t>(rng() % 16));
+			creatures.push_back({ pos, kinds[rng() % kinds.size()] });
+		}
+		return creatures;
+	}
+
+	CreaturePositionIndex::Range makeRange(const Position &center, bool multifloor, uint8_t kinds) {
+		CreaturePositionIndex::Range range;
+		range.minX = center.x - 9;
+		range.minY = center.y - 7;
+		range.width = 18;
+		range.height = 14;
+		range.minZ = multifloor ? std::max(0, center.z - 2) : center.z;
+		range.depth = multifloor ? static_cast<uint32_t>(std::min(15, center.z + 2) - range.minZ) : 0;
+		range.centerZ = center.z;
+		range.kinds = kinds;
+		return range;
+	}
+}
+
+// Runs the spectator queries of a crowded sector over creatures reached through
+// shared pointers, as the sector lists did, and over the packed index with every
+// kernel the CPU supports.
+TEST(CreaturePositionIndexBenchmark, CrowdedSector) {
+	constexpr size_t creatureCount = 5000;
+	constexpr size_t queries = 2000;
+	std::mt19937 rng { 5000 };
+	const auto creatures = makeCreatures(rng, creatureCount);
+
+	// Shuffled so the list walks the heap out of allocation order, as it does once creatures come and go
+	std::vector<std::shared_ptr<IndexedCreature>> creatureList;
+	for (const auto &creature : creatures) {
+		creatureList.emplace_back(std::make_shared<IndexedCreature>(creature));
+	}
+	std::ranges::shuffle(creatureList, rng);
+
+	CreaturePositionIndex index;
+	for (const auto &creature : creatureList) {
+		index.add(creature->pos, creature->kind);
+	}
+
+	std::vector<CreaturePositionIndex::Range> ranges;
+	for (size_t i = 0; i < queries; ++i) {
+		const Position center(static_cast<uint16_t>(1000 + rng() % 64), static_cast<uint16_t>(1000 + rng() % 64), static_cast<uint8_t>(rng() % 16));
+		ranges.emplace_back(makeRange(center, true, CreaturePositionIndex::KIND_ALL));
+	}
+
+	using clock = std::chrono::steady_clock;
+	using ms = std::chrono::duration<double, std::milli>;
+	size_t listMatches = 0;
+	const auto listStart = clock::now();
+	for (const auto &range : ranges) {
+		for (const auto &creature : creatureList) {
+			if (isInRange(range, creature->pos)) {
+				++listMatches;
+			}
+		}
+	}
+	const auto listTime = clock::now() - listStart;
+	RecordProperty("creature_list_ms", fmt::format("{:.2f}", ms(listTime).count()));
+	fmt::print("[ BENCH    ] {} queries over {} creatures: creature list {:.2f} ms\n", queries, creatureCount, ms(listTime).count());
+
+	for (const auto level : supportedLevels()) {
+		size_t indexMatches = 0;
+		const auto indexStart = clock::now();
+		for (const auto &range : ranges) {
+			index.forEachInRange(range, [&indexMatches](size_t) { ++indexMatches; }, level);
+		}
+		const auto indexTime = clock::now() - indexStart;
+
+		EXPECT_EQ(listMatches, indexMatches) << getSimdLevelName(level);
+
+		RecordProperty(fmt::format("position_index_{}_ms", getSimdLevelName(level)), fmt::format("{:.2f}", ms(indexTime).count()));
+		fmt::print("[ BENCH    ] {} queries over {} creatures: position index ({}) {:.2f} ms\n", queries, creatureCount, getSimdLevelName(level), ms(indexTime).count());
+	}
+}
@@ -0,0 +1,76 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "items/tile.hpp"
+#include "map/utils/mapsector.hpp"
+
+namespace {
+	std::shared_ptr<Tile> makeTile(uint16_t x, uint16_t y, uint8_t z) {
+		return std::make_shared<DynamicTile>(x, y, z);
+	}
+}
+
+// Sight lines through a sector where a quarter of the tiles block projectiles, as
+// Map::checkSightLine probes them: a tile lookup and a flag test against a bit test.
+TEST(FloorBenchmark, SightLineBits) {
+	constexpr size_t lines = 200000;
+
+	Floor floor { 7 };
+	std::mt19937 rng(25);
+	for (uint16_t x = 0; x < SECTOR_SIZE; ++x) {
+		for (uint16_t y = 0; y < SECTOR_SIZE; ++y) {
+			const auto tile = makeTile(x, y, 7);
+			if (rng() % 4 == 0) {
+				tile->setFlag(TILESTATE_BLOCKPROJECTILE);
+			}
+			floor.setTile(x, y, tile);
+		}
+	}
+
+	std::vector<std::pair<uint16_t, uint16_t>> rows;
+	for (size_t i = 0; i < lines; ++i) {
+		rows.emplace_back(static_cast<uint16_t>(rng() % SECTOR_SIZE), static_cast<uint16_t>(rng() % SECTOR_SIZE));
+	}
+
+	// Horizontal lines from x 0 up to the first blocking tile
+	const auto castLines = [&rows](auto &&blocks) {
+		size_t clear = 0;
+		for (const auto &[y, length] : rows) {
+			uint16_t x = 0;
+			while (x < length && !blocks(x, y)) {
+				++x;
+			}
+			clear += x == length ? 1 : 0;
+		}
+		return clear;
+	};
+
+	using clock = std::chrono::steady_clock;
+	const auto tileStart = clock::now();
+	const size_t tileClear = castLines([&floor](uint16_t x, uint16_t y) {
+		const auto &tile = floor.getTile(x, y);
+		return tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE);
+	});
+	const auto tileTime = clock::now() - tileStart;
+
+	const auto bitsStart = clock::now();
+	const size_t bitsClear = castLines([&floor](uint16_t x, uint16_t y) {
+		return floor.hasAnyTileBit(x, y, Floor::TILE_BLOCKS_PROJECTILE);
+	});
+	const auto bitsTime = clock::now() - bitsStart;
+
+	EXPECT_EQ(tileClear, bitsClear);
+
+	using ms = std::chrono::duration<double, std::milli>;
+	RecordProperty("tile_lookup_ms", fmt::format("{:.2f}", ms(tileTime).count()));
+	RecordProperty("tile_bits_ms", fmt::format("{:.2f}", ms(bitsTime).count()));
+	fmt::print("[ BENCH    ] {} sight lines: tile lookup {:.2f} ms, tile bits {:.2f} ms\n", lines, ms(tileTime).count(), ms(bitsTime).count());
+}
@@ -0,0 +1,57 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "map/utils/sector_grid.hpp"
+
+// Sector lookups the way Map::getTile does them, for a 2048x2048 map. Compares
+// with the hash map keyed by packed sector coordinates used before.
+TEST(SectorGridBenchmark, Lookups) {
+	constexpr uint32_t mapSize = 2048;
+	constexpr size_t lookups = 2000000;
+
+	SectorGrid grid;
+	std::unordered_map<uint32_t, MapSector> hashed;
+	for (uint32_t x = 0; x < mapSize; x += SECTOR_SIZE) {
+		for (uint32_t y = 0; y < mapSize; y += SECTOR_SIZE) {
+			grid.getOrCreate(x, y);
+			hashed.try_emplace(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
+		}
+	}
+
+	std::mt19937 rng { 10 };
+	std::vector<std::pair<uint32_t, uint32_t>> positions(lookups);
+	for (auto &[x, y] : positions) {
+		x = 1000 + rng() % mapSize;
+		y = 1000 + rng() % mapSize;
+	}
+
+	using clock = std::chrono::steady_clock;
+	size_t hashedHits = 0;
+	const auto hashedStart = clock::now();
+	for (const auto &[x, y] : positions) {
+		hashedHits += hashed.contains(x / SECTOR_SIZE | y / SECTOR_SIZE << 16) ? 1 : 0;
+	}
+	const auto hashedTime = clock::now() - hashedStart;
+
+	size_t gridHits = 0;
+	const auto gridStart = clock::now();
+	for (const auto &[x, y] : positions) {
+		gridHits += grid.get(x, y) ? 1 : 0;
+	}
+	const auto gridTime = clock::now() - gridStart;
+
+	EXPECT_EQ(hashedHits, gridHits);
+
+	using ms = std::chrono::duration<double, std::milli>;
+	RecordProperty("unordered_map_ms", fmt::format("{:.2f}", ms(hashedTime).count()));
+	RecordProperty("sector_grid_ms", fmt::format("{:.2f}", ms(gridTime).count()));
+	fmt::print("[ BENCH    ] {} sector lookups: unordered_map {:.2f} ms, sector grid {:.2f} ms\n", lookups, ms(hashedTime).count(), ms(gridTime).count());
+}
@@ -0,0 +1,50 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "security/xtea.hpp"
+
+namespace {
+	constexpr XTEA::Key key { 0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210 };
+
+	std::vector<SimdLevel> supportedLevels() {
+		std::vector<SimdLevel> levels;
+		for (const auto level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+			if (level <= getSimdLevel()) {
+				levels.emplace_back(level);
+			}
+		}
+		return levels;
+	}
+
+	std::vector<uint8_t> randomBytes(std::mt19937 &rng, size_t size) {
+		std::vector<uint8_t> bytes(size);
+		std::ranges::generate(bytes, [&rng] { return static_cast<uint8_t>(rng()); });
+		return bytes;
+	}
+}
+
+// Encrypts full size output messages with every instruction set the CPU supports.
+TEST(XTEABenchmark, Throughput) {
+	constexpr size_t messageSize = 24576;
+	constexpr size_t messages = 400;
+	std::mt19937 rng { 8 };
+	auto buffer = randomBytes(rng, messageSize);
+
+	for (const auto level : supportedLevels()) {
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < messages; ++i) {
+			XTEA::transform(buffer.data(), buffer.size(), key, true, level);
+		}
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		const double mbs = static_cast<double>(messageSize * messages) / (1024.0 * 1024.0) / elapsed.count();
+		RecordProperty(fmt::format("{}_mb_s", getSimdLevelName(level)), fmt::format("{:.1f}", mbs));
+		fmt::print("[ BENCH    ] XTEA encrypt {}: {:.1f} MB/s\n", getSimdLevelName(level), mbs);
+	}
+}
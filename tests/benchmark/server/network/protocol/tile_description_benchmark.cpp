@@ -0,0 +1,131 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "items/item.hpp"
+#include "items/tile.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "server/network/protocol/tile_description.hpp"
+
+namespace {
+	// Benchmarks run without a datapack, so the item types are registered here
+	constexpr uint16_t groundId = 1;
+	constexpr uint16_t borderId = 2;
+	constexpr uint16_t coinsId = 3;
+	constexpr uint16_t splashId = 4;
+	constexpr uint16_t stoneId = 5;
+	constexpr uint16_t chestId = 6;
+
+	void registerItemTypes() {
+		auto &types = Item::items.getItems();
+		if (types.size() <= chestId) {
+			types.resize(chestId + 1);
+		}
+
+		const auto define = [&types](uint16_t id) -> ItemType & {
+			types[id].id = id;
+			return types[id];
+		};
+		define(groundId).group = ITEM_GROUP_GROUND;
+		define(borderId).alwaysOnTopOrder = 1;
+		define(coinsId).stackable = true;
+		define(splashId).group = ITEM_GROUP_SPLASH;
+		define(stoneId).animationType = ANIMATION_RANDOM;
+		define(chestId).group = ITEM_GROUP_CONTAINER;
+	}
+
+	std::shared_ptr<Tile> makeTile(uint16_t x, std::initializer_list<std::pair<uint16_t, uint16_t>> things) {
+		auto tile = std::make_shared<DynamicTile>(x, 100, 7);
+		for (const auto &[id, count] : things) {
+			tile->internalAddThing(std::make_shared<Item>(id, count));
+		}
+		return tile;
+	}
+
+	// Uncached reference, the part of ProtocolGame::AddItem used by cacheable items
+	void addItem(NetworkMessage &msg, const std::shared_ptr<Item> &item, bool oldProtocol) {
+		const ItemType &it = Item::items[item->getID()];
+		msg.add<uint16_t>(it.id);
+		if (oldProtocol) {
+			msg.addByte(0xFF);
+		}
+		if (it.stackable) {
+			msg.addByte(static_cast<uint8_t>(std::min<uint16_t>(std::numeric_limits<uint8_t>::max(), item->getItemCount())));
+		}
+		if (it.isSplash() || it.isFluidContainer()) {
+			msg.addByte(item->getAttribute<uint8_t>(ItemAttribute_t::FLUIDTYPE));
+		}
+		if (oldProtocol && it.animationType == ANIMATION_RANDOM) {
+			msg.addByte(0xFE);
+		}
+	}
+
+	void addItems(NetworkMessage &msg, const std::shared_ptr<Tile> &tile, bool oldProtocol) {
+		if (const auto &ground = tile->getGround()) {
+			addItem(msg, ground, oldProtocol);
+		}
+		if (const auto items = tile->getItemList()) {
+			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				addItem(msg, *it, oldProtocol);
+			}
+			for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
+				addItem(msg, *it, oldProtocol);
+			}
+		}
+	}
+
+	std::vector<uint8_t> bytes(const NetworkMessage &msg) {
+		const auto begin = msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		return { begin, begin + msg.getLength() };
+	}
+}
+
+// Full client view on every floor (18x14 tiles, 8 floors), as sent on login or
+// teleport. Compares encoding every item with copying the cached descriptions.
+TEST(TileDescriptionBenchmark, FullScreenDescription) {
+	registerItemTypes();
+	constexpr size_t tiles = 18 * 14 * 8;
+	constexpr size_t windows = 500;
+
+	std::vector<std::shared_ptr<Tile>> window;
+	window.reserve(tiles);
+	for (size_t i = 0; i < tiles; ++i) {
+		window.emplace_back(makeTile(static_cast<uint16_t>(200 + i), { { groundId, 0 }, { borderId, 0 }, { splashId, 2 }, { coinsId, static_cast<uint16_t>(1 + i % 100) } }));
+	}
+
+	using clock = std::chrono::steady_clock;
+	NetworkMessage encoded;
+	const auto encodeStart = clock::now();
+	for (size_t i = 0; i < windows; ++i) {
+		encoded.reset();
+		for (const auto &tile : window) {
+			addItems(encoded, tile, false);
+		}
+	}
+	const auto encodeTime = clock::now() - encodeStart;
+
+	NetworkMessage copied;
+	const auto copyStart = clock::now();
+	for (size_t i = 0; i < windows; ++i) {
+		copied.reset();
+		for (const auto &tile : window) {
+			const auto description = TileDescription::get(tile);
+			description->write(copied, false, 0, description->getTopItems() + description->getDownItems());
+		}
+	}
+	const auto copyTime = clock::now() - copyStart;
+
+	EXPECT_EQ(bytes(encoded), bytes(copied));
+
+	using ms = std::chrono::duration<double, std::milli>;
+	RecordProperty("encode_ms", fmt::format("{:.2f}", ms(encodeTime).count()));
+	RecordProperty("cached_ms", fmt::format("{:.2f}", ms(copyTime).count()));
+	fmt::print("[ BENCH    ] {} windows of {} tiles: encode {:.2f} ms, cached {:.2f} ms\n", windows, tiles, ms(encodeTime).count(), ms(copyTime).count());
+}
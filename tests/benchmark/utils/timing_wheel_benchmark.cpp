@@ -0,0 +1,89 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "utils/timing_wheel.hpp"
+
+namespace {
+	constexpr int64_t kTick = 50;
+	constexpr int64_t kEpoch = 1700000000000;
+}
+
+// Decay-like workload: many short and some long durations, frequent restarts.
+// Times the wheel against the ordered map the decay used before, and checks
+// that both expire the same timestamps in the same order.
+TEST(TimingWheelBenchmark, AgainstOrderedMap) {
+	constexpr size_t items = 200000;
+	std::mt19937_64 rng { 42 };
+	std::vector<int64_t> timestamps(items);
+	for (auto &timestamp : timestamps) {
+		const auto duration = rng() % 8 == 0 ? rng() % (24 * 60 * 60 * 1000) : rng() % (5 * 60 * 1000);
+		timestamp = kEpoch + static_cast<int64_t>(duration);
+	}
+
+	using clock = std::chrono::steady_clock;
+	std::vector<int64_t> wheelOrder;
+	std::vector<int64_t> mapOrder;
+	wheelOrder.reserve(items);
+	mapOrder.reserve(items);
+
+	const auto wheelStart = clock::now();
+	{
+		stdext::timing_wheel<int> wheel { kTick };
+		std::vector<stdext::timing_wheel<int>::handle> handles(items);
+		for (size_t i = 0; i < items; ++i) {
+			handles[i] = wheel.insert(kEpoch, timestamps[i], static_cast<int>(i));
+		}
+		// Restart a tenth of them, as happens when items are moved or transformed
+		for (size_t i = 0; i < items; i += 10) {
+			wheel.cancel(handles[i]);
+			wheel.insert(kEpoch, timestamps[i], static_cast<int>(i));
+		}
+
+		std::vector<int> expired;
+		for (int64_t now = kEpoch; !wheel.empty(); now += kTick) {
+			expired.clear();
+			wheel.advance(now, expired);
+			for (const auto id : expired) {
+				wheelOrder.push_back(timestamps[id]);
+			}
+		}
+	}
+	const auto wheelTime = clock::now() - wheelStart;
+
+	const auto mapStart = clock::now();
+	{
+		std::map<int64_t, std::vector<int>> map;
+		for (size_t i = 0; i < items; ++i) {
+			map[timestamps[i]].push_back(static_cast<int>(i));
+		}
+		for (size_t i = 0; i < items; i += 10) {
+			auto &bucket = map[timestamps[i]];
+			bucket.erase(std::ranges::find(bucket, static_cast<int>(i)));
+			bucket.push_back(static_cast<int>(i));
+		}
+
+		for (int64_t now = kEpoch; !map.empty(); now += kTick) {
+			const auto end = map.upper_bound(now);
+			for (auto it = map.begin(); it != end; ++it) {
+				for (const auto id : it->second) {
+					mapOrder.push_back(timestamps[id]);
+				}
+			}
+			map.erase(map.begin(), end);
+		}
+	}
+	const auto mapTime = clock::now() - mapStart;
+
+	EXPECT_EQ(mapOrder, wheelOrder);
+
+	using ms = std::chrono::duration<double, std::milli>;
+	RecordProperty("timing_wheel_ms", fmt::format("{:.2f}", ms(wheelTime).count()));
+	RecordProperty("ordered_map_ms", fmt::format("{:.2f}", ms(mapTime).count()));
+	fmt::print("[ BENCH    ] {} items: timing wheel {:.2f} ms, ordered map {:.2f} ms\n", items, ms(wheelTime).count(), ms(mapTime).count());
+}
@@ -0,0 +1,86 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "database/database.hpp"
+#include "test_database.hpp"
+
+TEST(DatabasePoolIT, ConcurrentQueriesShareThePool) {
+	Database db;
+	ASSERT_TRUE(TestDatabase::connect(db, 2));
+	EXPECT_EQ(2u, db.getPoolSize());
+
+	std::atomic<uint32_t> mismatches { 0 };
+	std::vector<std::jthread> workers;
+	for (uint32_t worker = 0; worker < 8; ++worker) {
+		workers.emplace_back([&db, &mismatches, worker] {
+			for (uint32_t i = 0; i < 20; ++i) {
+				const uint32_t expected = worker * 100 + i;
+				const auto result = db.storeQuery(fmt::format("SELECT {} AS `value`", expected));
+				if (!result || result->getNumber<uint32_t>("value") != expected) {
+					mismatches.fetch_add(1);
+				}
+				if (db.escapeString("it's") != "'it\\'s'") {
+					mismatches.fetch_add(1);
+				}
+			}
+		});
+	}
+	workers.clear();
+
+	EXPECT_EQ(0u, mismatches.load());
+}
+
+TEST(DatabasePoolIT, EscapesWhileEveryConnectionIsBusy) {
+	Database db;
+	ASSERT_TRUE(TestDatabase::connect(db, 1));
+
+	std::atomic<bool> sleeping { false };
+	std::atomic<bool> sleepDone { false };
+	std::jthread busy([&] {
+		sleeping = true;
+		db.executeQuery("SELECT SLEEP(1)");
+		sleepDone = true;
+	});
+	while (!sleeping) {
+		std::this_thread::yield();
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	// Escaping does not wait for the only pooled connection to be released
+	EXPECT_EQ("'a\\\"b'", db.escapeString("a\"b"));
+	EXPECT_FALSE(sleepDone.load());
+
+	// A query waits for it instead
+	EXPECT_TRUE(db.executeQuery("SELECT 1"));
+	EXPECT_TRUE(sleepDone.load());
+}
+
+TEST(DatabasePoolIT, ReconnectKeepsBusyConnectionsOpen) {
+	Database db;
+	ASSERT_TRUE(TestDatabase::connect(db, 1));
+
+	std::atomic<bool> sleeping { false };
+	std::atomic<bool> sleepOk { false };
+	std::jthread busy([&] {
+		sleeping = true;
+		sleepOk = db.executeQuery("SELECT SLEEP(1)");
+	});
+	while (!sleeping) {
+		std::this_thread::yield();
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	// The handle running the sleep is closed when it is released, not under the query
+	ASSERT_TRUE(TestDatabase::connect(db, 2));
+	EXPECT_EQ(2u, db.getPoolSize());
+	busy.join();
+	EXPECT_TRUE(sleepOk.load());
+	EXPECT_EQ(2u, db.getPoolSize());
+	EXPECT_TRUE(db.executeQuery("SELECT 1"));
+}
@@ -0,0 +1,42 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "database/database.hpp"
+
+TEST(DatabaseResultIT, ReadsCellsByNameAndByColumn) {
+	const auto result = g_database().storeQuery(
+		"SELECT 4294967295 AS `big`, -42 AS `negative`, 'abc' AS `text`, NULL AS `nothing`, 12.5 AS `decimal` "
+		"UNION ALL SELECT 7, 300, 'de''f', NULL, 0.5"
+	);
+	ASSERT_NE(nullptr, result);
+	EXPECT_EQ(2u, result->countResults());
+
+	EXPECT_EQ(4294967295u, result->getNumber<uint32_t>("big"));
+	EXPECT_EQ(-42, result->getNumber<int32_t>("negative"));
+	EXPECT_EQ("abc", result->getString("text"));
+	EXPECT_EQ(0, result->getNumber<int32_t>("nothing"));
+	EXPECT_EQ(12, result->getNumber<int32_t>("decimal"));
+
+	// Columns resolved once keep reading the current row
+	const auto big = result->getColumn("big");
+	const auto negative = result->getColumn("negative");
+	const auto text = result->getColumn("text");
+	ASSERT_TRUE(big.isValid());
+	EXPECT_FALSE(result->getColumn("missing").isValid());
+	EXPECT_EQ(0u, result->getNumber<uint32_t>("missing"));
+
+	ASSERT_TRUE(result->hasNext());
+	ASSERT_TRUE(result->next());
+	EXPECT_EQ(7u, result->getNumber<uint32_t>(big));
+	// Narrowed to the low bits, as std::stoul based parsing did
+	EXPECT_EQ(44, result->getNumber<uint8_t>(negative));
+	EXPECT_EQ("de'f", result->getString(text));
+
+	EXPECT_FALSE(result->next());
+}
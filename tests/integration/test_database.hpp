@@ -96,20 +96,9 @@ class TestDatabase final {
 
 public:
 	static void init() {
-		const auto envPath = pickEnvPath();
-		const auto env = loadEnvFile(envPath);
-
-		std::string host = get(env, "TEST_DB_HOST", "127.0.0.1");
-		std::string user = get(env, "TEST_DB_USER", "root");
-		std::string pass = get(env, "TEST_DB_PASSWORD", nullptr, /*required=*/true);
-		std::string database = get(env, "TEST_DB_NAME", "otservbr-global");
-		std::string portStr = get(env, "TEST_DB_PORT", "3306");
-		auto port = static_cast<uint32_t>(std::strtoul(portStr.c_str(), nullptr, 10));
-		std::string sock = get(env, "TEST_DB_SOCKET", "");
-
 		int retries = 30;
 		while (retries > 0) {
-			if (g_database().connect(&host, &user, &pass, &database, port, &sock)) {
+			if (connect(g_database())) {
 				// Validate connection validity with a ping query
 				if (g_database().executeQuery("SELECT 1")) {
 					return;
@@ -122,4 +111,20 @@ public:
 		}
 		throw std::runtime_error("Failed to connect to database after multiple attempts.");
 	}
+
+	// Connects the given database to the test server, used by tests that need their own pool
+	static bool connect(Database &db, uint32_t poolSize = 1) {
+		const auto envPath = pickEnvPath();
+		const auto env = loadEnvFile(envPath);
+
+		std::string host = get(env, "TEST_DB_HOST", "127.0.0.1");
+		std::string user = get(env, "TEST_DB_USER", "root");
+		std::string pass = get(env, "TEST_DB_PASSWORD", nullptr, /*required=*/true);
+		std::string database = get(env, "TEST_DB_NAME", "otservbr-global");
+		std::string portStr = get(env, "TEST_DB_PORT", "3306");
+		auto port = static_cast<uint32_t>(std::strtoul(portStr.c_str(), nullptr, 10));
+		std::string sock = get(env, "TEST_DB_SOCKET", "");
+
+		return db.connect(&host, &user, &pass, &database, port, &sock, poolSize);
+	}
 };
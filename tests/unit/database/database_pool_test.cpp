@@ -0,0 +1,26 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "database/database.hpp"
+
+TEST(DatabasePoolTest, QueriesFailWithoutConnections) {
+	Database db;
+	EXPECT_EQ(0u, db.getPoolSize());
+
+	// Nothing to wait for, so the calls return instead of blocking on the pool
+	EXPECT_FALSE(db.executeQuery("SELECT 1"));
+	EXPECT_EQ(nullptr, db.storeQuery("SELECT 1"));
+}
+
+TEST(DatabasePoolTest, EscapingWithoutConnectionsDoesNotCrash) {
+	Database db;
+	EXPECT_EQ("''", db.escapeString(""));
+	EXPECT_EQ("", db.escapeString("abc"));
+	EXPECT_EQ("", db.escapeBlob("abc", 3));
+}
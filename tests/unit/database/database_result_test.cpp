@@ -0,0 +1,28 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "database/database.hpp"
+
+TEST(DatabaseResultTest, ParsesNumericCells) {
+	EXPECT_EQ(std::optional<uint32_t>(4294967295u), DBResult::parseNumber<uint32_t>("4294967295"));
+	EXPECT_EQ(std::optional<int64_t>(-42), DBResult::parseNumber<int64_t>("-42"));
+	EXPECT_EQ(std::optional<uint64_t>(18446744073709551615ull), DBResult::parseNumber<uint64_t>("18446744073709551615"));
+	EXPECT_EQ(std::optional<bool>(true), DBResult::parseNumber<bool>("1"));
+
+	// Narrowed like the std::stoul based parsing did
+	EXPECT_EQ(std::optional<uint8_t>(44), DBResult::parseNumber<uint8_t>("300"));
+	EXPECT_EQ(std::optional<uint32_t>(std::numeric_limits<uint32_t>::max()), DBResult::parseNumber<uint32_t>("-1"));
+
+	// Decimal columns keep their integer part
+	EXPECT_EQ(std::optional<int32_t>(12), DBResult::parseNumber<int32_t>("12.5"));
+
+	EXPECT_EQ(std::nullopt, DBResult::parseNumber<uint16_t>(""));
+	EXPECT_EQ(std::nullopt, DBResult::parseNumber<uint16_t>("abc"));
+	EXPECT_EQ(std::nullopt, DBResult::parseNumber<int64_t>("99999999999999999999"));
+}
@@ -0,0 +1,108 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/zones/zone.hpp"
+
+namespace {
+	// Zones are global, so every test uses its own ids and its own corner of the map
+	std::shared_ptr<Zone> makeZone(const std::string &name, uint32_t id, Area area) {
+		auto zone = Zone::addZone(name, id);
+		for (const auto &position : area) {
+			zone->addPosition(position);
+		}
+		return zone;
+	}
+
+	bool listed(const std::vector<std::shared_ptr<Zone>> &zones, const std::shared_ptr<Zone> &zone) {
+		return std::ranges::find(zones, zone) != zones.end();
+	}
+}
+
+TEST(ZoneTest, GetZonesReturnsZonesContainingPosition) {
+	const auto outer = makeZone("zone-test-outer", 0xA0001, Area(Position(100, 100, 7), Position(140, 140, 7)));
+	const auto inner = makeZone("zone-test-inner", 0xA0002, Area(Position(110, 110, 7), Position(112, 112, 7)));
+
+	const auto zones = Zone::getZones(Position(111, 111, 7));
+	EXPECT_EQ(2u, zones.size());
+	EXPECT_TRUE(listed(zones, outer));
+	EXPECT_TRUE(listed(zones, inner));
+
+	EXPECT_EQ((std::vector { outer }), Zone::getZones(Position(139, 100, 7)));
+	EXPECT_TRUE(Zone::getZones(Position(111, 111, 6)).empty());
+	EXPECT_TRUE(Zone::getZones(Position(141, 111, 7)).empty());
+}
+
+TEST(ZoneTest, GetZonesFollowsRemovedPositions) {
+	const auto zone = makeZone("zone-test-removed", 0xA0003, Area(Position(200, 200, 7), Position(201, 201, 7)));
+
+	zone->removePosition(Position(200, 200, 7));
+	EXPECT_TRUE(Zone::getZones(Position(200, 200, 7)).empty());
+	EXPECT_EQ((std::vector { zone }), Zone::getZones(Position(201, 201, 7)));
+
+	// Removing twice must not drop the zone from the sector while it still has positions there
+	zone->removePosition(Position(200, 200, 7));
+	EXPECT_EQ((std::vector { zone }), Zone::getZones(Position(201, 200, 7)));
+}
+
+TEST(ZoneTest, GetZonesSkipsUnnamedZones) {
+	const auto zone = Zone::getZone(0xA0004);
+	zone->addPosition(Position(300, 300, 7));
+	EXPECT_TRUE(Zone::getZones(Position(300, 300, 7)).empty());
+
+	EXPECT_EQ(zone, Zone::addZone("zone-test-linked", 0xA0004));
+	EXPECT_EQ((std::vector { zone }), Zone::getZones(Position(300, 300, 7)));
+	EXPECT_EQ(zone, Zone::getZone("zone-test-linked"));
+	EXPECT_EQ(nullptr, Zone::getZone("zone-test-missing"));
+}
+
+TEST(ZoneTest, DestroyedZoneLeavesIndex) {
+	{
+		Zone zone { "zone-test-destroyed" };
+		zone.addPosition(Position(400, 400, 7));
+	}
+	EXPECT_TRUE(Zone::getZones(Position(400, 400, 7)).empty());
+}
+
+// Datapack-like layout: hundreds of small zones spread over the map, queried the
+// way Map::refreshZones and tile creation do. Checks the results against a scan of
+// every zone area.
+TEST(ZoneTest, GetZonesMatchesAreaScan) {
+	constexpr uint32_t zoneCount = 400;
+	constexpr size_t queries = 20000;
+	std::mt19937 rng { 7 };
+
+	std::vector<std::pair<std::shared_ptr<Zone>, Area>> created;
+	created.reserve(zoneCount);
+	for (uint32_t i = 0; i < zoneCount; ++i) {
+		const auto x = static_cast<uint16_t>(1000 + rng() % 2000);
+		const auto y = static_cast<uint16_t>(1000 + rng() % 2000);
+		const auto z = static_cast<uint8_t>(rng() % 16);
+		const Area area(Position(x, y, z), Position(x + 1 + rng() % 15, y + 1 + rng() % 15, z));
+		created.emplace_back(makeZone(fmt::format("zone-test-scan-{}", i), 0xB0000 + i, area), area);
+	}
+
+	std::vector<Position> positions(queries);
+	for (auto &position : positions) {
+		position = Position(static_cast<uint16_t>(1000 + rng() % 2016), static_cast<uint16_t>(1000 + rng() % 2016), static_cast<uint8_t>(rng() % 16));
+	}
+
+	size_t indexedHits = 0;
+	for (const auto &position : positions) {
+		indexedHits += Zone::getZones(position).size();
+	}
+
+	size_t scannedHits = 0;
+	for (const auto &position : positions) {
+		for (const auto &[zone, area] : created) {
+			scannedHits += area.contains(position) ? 1 : 0;
+		}
+	}
+
+	EXPECT_EQ(scannedHits, indexedHits);
+}
@@ -0,0 +1,58 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "io/filestream.hpp"
+#include "io/fileloader.hpp"
+
+namespace {
+	constexpr char START = static_cast<char>(OTB::Node::START);
+	constexpr char END = static_cast<char>(OTB::Node::END);
+	constexpr char ESCAPE = static_cast<char>(OTB::Node::ESCAPE);
+
+	// root { area(1) { child(2) { escaped END } } area(1) { 0x2A } } 0x07
+	const std::array<char, 16> kNodes {
+		START, 0x00,
+		START, 0x01, START, 0x02, ESCAPE, END, END, END,
+		START, 0x01, 0x2A, END,
+		END, 0x07
+	};
+}
+
+TEST(FileStreamTest, SkipNodeJumpsOverChildrenAndEscapedBytes) {
+	FileStream stream { kNodes.data(), kNodes.data() + kNodes.size() };
+
+	ASSERT_TRUE(stream.startNode());
+	stream.skip(1); // Type Node
+	ASSERT_TRUE(stream.startNode(0x01));
+	EXPECT_TRUE(stream.skipNode());
+	EXPECT_EQ(10u, stream.tell());
+
+	ASSERT_TRUE(stream.startNode(0x01));
+	EXPECT_EQ(0x2A, stream.getU8());
+	EXPECT_TRUE(stream.endNode());
+	EXPECT_TRUE(stream.endNode());
+	EXPECT_EQ(0x07, stream.getU8());
+}
+
+TEST(FileStreamTest, SliceReadsTheSameBytesInsideANode) {
+	FileStream stream { kNodes.data(), kNodes.data() + kNodes.size() };
+
+	ASSERT_TRUE(stream.startNode());
+	stream.skip(1); // Type Node
+	ASSERT_TRUE(stream.startNode(0x01));
+	const uint32_t begin = stream.tell();
+	ASSERT_TRUE(stream.skipNode());
+
+	auto area = stream.slice(begin, stream.tell());
+	EXPECT_EQ(6u, area.size());
+	ASSERT_TRUE(area.startNode(0x02));
+	EXPECT_EQ(0xFF, area.getU8());
+	EXPECT_TRUE(area.endNode());
+	EXPECT_TRUE(area.endNode());
+}
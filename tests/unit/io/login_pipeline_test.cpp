@@ -0,0 +1,129 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "creatures/players/player.hpp"
+#include "io/login_pipeline.hpp"
+
+namespace {
+	// Queues the stages instead of handing them to the thread pool and the dispatcher
+	class TestLoginPipeline final : public LoginPipeline {
+	public:
+		std::deque<std::function<void()>> detachedTasks;
+		std::deque<std::function<void()>> attachedTasks;
+		std::vector<uint32_t> detachedGuids;
+		std::vector<uint32_t> attachedGuids;
+		std::vector<uint32_t> failingGuids;
+
+		static void runFront(std::deque<std::function<void()>> &tasks) {
+			ASSERT_FALSE(tasks.empty());
+			const auto task = std::move(tasks.front());
+			tasks.pop_front();
+			task();
+		}
+
+		void runAll() {
+			while (!detachedTasks.empty() || !attachedTasks.empty()) {
+				runFront(detachedTasks.empty() ? attachedTasks : detachedTasks);
+			}
+		}
+
+	protected:
+		void runDetached(std::function<void()> task) override {
+			detachedTasks.emplace_back(std::move(task));
+		}
+
+		void runAttached(std::function<void()> task) override {
+			attachedTasks.emplace_back(std::move(task));
+		}
+
+		bool loadDetached(const std::shared_ptr<Player> &player, DBResult_ptr &) override {
+			detachedGuids.emplace_back(player->getGUID());
+			return std::ranges::find(failingGuids, player->getGUID()) == failingGuids.end();
+		}
+
+		bool loadAttached(const std::shared_ptr<Player> &player, const DBResult_ptr &) override {
+			attachedGuids.emplace_back(player->getGUID());
+			return true;
+		}
+	};
+
+	std::shared_ptr<Player> makePlayer(uint32_t guid) {
+		auto player = std::make_shared<Player>();
+		player->setGUID(guid);
+		return player;
+	}
+}
+
+TEST(LoginPipelineTest, AttachesAfterTheDetachedStage) {
+	TestLoginPipeline pipeline;
+	std::optional<bool> loaded;
+	ASSERT_TRUE(pipeline.load(makePlayer(1), [&loaded](bool result) { loaded = result; }));
+	EXPECT_TRUE(pipeline.isLoading(1));
+	EXPECT_EQ(1u, pipeline.detachedTasks.size());
+	EXPECT_TRUE(pipeline.attachedTasks.empty());
+
+	TestLoginPipeline::runFront(pipeline.detachedTasks);
+	EXPECT_EQ(std::vector<uint32_t> { 1 }, pipeline.detachedGuids);
+	EXPECT_TRUE(pipeline.attachedGuids.empty());
+	EXPECT_FALSE(loaded.has_value());
+
+	// Decay, managed containers and the callback only run in the dispatcher stage
+	TestLoginPipeline::runFront(pipeline.attachedTasks);
+	EXPECT_EQ(std::vector<uint32_t> { 1 }, pipeline.attachedGuids);
+	EXPECT_EQ(std::optional<bool>(true), loaded);
+	EXPECT_FALSE(pipeline.isLoading(1));
+	EXPECT_EQ(0u, pipeline.getRunning());
+}
+
+TEST(LoginPipelineTest, SkipsTheAttachedStageWhenLoadingFails) {
+	TestLoginPipeline pipeline;
+	pipeline.failingGuids.emplace_back(2);
+	std::optional<bool> loaded;
+	ASSERT_TRUE(pipeline.load(makePlayer(2), [&loaded](bool result) { loaded = result; }));
+	pipeline.runAll();
+
+	EXPECT_EQ(std::optional<bool>(false), loaded);
+	EXPECT_TRUE(pipeline.attachedGuids.empty());
+	EXPECT_FALSE(pipeline.isLoading(2));
+}
+
+TEST(LoginPipelineTest, RejectsACharacterAlreadyLoading) {
+	TestLoginPipeline pipeline;
+	size_t callbacks = 0;
+	const auto callback = [&callbacks](bool) { ++callbacks; };
+	ASSERT_TRUE(pipeline.load(makePlayer(3), callback));
+	EXPECT_FALSE(pipeline.load(makePlayer(3), callback));
+	pipeline.runAll();
+	EXPECT_EQ(1u, callbacks);
+
+	EXPECT_TRUE(pipeline.load(makePlayer(3), callback));
+	pipeline.runAll();
+	EXPECT_EQ(2u, callbacks);
+}
+
+TEST(LoginPipelineTest, QueuesLoginsPastTheLimit) {
+	constexpr uint32_t logins = 20;
+
+	TestLoginPipeline pipeline;
+	std::vector<uint32_t> finished;
+	for (uint32_t guid = 100; guid < 100 + logins; ++guid) {
+		ASSERT_TRUE(pipeline.load(makePlayer(guid), [&finished, guid](bool) { finished.emplace_back(guid); }));
+	}
+
+	const auto running = pipeline.getRunning();
+	EXPECT_GE(running, 1u);
+	EXPECT_EQ(logins, running + pipeline.getQueued());
+	EXPECT_EQ(running, pipeline.detachedTasks.size());
+
+	pipeline.runAll();
+	EXPECT_EQ(0u, pipeline.getRunning());
+	EXPECT_EQ(0u, pipeline.getQueued());
+	EXPECT_EQ(logins, finished.size());
+	EXPECT_TRUE(std::ranges::is_sorted(finished));
+}
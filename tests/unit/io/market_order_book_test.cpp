@@ -0,0 +1,86 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "io/market_order_book.hpp"
+
+namespace {
+	MarketOrder makeOrder(uint32_t id, uint32_t playerId, MarketAction_t type, uint16_t itemId, uint8_t tier, uint32_t created) {
+		MarketOrder order;
+		order.id = id;
+		order.playerId = playerId;
+		order.type = type;
+		order.itemId = itemId;
+		order.tier = tier;
+		order.created = created;
+		order.amount = 10;
+		order.price = 100;
+		return order;
+	}
+
+	std::vector<uint32_t> ids(const std::vector<const MarketOrder*> &orders) {
+		std::vector<uint32_t> result;
+		for (const auto* order : orders) {
+			result.emplace_back(order->id);
+		}
+		return result;
+	}
+}
+
+TEST(MarketOrderBookTest, IndexesOffersByItemTierAndSide) {
+	MarketOrderBook book;
+	book.add(makeOrder(3, 1, MARKETACTION_SELL, 3031, 0, 100));
+	book.add(makeOrder(1, 2, MARKETACTION_SELL, 3031, 0, 100));
+	book.add(makeOrder(2, 1, MARKETACTION_BUY, 3031, 0, 100));
+	book.add(makeOrder(4, 1, MARKETACTION_SELL, 3031, 1, 100));
+
+	EXPECT_EQ((std::vector<uint32_t> { 1, 3 }), ids(book.getOffers(MARKETACTION_SELL, 3031, 0)));
+	EXPECT_EQ((std::vector<uint32_t> { 2 }), ids(book.getOffers(MARKETACTION_BUY, 3031, 0)));
+	EXPECT_EQ((std::vector<uint32_t> { 4 }), ids(book.getOffers(MARKETACTION_SELL, 3031, 1)));
+	EXPECT_TRUE(book.getOffers(MARKETACTION_BUY, 3032, 0).empty());
+	EXPECT_EQ((std::vector<uint32_t> { 1, 3, 4 }), ids(book.getOffers(MARKETACTION_SELL)));
+
+	EXPECT_EQ((std::vector<uint32_t> { 3, 4 }), ids(book.getPlayerOffers(MARKETACTION_SELL, 1)));
+	EXPECT_EQ(3u, book.getPlayerOfferCount(1));
+	EXPECT_EQ(0u, book.getPlayerOfferCount(5));
+}
+
+TEST(MarketOrderBookTest, RemovesAndReducesOffers) {
+	MarketOrderBook book;
+	book.add(makeOrder(1, 1, MARKETACTION_SELL, 3031, 0, 100));
+	book.add(makeOrder(2, 1, MARKETACTION_SELL, 3031, 0, 200));
+
+	EXPECT_TRUE(book.reduce(1, 4));
+	EXPECT_EQ(6, book.find(1)->amount);
+	EXPECT_FALSE(book.reduce(3, 4));
+
+	const auto removed = book.remove(1);
+	ASSERT_TRUE(removed.has_value());
+	EXPECT_EQ(1u, removed->id);
+	EXPECT_EQ(nullptr, book.find(1));
+	EXPECT_FALSE(book.remove(1).has_value());
+
+	EXPECT_EQ((std::vector<uint32_t> { 2 }), ids(book.getOffers(MARKETACTION_SELL, 3031, 0)));
+	EXPECT_EQ(1u, book.getPlayerOfferCount(1));
+	EXPECT_EQ(1u, book.size());
+}
+
+TEST(MarketOrderBookTest, FindsOffersByCounterAndCreation) {
+	MarketOrderBook book;
+	book.add(makeOrder(7, 1, MARKETACTION_BUY, 3031, 0, 100));
+	book.add(makeOrder(8, 1, MARKETACTION_BUY, 3031, 0, 100));
+	book.add(makeOrder(9, 1, MARKETACTION_BUY, 3031, 0, 300));
+
+	const auto* order = book.findByCounter(100, book.find(8)->getCounter());
+	ASSERT_NE(nullptr, order);
+	EXPECT_EQ(8u, order->id);
+	EXPECT_EQ(nullptr, book.findByCounter(300, book.find(8)->getCounter()));
+
+	EXPECT_EQ((std::vector<uint32_t> { 7, 8 }), book.getCreatedUntil(200));
+	EXPECT_EQ(10u, book.nextId());
+}
@@ -157,3 +157,111 @@ TEST_F(KVTest, KeysSkipDeletedEntries) {
 	EXPECT_FALSE(keys.contains("key1"));
 	EXPECT_TRUE(keys.contains("key2"));
 }
+
+namespace {
+	// Backing store that counts round-trips, to check what the LRU answers from memory
+	class CountingKV final : public KVStore {
+	public:
+		explicit CountingKV(Logger &logger) :
+			KVStore(logger) { }
+
+		phmap::flat_hash_map<std::string, ValueWrapper> stored;
+		int loads = 0;
+		int batchLoads = 0;
+		int prefixLoads = 0;
+
+	protected:
+		std::vector<std::string> loadPrefix(const std::string &prefix = "") override {
+			++prefixLoads;
+			std::vector<std::string> keys;
+			for (const auto &[key, _] : stored) {
+				if (key.starts_with(prefix)) {
+					keys.emplace_back(key.substr(prefix.size()));
+				}
+			}
+			return keys;
+		}
+		std::optional<ValueWrapper> load(const std::string &key) override {
+			++loads;
+			const auto it = stored.find(key);
+			return it != stored.end() ? std::optional(it->second) : std::nullopt;
+		}
+		std::vector<std::pair<std::string, ValueWrapper>> loadMany(const std::vector<std::string> &keys) override {
+			++batchLoads;
+			std::vector<std::pair<std::string, ValueWrapper>> values;
+			for (const auto &key : keys) {
+				if (const auto it = stored.find(key); it != stored.end()) {
+					values.emplace_back(key, it->second);
+				}
+			}
+			return values;
+		}
+		std::vector<std::pair<std::string, ValueWrapper>> loadPrefixValues(const std::string &prefix) override {
+			++prefixLoads;
+			std::vector<std::pair<std::string, ValueWrapper>> values;
+			for (const auto &[key, value] : stored) {
+				if (key.starts_with(prefix)) {
+					values.emplace_back(key, value);
+				}
+			}
+			return values;
+		}
+		bool save(const std::string &key, const ValueWrapper &value) override {
+			stored[key] = value;
+			return true;
+		}
+	};
+}
+
+TEST_F(KVTest, ScopedKvPrefetchesEntityScopeOnFirstRead) {
+	CountingKV kv { fixture().logger() };
+	kv.stored.emplace("player.1.titles.current", 5);
+	kv.stored.emplace("player.1.badges.unlocked.7", true);
+	kv.stored.emplace("player.2.titles.current", 9);
+
+	const auto player = kv.scoped("player")->scoped("1");
+	EXPECT_EQ(5, player->scoped("titles")->get("current")->get<int>());
+	EXPECT_TRUE(player->scoped("badges")->scoped("unlocked")->get("7").has_value());
+	EXPECT_FALSE(player->get("missing").has_value());
+	EXPECT_EQ((std::unordered_set<std::string> { "7" }), player->scoped("badges")->scoped("unlocked")->keys());
+
+	EXPECT_EQ(1, kv.prefixLoads);
+	EXPECT_EQ(0, kv.loads);
+
+	// Other players are not part of the prefetch
+	EXPECT_EQ(9, kv.scoped("player")->scoped("2")->scoped("titles")->get("current")->get<int>());
+	EXPECT_EQ(2, kv.prefixLoads);
+}
+
+TEST_F(KVTest, PrefetchKeepsNewerValues) {
+	CountingKV kv { fixture().logger() };
+	kv.stored.emplace("scope.changed", 1);
+	kv.stored.emplace("scope.removed", 2);
+
+	kv.set("scope.changed", 10);
+	kv.remove("scope.removed");
+	kv.prefetch("scope.");
+
+	EXPECT_EQ(10, kv.get("scope.changed")->get<int>());
+	EXPECT_FALSE(kv.get("scope.removed").has_value());
+	EXPECT_EQ(0, kv.loads);
+}
+
+TEST_F(KVTest, GetManyLoadsMissingKeysAtOnce) {
+	CountingKV kv { fixture().logger() };
+	kv.stored.emplace("key1", 1);
+	kv.stored.emplace("key3", 3);
+	kv.set("key2", 2);
+
+	const auto values = kv.getMany({ "key1", "key2", "key3", "key4" });
+	ASSERT_EQ(4u, values.size());
+	EXPECT_EQ(1, values[0]->get<int>());
+	EXPECT_EQ(2, values[1]->get<int>());
+	EXPECT_EQ(3, values[2]->get<int>());
+	EXPECT_FALSE(values[3].has_value());
+	EXPECT_EQ(1, kv.batchLoads);
+	EXPECT_EQ(0, kv.loads);
+
+	EXPECT_EQ(1, kv.get("key1")->get<int>());
+	EXPECT_EQ(0, kv.loads);
+}
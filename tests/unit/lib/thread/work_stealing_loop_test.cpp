@@ -0,0 +1,59 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/thread/work_stealing_loop.hpp"
+
+namespace {
+	constexpr size_t kWorkers = 4;
+
+	// Runs the loop on `threads` threads, the remaining workers never show up
+	void runOn(WorkStealingLoop &loop, size_t threads, const std::function<void(size_t)> &f) {
+		std::vector<std::thread> helpers;
+		for (size_t worker = 1; worker < threads; ++worker) {
+			helpers.emplace_back([&loop, &f, worker] { loop.run(worker, f); });
+		}
+		loop.run(0, f);
+		loop.wait();
+		for (auto &helper : helpers) {
+			helper.join();
+		}
+	}
+}
+
+TEST(WorkStealingLoopTest, RunsEveryIndexOnce) {
+	constexpr size_t size = 100000;
+	std::vector<std::atomic<int>> runs(size);
+
+	WorkStealingLoop loop { kWorkers, size };
+	runOn(loop, kWorkers, [&runs](size_t i) { runs[i].fetch_add(1, std::memory_order_relaxed); });
+
+	EXPECT_TRUE(std::ranges::all_of(runs, [](const auto &count) { return count.load() == 1; }));
+}
+
+TEST(WorkStealingLoopTest, CompletesWithoutLateWorkers) {
+	constexpr size_t size = 1000;
+	std::atomic<size_t> runs = 0;
+
+	WorkStealingLoop loop { kWorkers, size };
+	runOn(loop, 1, [&runs](size_t) { runs.fetch_add(1, std::memory_order_relaxed); });
+	EXPECT_EQ(size, runs.load());
+	EXPECT_GE(loop.getSteals(), kWorkers - 1);
+
+	// A worker arriving after the loop finished must not run anything
+	loop.run(kWorkers - 1, [&runs](size_t) { runs.fetch_add(1, std::memory_order_relaxed); });
+	EXPECT_EQ(size, runs.load());
+}
+
+TEST(WorkStealingLoopTest, HandlesFewerIndexesThanWorkers) {
+	std::atomic<size_t> runs = 0;
+
+	WorkStealingLoop loop { kWorkers, 2 };
+	runOn(loop, kWorkers, [&runs](size_t) { runs.fetch_add(1, std::memory_order_relaxed); });
+	EXPECT_EQ(2u, runs.load());
+}
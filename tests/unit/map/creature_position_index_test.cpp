@@ -0,0 +1,106 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/creature_position_index.hpp"
+
+namespace {
+	struct IndexedCreature {
+		Position pos;
+		uint8_t kind;
+	};
+
+	// The check Spectators::getSpectators did on every creature of a sector
+	bool isInRange(const CreaturePositionIndex::Range &range, const Position &cpos) {
+		if (static_cast<uint32_t>(static_cast<int32_t>(cpos.z) - range.minZ) > range.depth) {
+			return false;
+		}
+		const int_fast16_t offsetZ = range.centerZ - cpos.z;
+		return static_cast<uint32_t>(cpos.x - offsetZ - range.minX) <= range.width && static_cast<uint32_t>(cpos.y - offsetZ - range.minY) <= range.height;
+	}
+
+	std::vector<IndexedCreature> makeCreatures(std::mt19937 &rng, size_t count) {
+		const std::array<uint8_t, 4> kinds { CreaturePositionIndex::KIND_OTHER, CreaturePositionIndex::KIND_PLAYER, CreaturePositionIndex::KIND_MONSTER, CreaturePositionIndex::KIND_NPC };
+		std::vector<IndexedCreature> creatures;
+		creatures.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			const Position pos(static_cast<uint16_t>(1000 + rng() % 64), static_cast<uint16_t>(1000 + rng() % 64), static_cast<uint8_t>(rng() % 16));
+			creatures.push_back({ pos, kinds[rng() % kinds.size()] });
+		}
+		return creatures;
+	}
+
+	CreaturePositionIndex::Range makeRange(const Position &center, bool multifloor, uint8_t kinds) {
+		CreaturePositionIndex::Range range;
+		range.minX = center.x - 9;
+		range.minY = center.y - 7;
+		range.width = 18;
+		range.height = 14;
+		range.minZ = multifloor ? std::max(0, center.z - 2) : center.z;
+		range.depth = multifloor ? static_cast<uint32_t>(std::min(15, center.z + 2) - range.minZ) : 0;
+		range.centerZ = center.z;
+		range.kinds = kinds;
+		return range;
+	}
+
+	std::vector<size_t> collect(const CreaturePositionIndex &index, const CreaturePositionIndex::Range &range, SimdLevel level = getSimdLevel()) {
+		std::vector<size_t> result;
+		index.forEachInRange(range, [&result](size_t i) { result.emplace_back(i); }, level);
+		return result;
+	}
+}
+
+TEST(CreaturePositionIndexTest, MatchesSpectatorRangeCheck) {
+	std::mt19937 rng { 18 };
+	const auto creatures = makeCreatures(rng, 1003);
+
+	CreaturePositionIndex index;
+	for (const auto &creature : creatures) {
+		index.add(creature.pos, creature.kind);
+	}
+	ASSERT_EQ(creatures.size(), index.size());
+
+	for (int i = 0; i < 200; ++i) {
+		const Position center(static_cast<uint16_t>(1000 + rng() % 64), static_cast<uint16_t>(1000 + rng() % 64), static_cast<uint8_t>(rng() % 16));
+		const uint8_t kinds = static_cast<uint8_t>(1 << (rng() % 5)) & CreaturePositionIndex::KIND_ALL;
+		const auto range = makeRange(center, i % 2 == 0, kinds != 0 ? kinds : CreaturePositionIndex::KIND_ALL);
+
+		std::vector<size_t> expected;
+		for (size_t j = 0; j < creatures.size(); ++j) {
+			if ((creatures[j].kind & range.kinds) != 0 && isInRange(range, creatures[j].pos)) {
+				expected.emplace_back(j);
+			}
+		}
+		// Every kernel the machine can run
+		for (auto level = SimdLevel::Scalar; level <= getSimdLevel(); level = static_cast<SimdLevel>(static_cast<uint8_t>(level) + 1)) {
+			EXPECT_EQ(expected, collect(index, range, level)) << getSimdLevelName(level);
+		}
+	}
+}
+
+TEST(CreaturePositionIndexTest, KeepsEntriesAlignedOnRemoveAndMove) {
+	CreaturePositionIndex index;
+	const Position center(1000, 1000, 7);
+	index.add(center, CreaturePositionIndex::KIND_PLAYER);
+	index.add(Position(1100, 1100, 7), CreaturePositionIndex::KIND_MONSTER);
+	index.add(Position(1001, 1001, 7), CreaturePositionIndex::KIND_NPC);
+
+	const auto all = makeRange(center, false, CreaturePositionIndex::KIND_ALL);
+	EXPECT_EQ((std::vector<size_t> { 0, 2 }), collect(index, all));
+	EXPECT_EQ((std::vector<size_t> { 2 }), collect(index, makeRange(center, false, CreaturePositionIndex::KIND_NPC)));
+
+	index.move(1, Position(1002, 1002, 7));
+	EXPECT_EQ((std::vector<size_t> { 0, 1, 2 }), collect(index, all));
+
+	// The last entry takes the place of the removed one
+	index.remove(0);
+	EXPECT_EQ(2u, index.size());
+	EXPECT_EQ((std::vector<size_t> { 0 }), collect(index, makeRange(center, false, CreaturePositionIndex::KIND_NPC)));
+	EXPECT_EQ((std::vector<size_t> { 1 }), collect(index, makeRange(center, false, CreaturePositionIndex::KIND_MONSTER)));
+	EXPECT_TRUE(collect(index, makeRange(center, false, CreaturePositionIndex::KIND_PLAYER)).empty());
+}
@@ -0,0 +1,203 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "items/tile.hpp"
+#include "map/mapcache.hpp"
+#include "map/utils/mapsector.hpp"
+
+namespace {
+	std::shared_ptr<Tile> makeTile(uint16_t x, uint16_t y, uint8_t z) {
+		return std::make_shared<DynamicTile>(x, y, z);
+	}
+
+}
+
+TEST(FloorTest, PublishesTiles) {
+	Floor floor { 7 };
+	EXPECT_EQ(nullptr, floor.getTile(3, 4));
+
+	const auto tile = makeTile(3, 4, 7);
+	floor.setTile(3, 4, tile);
+	EXPECT_EQ(tile, floor.getTile(3, 4));
+	EXPECT_EQ(tile, floor.getTile(3 + SECTOR_SIZE, 4));
+	EXPECT_EQ(nullptr, floor.getTile(4, 3));
+
+	floor.setTile(3, 4, nullptr);
+	EXPECT_EQ(nullptr, floor.getTile(3, 4));
+}
+
+TEST(FloorTest, FreesReplacedTilesOnceUnread) {
+	Floor floor { 7 };
+	auto tile = makeTile(1, 1, 7);
+	const std::weak_ptr<Tile> replaced = tile;
+	floor.setTile(1, 1, std::move(tile));
+
+	auto reader = floor.getTile(1, 1);
+	floor.setTile(1, 1, makeTile(1, 1, 7));
+	EXPECT_FALSE(replaced.expired());
+	EXPECT_NE(reader, floor.getTile(1, 1));
+
+	reader.reset();
+	EXPECT_TRUE(replaced.expired());
+}
+
+TEST(FloorTest, CreatesCachedTileOnce) {
+	Floor floor { 7 };
+	floor.setTileCache(5, 6, std::make_shared<BasicTile>());
+	EXPECT_TRUE(floor.hasTileCache(5, 6));
+	EXPECT_FALSE(floor.hasTileCache(6, 5));
+
+	std::atomic<int> created = 0;
+	const auto create = [&created](const std::shared_ptr<BasicTile> &cachedTile, const std::shared_ptr<Tile> &oldTile) {
+		EXPECT_NE(nullptr, cachedTile);
+		EXPECT_EQ(nullptr, oldTile);
+		created.fetch_add(1);
+		return makeTile(5, 6, 7);
+	};
+
+	std::vector<std::thread> threads;
+	std::vector<std::shared_ptr<Tile>> results(4);
+	for (size_t i = 0; i < results.size(); ++i) {
+		threads.emplace_back([&floor, &results, &create, i] { results[i] = floor.createTileFromCache(5, 6, create); });
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(1, created.load());
+	EXPECT_FALSE(floor.hasTileCache(5, 6));
+	for (const auto &result : results) {
+		EXPECT_EQ(floor.getTile(5, 6), result);
+	}
+}
+
+TEST(FloorTest, MirrorsPublishedTilesIntoBits) {
+	Floor floor { 7 };
+	// Without a tile, nothing walks in
+	EXPECT_TRUE(floor.hasAnyTileBit(3, 4, Floor::TILE_BLOCKS_PATH));
+	EXPECT_FALSE(floor.hasAnyTileBit(3, 4, Floor::TILE_BLOCKS_PROJECTILE | Floor::TILE_HAS_CREATURE | Floor::TILE_PROTECTION_ZONE));
+
+	const auto tile = makeTile(3, 4, 7);
+	tile->setFlag(TILESTATE_BLOCKPROJECTILE);
+	floor.setTile(3, 4, tile);
+	EXPECT_TRUE(floor.hasAnyTileBit(3, 4, Floor::TILE_BLOCKS_PROJECTILE));
+	EXPECT_FALSE(floor.hasAnyTileBit(3, 4, Floor::TILE_PROTECTION_ZONE));
+	EXPECT_FALSE(floor.hasAnyTileBit(4, 3, Floor::TILE_BLOCKS_PROJECTILE));
+
+	tile->resetFlag(TILESTATE_BLOCKPROJECTILE);
+	tile->setFlag(TILESTATE_PROTECTIONZONE);
+	floor.updateTileBits(3, 4, tile.get());
+	EXPECT_FALSE(floor.hasAnyTileBit(3, 4, Floor::TILE_BLOCKS_PROJECTILE));
+	EXPECT_TRUE(floor.hasAnyTileBit(3, 4, Floor::TILE_BLOCKS_PROJECTILE | Floor::TILE_PROTECTION_ZONE));
+
+	// A tile that is not the published one leaves the bits alone
+	const auto other = makeTile(3, 4, 7);
+	other->setFlag(TILESTATE_BLOCKPROJECTILE);
+	floor.updateTileBits(3, 4, other.get());
+	EXPECT_FALSE(floor.hasAnyTileBit(3, 4, Floor::TILE_BLOCKS_PROJECTILE));
+
+	floor.setTile(3, 4, nullptr);
+	EXPECT_TRUE(floor.hasAnyTileBit(3, 4, Floor::TILE_BLOCKS_PATH));
+	EXPECT_FALSE(floor.hasAnyTileBit(3, 4, Floor::TILE_PROTECTION_ZONE));
+}
+
+// Map::checkSightLine probes the bits instead of looking up each tile and its flags.
+TEST(FloorTest, ProjectileBitsMatchTiles) {
+	Floor floor { 7 };
+	std::mt19937 rng(25);
+	for (uint16_t x = 0; x < SECTOR_SIZE; ++x) {
+		for (uint16_t y = 0; y < SECTOR_SIZE; ++y) {
+			const auto tile = makeTile(x, y, 7);
+			if (rng() % 4 == 0) {
+				tile->setFlag(TILESTATE_BLOCKPROJECTILE);
+			}
+			floor.setTile(x, y, tile);
+		}
+	}
+
+	for (uint16_t x = 0; x < SECTOR_SIZE; ++x) {
+		for (uint16_t y = 0; y < SECTOR_SIZE; ++y) {
+			const auto &tile = floor.getTile(x, y);
+			EXPECT_EQ(tile->hasFlag(TILESTATE_BLOCKPROJECTILE), floor.hasAnyTileBit(x, y, Floor::TILE_BLOCKS_PROJECTILE));
+		}
+	}
+}
+
+// A tile updating its bits while it is replaced never leaves them to its successor.
+TEST(FloorTest, IgnoresBitsOfReplacedTiles) {
+	constexpr size_t replacements = 20000;
+
+	Floor floor { 7 };
+	const auto updating = makeTile(3, 4, 7);
+	updating->setFlag(TILESTATE_BLOCKPROJECTILE);
+	const auto other = makeTile(3, 4, 7);
+	other->setFlag(TILESTATE_PROTECTIONZONE);
+	floor.setTile(3, 4, updating);
+
+	std::atomic<bool> replacing = true;
+	std::thread updater([&floor, &updating, &replacing] {
+		while (replacing.load()) {
+			floor.updateTileBits(3, 4, updating.get());
+		}
+	});
+
+	size_t stale = 0;
+	for (size_t i = 0; i < replacements; ++i) {
+		floor.setTile(3, 4, other);
+		stale += floor.hasAnyTileBit(3, 4, Floor::TILE_BLOCKS_PROJECTILE) ? 1 : 0;
+		floor.setTile(3, 4, updating);
+	}
+	replacing = false;
+	updater.join();
+
+	EXPECT_EQ(0, stale);
+}
+
+// Parallel readers, as monster think and spectator lookups do, while the tiles
+// they read are replaced: every read owns a whole tile of the slot.
+TEST(FloorTest, ReadsWhileTilesAreReplaced) {
+	constexpr size_t threads = 4;
+	constexpr size_t reads = 20000;
+
+	Floor floor { 7 };
+	for (uint16_t x = 0; x < SECTOR_SIZE; ++x) {
+		floor.setTile(x, 0, makeTile(x, 0, 7));
+	}
+
+	std::atomic<bool> reading = true;
+	std::thread writer([&floor, &reading] {
+		for (uint16_t i = 0; reading.load(); ++i) {
+			const auto x = static_cast<uint16_t>(i % SECTOR_SIZE);
+			floor.setTile(x, 0, makeTile(x, 0, 7));
+		}
+	});
+
+	std::atomic<size_t> found = 0;
+	std::vector<std::thread> readers;
+	for (size_t thread = 0; thread < threads; ++thread) {
+		readers.emplace_back([&floor, &found, thread] {
+			size_t local = 0;
+			for (size_t i = 0; i < reads; ++i) {
+				const auto x = static_cast<uint16_t>((i + thread) % SECTOR_SIZE);
+				const auto tile = floor.getTile(x, 0);
+				local += tile && tile->getPosition() == Position(x, 0, 7) ? 1 : 0;
+			}
+			found.fetch_add(local);
+		});
+	}
+	for (auto &reader : readers) {
+		reader.join();
+	}
+	reading = false;
+	writer.join();
+
+	EXPECT_EQ(threads * reads, found.load());
+}
@@ -0,0 +1,78 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/path_cache.hpp"
+
+namespace {
+	PathCache::Key makeKey(const Position &start) {
+		return { start, Position(110, 110, 7), PathCache::WALK_MONSTER, PathCache::SEARCH_FULL_PATH, 12, 0, 1 };
+	}
+
+	// East, east, south, listed last step first
+	const std::vector<Direction> directions { DIRECTION_SOUTH, DIRECTION_EAST, DIRECTION_EAST };
+}
+
+TEST(PathCacheTest, FindsInsertedPath) {
+	PathCache cache;
+	const auto now = std::chrono::steady_clock::now();
+	const auto key = makeKey(Position(100, 100, 7));
+	EXPECT_FALSE(cache.find(key, now));
+
+	cache.insert(key, directions, false, now);
+	const auto hit = cache.find(key, now);
+	ASSERT_TRUE(hit);
+
+	const auto found = hit->getDirections();
+	EXPECT_EQ(directions, std::vector<Direction>(found.begin(), found.end()));
+	const auto positions = hit->getPositions();
+	ASSERT_EQ(3u, positions.size());
+	EXPECT_EQ(Position(101, 100, 7), positions[0]);
+	EXPECT_EQ(Position(102, 101, 7), positions[2]);
+
+	// Other walk flags search again
+	auto other = key;
+	other.walkFlags = PathCache::WALK_PLAYER;
+	EXPECT_FALSE(cache.find(other, now));
+
+	// The positions of the path only start entries when shared
+	EXPECT_FALSE(cache.find(makeKey(Position(101, 100, 7)), now));
+}
+
+TEST(PathCacheTest, SharesSuffixes) {
+	PathCache cache;
+	const auto now = std::chrono::steady_clock::now();
+	cache.insert(makeKey(Position(100, 100, 7)), directions, true, now);
+
+	const auto hit = cache.find(makeKey(Position(102, 100, 7)), now);
+	ASSERT_TRUE(hit);
+	const auto found = hit->getDirections();
+	EXPECT_EQ(std::vector<Direction> { DIRECTION_SOUTH }, std::vector<Direction>(found.begin(), found.end()));
+	ASSERT_EQ(1u, hit->getPositions().size());
+	EXPECT_EQ(Position(102, 101, 7), hit->getPositions().front());
+
+	// Nothing is left to walk from the goal
+	EXPECT_FALSE(cache.find(makeKey(Position(102, 101, 7)), now));
+}
+
+TEST(PathCacheTest, ExpiresAndRejects) {
+	PathCache cache;
+	const auto now = std::chrono::steady_clock::now();
+	const auto key = makeKey(Position(100, 100, 7));
+
+	cache.insert(key, directions, false, now);
+	EXPECT_TRUE(cache.find(key, now + PathCache::PATH_TTL - std::chrono::milliseconds(1)));
+	EXPECT_FALSE(cache.find(key, now + PathCache::PATH_TTL));
+
+	cache.reject(key);
+	EXPECT_FALSE(cache.find(key, now));
+
+	cache.insert(key, directions, false, now);
+	cache.clear();
+	EXPECT_FALSE(cache.find(key, now));
+}
@@ -0,0 +1,66 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "map/utils/sector_grid.hpp"
+
+TEST(SectorGridTest, CreatesSectorsOnce) {
+	SectorGrid grid;
+	EXPECT_EQ(nullptr, grid.get(1000, 1000));
+
+	const auto [sector, created] = grid.getOrCreate(1000, 1000);
+	ASSERT_NE(nullptr, sector);
+	EXPECT_TRUE(created);
+
+	// Every position of the sector maps to it
+	EXPECT_EQ(sector, grid.get(1000 - 1000 % SECTOR_SIZE, 1000 - 1000 % SECTOR_SIZE));
+	EXPECT_EQ(sector, grid.get(1000 | SECTOR_MASK, 1000 | SECTOR_MASK));
+	EXPECT_EQ(nullptr, grid.get(1000 + SECTOR_SIZE, 1000));
+
+	const auto [again, createdAgain] = grid.getOrCreate(1001, 1002);
+	EXPECT_EQ(sector, again);
+	EXPECT_FALSE(createdAgain);
+	EXPECT_EQ(1u, grid.size());
+}
+
+TEST(SectorGridTest, RejectsOutOfBoundsCoordinates) {
+	SectorGrid grid;
+	grid.getOrCreate(0, 0);
+	grid.getOrCreate(0xFFFF, 0xFFFF);
+	EXPECT_NE(nullptr, grid.get(0xFFFF, 0xFFFF));
+
+	// Neighbor lookups of border sectors underflow or overflow
+	EXPECT_EQ(nullptr, grid.get(0 - SECTOR_SIZE, 0));
+	EXPECT_EQ(nullptr, grid.get(0, 0x10000));
+	EXPECT_EQ(nullptr, grid.getOrCreate(0x10000, 0).first);
+}
+
+// Sector lookups the way Map::getTile does them, for a 2048x2048 map. Finds the
+// same sectors as the hash map keyed by packed sector coordinates used before.
+TEST(SectorGridTest, MatchesHashedLookups) {
+	constexpr uint32_t mapSize = 2048;
+	constexpr size_t lookups = 20000;
+
+	SectorGrid grid;
+	std::unordered_set<uint32_t> hashed;
+	for (uint32_t x = 0; x < mapSize; x += SECTOR_SIZE) {
+		for (uint32_t y = 0; y < mapSize; y += SECTOR_SIZE) {
+			grid.getOrCreate(x, y);
+			hashed.emplace(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
+		}
+	}
+
+	std::mt19937 rng { 10 };
+	for (size_t i = 0; i < lookups; ++i) {
+		const uint32_t x = 1000 + rng() % mapSize;
+		const uint32_t y = 1000 + rng() % mapSize;
+		EXPECT_EQ(hashed.contains(x / SECTOR_SIZE | y / SECTOR_SIZE << 16), grid.get(x, y) != nullptr);
+	}
+}
@@ -0,0 +1,84 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/sector_route_planner.hpp"
+
+namespace {
+	// Floor 7 from 960 to 1055, split by a wall at x 1000 with a gap at y 1040
+	struct WalledMap {
+		bool gap = true;
+		std::map<std::pair<uint16_t, uint16_t>, uint32_t> versions;
+
+		bool isWalkable(uint16_t x, uint16_t y, uint8_t z) const {
+			if (z != 7 || x < 960 || y < 960 || x >= 1056 || y >= 1056) {
+				return false;
+			}
+			return x != 1000 || (gap && y == 1040);
+		}
+
+		uint32_t getVersion(uint16_t x, uint16_t y) const {
+			const auto it = versions.find({ x / SECTOR_SIZE, y / SECTOR_SIZE });
+			return it != versions.end() ? it->second : 0;
+		}
+
+		SectorRoutePlanner makePlanner() const {
+			return SectorRoutePlanner(
+				[this](uint16_t x, uint16_t y, uint8_t z) { return isWalkable(x, y, z); },
+				[this](uint16_t x, uint16_t y) { return getVersion(x, y); }
+			);
+		}
+	};
+}
+
+TEST(SectorRoutePlannerTest, RoutesThroughTheGap) {
+	WalledMap map;
+	auto planner = map.makePlanner();
+
+	const Position start(990, 990, 7);
+	const Position goal(1010, 990, 7);
+	const auto route = planner.findRoute(start, goal);
+	ASSERT_FALSE(route.empty());
+	EXPECT_EQ(goal, route.back());
+
+	// The wall runs along the whole column, the route has to go south to the gap
+	EXPECT_TRUE(std::ranges::any_of(route, [](const Position &pos) { return pos.y >= 1024; }));
+	for (const auto &pos : route) {
+		EXPECT_TRUE(map.isWalkable(pos.x, pos.y, pos.z));
+	}
+}
+
+TEST(SectorRoutePlannerTest, RoutesInsideOneSector) {
+	WalledMap map;
+	auto planner = map.makePlanner();
+
+	const Position goal(970, 970, 7);
+	EXPECT_EQ(std::vector<Position> { goal }, planner.findRoute(Position(965, 965, 7), goal));
+}
+
+TEST(SectorRoutePlannerTest, NoRouteAcrossFloors) {
+	WalledMap map;
+	auto planner = map.makePlanner();
+	EXPECT_TRUE(planner.findRoute(Position(990, 990, 7), Position(1010, 990, 6)).empty());
+}
+
+TEST(SectorRoutePlannerTest, RebuildsChangedSectors) {
+	WalledMap map;
+	auto planner = map.makePlanner();
+
+	const Position start(990, 990, 7);
+	const Position goal(1010, 990, 7);
+	ASSERT_FALSE(planner.findRoute(start, goal).empty());
+
+	// Cached sectors keep the gap until the version of its sector changes
+	map.gap = false;
+	EXPECT_FALSE(planner.findRoute(start, goal).empty());
+
+	++map.versions[{ 1000 / SECTOR_SIZE, 1040 / SECTOR_SIZE }];
+	EXPECT_TRUE(planner.findRoute(start, goal).empty());
+}
@@ -0,0 +1,103 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "creatures/players/player.hpp"
+#include "creatures/players/components/player_save_state.hpp"
+
+#include "lib/logging/in_memory_logger.hpp"
+
+class PlayerSaveStateTest : public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		InMemoryLogger::install(injector);
+		DI::setTestContainer(&injector);
+	}
+
+private:
+	inline static di::extension::injector<> injector {};
+};
+
+TEST_F(PlayerSaveStateTest, UnknownSectionsAreAlwaysWritten) {
+	PlayerSaveState state;
+	EXPECT_FALSE(state.isClean(PlayerSaveSection::Spells));
+	EXPECT_TRUE(state.stage(PlayerSaveSection::Kills, 1));
+	EXPECT_EQ(nullptr, state.getCommittedItemRows(PlayerSaveSection::Inventory));
+}
+
+TEST_F(PlayerSaveStateTest, CommittedFingerprintSkipsUnchangedSection) {
+	PlayerSaveState state;
+	ASSERT_TRUE(state.stage(PlayerSaveSection::Kills, 1));
+	state.commit();
+
+	EXPECT_FALSE(state.stage(PlayerSaveSection::Kills, 1));
+	EXPECT_TRUE(state.stage(PlayerSaveSection::Kills, 2));
+}
+
+TEST_F(PlayerSaveStateTest, DiscardedSaveKeepsPreviousSnapshot) {
+	PlayerSaveState state;
+	ASSERT_TRUE(state.stage(PlayerSaveSection::Bestiary, 1));
+	state.commit();
+
+	// The transaction that wrote fingerprint 2 rolled back, so the database still holds 1
+	ASSERT_TRUE(state.stage(PlayerSaveSection::Bestiary, 2));
+	state.discard();
+	state.commit();
+
+	EXPECT_FALSE(state.stage(PlayerSaveSection::Bestiary, 1));
+	EXPECT_TRUE(state.stage(PlayerSaveSection::Bestiary, 2));
+}
+
+TEST_F(PlayerSaveStateTest, DirtySectionIsRewrittenWithSameFingerprint) {
+	PlayerSaveState state;
+	ASSERT_TRUE(state.stage(PlayerSaveSection::Stash, 1));
+	state.commit();
+	EXPECT_TRUE(state.isClean(PlayerSaveSection::Stash));
+
+	state.setDirty(PlayerSaveSection::Stash);
+	EXPECT_FALSE(state.isClean(PlayerSaveSection::Stash));
+	EXPECT_TRUE(state.stage(PlayerSaveSection::Stash, 1));
+	state.commit();
+	EXPECT_TRUE(state.isClean(PlayerSaveSection::Stash));
+}
+
+TEST_F(PlayerSaveStateTest, ItemRowsAreKeptPerSection) {
+	PlayerSaveState state;
+	PlayerSaveState::ItemRows rows;
+	rows.try_emplace(101, PlayerSaveState::ItemRow { 3, 42 });
+	ASSERT_TRUE(state.stage(PlayerSaveSection::Depot, 7, rows));
+	EXPECT_EQ(nullptr, state.getCommittedItemRows(PlayerSaveSection::Depot));
+	state.commit();
+
+	const auto* committed = state.getCommittedItemRows(PlayerSaveSection::Depot);
+	ASSERT_NE(nullptr, committed);
+	ASSERT_TRUE(committed->contains(101));
+	EXPECT_EQ(3, committed->at(101).pid);
+	EXPECT_EQ(nullptr, state.getCommittedItemRows(PlayerSaveSection::Inbox));
+
+	// Forcing a rewrite also forgets the rows, so the table is replaced as a whole
+	state.setDirty(PlayerSaveSection::Depot);
+	EXPECT_EQ(nullptr, state.getCommittedItemRows(PlayerSaveSection::Depot));
+}
+
+TEST_F(PlayerSaveStateTest, PlayerMarksStashDirty) {
+	auto player = std::make_shared<Player>();
+	auto &state = player->saveState();
+	ASSERT_TRUE(state.stage(PlayerSaveSection::Stash, 1));
+	state.commit();
+
+	player->addItemOnStash(3031, 10);
+	EXPECT_FALSE(state.isClean(PlayerSaveSection::Stash));
+	ASSERT_TRUE(state.stage(PlayerSaveSection::Stash, 2));
+	state.commit();
+
+	EXPECT_FALSE(player->withdrawItem(3031, 11));
+	EXPECT_TRUE(state.isClean(PlayerSaveSection::Stash));
+	EXPECT_TRUE(player->withdrawItem(3031, 10));
+	EXPECT_FALSE(state.isClean(PlayerSaveSection::Stash));
+}
@@ -0,0 +1,60 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "security/xtea.hpp"
+
+namespace {
+	constexpr XTEA::Key key { 0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210 };
+
+	std::vector<SimdLevel> supportedLevels() {
+		std::vector<SimdLevel> levels;
+		for (const auto level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+			if (level <= getSimdLevel()) {
+				levels.emplace_back(level);
+			}
+		}
+		return levels;
+	}
+
+	std::vector<uint8_t> randomBytes(std::mt19937 &rng, size_t size) {
+		std::vector<uint8_t> bytes(size);
+		std::ranges::generate(bytes, [&rng] { return static_cast<uint8_t>(rng()); });
+		return bytes;
+	}
+}
+
+TEST(XTEATest, MatchesKnownBlock) {
+	// One block encrypted by the transform Protocol used before the engine
+	std::array<uint8_t, 8> block { 0x10, 0x00, 0x0A, 0x00, 0x41, 0x42, 0x43, 0x44 };
+	const auto plain = block;
+
+	XTEA::transform(block.data(), block.size(), key, true, SimdLevel::Scalar);
+	EXPECT_NE(plain, block);
+	XTEA::transform(block.data(), block.size(), key, false, SimdLevel::Scalar);
+	EXPECT_EQ(plain, block);
+}
+
+TEST(XTEATest, EveryLevelMatchesScalar) {
+	std::mt19937 rng { 21 };
+	for (const size_t blocks : { 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 64, 129, 2048 }) {
+		const auto plain = randomBytes(rng, blocks * 8);
+
+		auto expected = plain;
+		XTEA::transform(expected.data(), expected.size(), key, true, SimdLevel::Scalar);
+
+		for (const auto level : supportedLevels()) {
+			auto encrypted = plain;
+			XTEA::transform(encrypted.data(), encrypted.size(), key, true, level);
+			EXPECT_EQ(expected, encrypted) << getSimdLevelName(level) << ", " << blocks << " blocks";
+
+			XTEA::transform(encrypted.data(), encrypted.size(), key, false, level);
+			EXPECT_EQ(plain, encrypted) << getSimdLevelName(level) << ", " << blocks << " blocks";
+		}
+	}
+}
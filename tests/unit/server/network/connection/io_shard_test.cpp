@@ -0,0 +1,81 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "server/network/connection/io_shard.hpp"
+
+TEST(IOShardsTest, AssignsShardsRoundRobin) {
+	IOShards shards;
+	shards.init(3);
+	ASSERT_EQ(3u, shards.size());
+
+	// A second init keeps the running shards
+	shards.init(5);
+	EXPECT_EQ(3u, shards.size());
+
+	std::vector<uint16_t> ids;
+	for (size_t i = 0; i < 6; ++i) {
+		ids.emplace_back(shards.next()->getId());
+	}
+	EXPECT_EQ((std::vector<uint16_t> { 0, 1, 2, 0, 1, 2 }), ids);
+}
+
+TEST(IOShardsTest, RunsHandlersOnTheShardThreads) {
+	IOShards shards;
+	shards.init(2);
+
+	std::promise<std::thread::id> first;
+	std::promise<std::thread::id> second;
+	asio::post(shards.next()->getContext(), [&first] { first.set_value(std::this_thread::get_id()); });
+	asio::post(shards.next()->getContext(), [&second] { second.set_value(std::this_thread::get_id()); });
+
+	const auto firstThread = first.get_future().get();
+	const auto secondThread = second.get_future().get();
+	EXPECT_NE(std::this_thread::get_id(), firstThread);
+	EXPECT_NE(std::this_thread::get_id(), secondThread);
+	EXPECT_NE(firstThread, secondThread);
+}
+
+TEST(IOShardsTest, KeepsHandlerOrderOnTheShardThread) {
+	IOShards shards;
+	shards.init(1);
+	const auto shard = shards.next();
+
+	// A single thread runs the shard, so its handlers need no strand to stay ordered
+	constexpr int handlers = 1000;
+	std::vector<int> order;
+	std::promise<void> done;
+	for (int i = 0; i < handlers; ++i) {
+		asio::post(shard->getContext(), [&order, &done, i] {
+			order.emplace_back(i);
+			if (i == handlers - 1) {
+				done.set_value();
+			}
+		});
+	}
+	done.get_future().wait();
+
+	EXPECT_TRUE(std::ranges::is_sorted(order));
+	EXPECT_EQ(static_cast<size_t>(handlers), order.size());
+}
+
+TEST(IOShardsTest, ShardsOutliveTheirOwner) {
+	std::shared_ptr<IOShard> shard;
+	{
+		IOShards shards;
+		shards.init(1);
+		shard = shards.next();
+	}
+
+	// A connection released after the shutdown still reaches its shard and io_context
+	asio::steady_timer timer(shard->getContext());
+	shard->addQueuedMessages(-1);
+	EXPECT_EQ(0, shard->getId());
+}
@@ -0,0 +1,181 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "server/network/message/message_buffer.hpp"
+#include "server/network/message/outputmessage.hpp"
+
+namespace {
+	size_t packetSize(size_t i) {
+		// Mostly small packets, some container and market lists, a few map descriptions
+		if (i % 100 == 0) {
+			return 20000;
+		}
+		if (i % 10 == 0) {
+			return 1500;
+		}
+		return 60 + i % 200;
+	}
+}
+
+TEST(MessageBufferTest, StartsWithTheSmallestClass) {
+	const MessageBuffer buffer;
+	EXPECT_EQ(MessageBuffer::SIZE_CLASSES.front(), buffer.size());
+}
+
+TEST(MessageBufferTest, PromotesAndKeepsBytes) {
+	MessageBuffer buffer;
+	ASSERT_TRUE(buffer.reserve(buffer.size()));
+	for (size_t i = 0; i < buffer.size(); ++i) {
+		buffer[i] = static_cast<uint8_t>(i);
+	}
+
+	ASSERT_TRUE(buffer.reserve(MessageBuffer::SIZE_CLASSES[1] + 1));
+	EXPECT_EQ(MessageBuffer::SIZE_CLASSES[2], buffer.size());
+	for (size_t i = 0; i < MessageBuffer::SIZE_CLASSES.front(); ++i) {
+		EXPECT_EQ(static_cast<uint8_t>(i), buffer[i]);
+	}
+
+	EXPECT_FALSE(buffer.reserve(MessageBuffer::SIZE_CLASSES.back() + 1));
+	EXPECT_EQ(MessageBuffer::SIZE_CLASSES.back(), buffer.size());
+}
+
+TEST(MessageBufferTest, CopiesKeepTheirOwnBlock) {
+	MessageBuffer buffer;
+	buffer.reserve(1000);
+	buffer[999] = 42;
+
+	MessageBuffer copy(buffer);
+	EXPECT_EQ(buffer.size(), copy.size());
+	EXPECT_NE(buffer.data(), copy.data());
+	EXPECT_EQ(42, copy[999]);
+
+	MessageBuffer assigned;
+	assigned = buffer;
+	EXPECT_EQ(42, assigned[999]);
+}
+
+TEST(MessageBufferTest, CopiesOnlyTheUsedBytes) {
+	MessageBuffer buffer;
+	buffer.reserve(1000);
+	buffer[999] = 42;
+	// Past every reserve, so not part of the message
+	buffer[2000] = 7;
+	EXPECT_EQ(1000u, buffer.getUsedBytes());
+
+	const MessageBuffer copy(buffer);
+	EXPECT_EQ(1000u, copy.getUsedBytes());
+	EXPECT_EQ(42, copy[999]);
+
+	// Assigned into a block of the same class, which is reused
+	MessageBuffer assigned;
+	assigned.reserve(3000);
+	assigned[2000] = 9;
+	assigned = buffer;
+	EXPECT_EQ(1000u, assigned.getUsedBytes());
+	EXPECT_EQ(42, assigned[999]);
+}
+
+TEST(MessageBufferTest, MovesTheBlock) {
+	MessageBuffer buffer;
+	buffer.reserve(1000);
+	buffer[999] = 42;
+	const auto block = buffer.data();
+
+	MessageBuffer moved(std::move(buffer));
+	EXPECT_EQ(block, moved.data());
+	EXPECT_EQ(42, moved[999]);
+	EXPECT_EQ(nullptr, buffer.data());
+
+	MessageBuffer assigned;
+	assigned = std::move(moved);
+	EXPECT_EQ(block, assigned.data());
+	EXPECT_EQ(1000u, assigned.getUsedBytes());
+
+	// The moved from buffer gets a new block on its next reserve
+	ASSERT_TRUE(buffer.reserve(10));
+	EXPECT_EQ(MessageBuffer::SIZE_CLASSES.front(), buffer.size());
+}
+
+TEST(MessageBufferTest, ZeroesTheHeaderOfRecycledBlocks) {
+	{
+		MessageBuffer buffer;
+		std::fill_n(buffer.data(), MessageBuffer::HEADER_SIZE, 0xFF);
+	}
+
+	const MessageBuffer buffer;
+	for (size_t i = 0; i < MessageBuffer::HEADER_SIZE; ++i) {
+		EXPECT_EQ(0, buffer[i]);
+	}
+}
+
+TEST(MessageBufferTest, NetworkMessageGrowsPastTheFirstClass) {
+	NetworkMessage msg;
+	const std::string text(3000, 'x');
+	msg.addByte(0x01);
+	msg.addString(text);
+	msg.add<uint32_t>(0xDEADBEEF);
+
+	EXPECT_GE(msg.getBufferPosition(), MessageBuffer::SIZE_CLASSES.front());
+	msg.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+	EXPECT_EQ(0x01, msg.getByte());
+	EXPECT_EQ(text, msg.getString());
+	EXPECT_EQ(0xDEADBEEF, msg.get<uint32_t>());
+}
+
+TEST(MessageBufferTest, OutputMessageHeadersArePrependedAfterPromotion) {
+	const auto output = OutputMessagePool::getOutputMessage();
+	const std::vector<char> body(5000, 0x11);
+	output->addBytes(body.data(), body.size());
+	output->writeMessageLength();
+
+	const auto length = static_cast<uint16_t>((body.size() - 4) / 8);
+	EXPECT_EQ(body.size() + sizeof(uint16_t), output->getLength());
+	EXPECT_EQ(static_cast<uint8_t>(length), output->getOutputBuffer()[0]);
+	EXPECT_EQ(static_cast<uint8_t>(length >> 8), output->getOutputBuffer()[1]);
+	EXPECT_EQ(0x11, output->getOutputBuffer()[2]);
+}
+
+// Output messages waiting in the queues of connected clients take a fraction of
+// the fixed NETWORKMESSAGE_MAXSIZE buffer each message had before.
+TEST(MessageBufferTest, QueuedMessagesUseSizedBlocks) {
+	constexpr size_t messages = 1000;
+
+	const std::vector<char> payload(20000, 0x22);
+
+	const auto allocatedStart = MessageBuffer::getAllocatedBytes();
+	std::vector<OutputMessage_ptr> queued;
+	queued.reserve(messages);
+	for (size_t i = 0; i < messages; ++i) {
+		queued.emplace_back(OutputMessagePool::getOutputMessage())->addBytes(payload.data(), packetSize(i));
+	}
+	const auto allocated = MessageBuffer::getAllocatedBytes() - allocatedStart;
+
+	EXPECT_LT(allocated, messages * NETWORKMESSAGE_MAXSIZE / 4);
+}
+
+TEST(MessageBufferTest, CountsBlocksPerSizeClass) {
+	const auto start = MessageBuffer::getSizeClassUsage();
+	EXPECT_EQ(MessageBuffer::SIZE_CLASSES[1], start[1].blockSize);
+
+	auto buffer = std::make_unique<MessageBuffer>();
+	ASSERT_TRUE(buffer->reserve(MessageBuffer::SIZE_CLASSES[0] + 1));
+	auto usage = MessageBuffer::getSizeClassUsage();
+	EXPECT_EQ(start[0].inUse, usage[0].inUse);
+	EXPECT_EQ(start[1].inUse + 1, usage[1].inUse);
+
+	// Its first block, taken from the free list when there was one, went back there on promotion
+	EXPECT_EQ(std::max<size_t>(start[0].free, 1), usage[0].free);
+
+	buffer.reset();
+	usage = MessageBuffer::getSizeClassUsage();
+	EXPECT_EQ(start[1].inUse, usage[1].inUse);
+	EXPECT_EQ(std::max<size_t>(start[1].free, 1), usage[1].free);
+}
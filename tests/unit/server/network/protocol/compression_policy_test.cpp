@@ -0,0 +1,64 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/protocol/compression_policy.hpp"
+
+TEST(CompressionPolicyTest, SkipsSmallMessages) {
+	CompressionPolicy policy;
+	EXPECT_FALSE(policy.shouldCompress(0));
+	EXPECT_FALSE(policy.shouldCompress(CompressionPolicy::MIN_SIZE - 1));
+	EXPECT_TRUE(policy.shouldCompress(CompressionPolicy::MIN_SIZE));
+}
+
+TEST(CompressionPolicyTest, BacksOffWhileMessagesDoNotCompress) {
+	CompressionPolicy policy;
+	size_t compressed = 0;
+	while (policy.getRatio() <= CompressionPolicy::POOR_RATIO) {
+		ASSERT_TRUE(policy.shouldCompress(1000));
+		policy.onCompressed(1000, 1005);
+		ASSERT_LT(++compressed, 64u);
+	}
+
+	for (uint32_t i = 0; i < CompressionPolicy::SKIP_MESSAGES; ++i) {
+		EXPECT_FALSE(policy.shouldCompress(1000));
+	}
+
+	// Tries again, and keeps compressing once the messages shrink
+	EXPECT_TRUE(policy.shouldCompress(1000));
+	for (int i = 0; i < 32; ++i) {
+		policy.onCompressed(1000, 300);
+	}
+	EXPECT_LE(policy.getRatio(), CompressionPolicy::POOR_RATIO);
+	EXPECT_TRUE(policy.shouldCompress(1000));
+	EXPECT_TRUE(policy.shouldCompress(1000));
+}
+
+TEST(CompressionPolicyTest, LowersLevelWithLoad) {
+	EXPECT_EQ(6, CompressionPolicy::getLevel(6, 0));
+	EXPECT_EQ(6, CompressionPolicy::getLevel(6, CompressionPolicy::BUSY_LOAD - 1));
+	EXPECT_EQ(3, CompressionPolicy::getLevel(6, CompressionPolicy::BUSY_LOAD));
+	EXPECT_EQ(2, CompressionPolicy::getLevel(2, CompressionPolicy::BUSY_LOAD));
+	EXPECT_EQ(1, CompressionPolicy::getLevel(6, CompressionPolicy::OVERLOADED_LOAD));
+	EXPECT_EQ(1, CompressionPolicy::getLevel(9, 1000));
+}
+
+TEST(CompressionPolicyTest, KeepsConnectionTotals) {
+	CompressionPolicy policy;
+	EXPECT_EQ(0u, policy.getTotalRatio());
+
+	EXPECT_FALSE(policy.shouldCompress(CompressionPolicy::MIN_SIZE - 1));
+	policy.onCompressed(1000, 300, std::chrono::microseconds(20));
+	policy.onCompressed(3000, 1500, std::chrono::microseconds(30));
+
+	EXPECT_EQ(4000u, policy.getInputBytes());
+	EXPECT_EQ(1800u, policy.getOutputBytes());
+	EXPECT_EQ(CompressionPolicy::MIN_SIZE - 1, policy.getSkippedBytes());
+	EXPECT_EQ(std::chrono::microseconds(50), policy.getCompressionTime());
+	EXPECT_EQ(450u, policy.getTotalRatio());
+}
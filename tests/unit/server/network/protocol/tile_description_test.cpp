@@ -0,0 +1,178 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "items/item.hpp"
+#include "items/tile.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "server/network/protocol/tile_description.hpp"
+
+namespace {
+	// Unit tests run without a datapack, so the item types are registered here
+	constexpr uint16_t groundId = 1;
+	constexpr uint16_t borderId = 2;
+	constexpr uint16_t coinsId = 3;
+	constexpr uint16_t splashId = 4;
+	constexpr uint16_t stoneId = 5;
+	constexpr uint16_t chestId = 6;
+
+	void registerItemTypes() {
+		auto &types = Item::items.getItems();
+		if (types.size() <= chestId) {
+			types.resize(chestId + 1);
+		}
+
+		const auto define = [&types](uint16_t id) -> ItemType & {
+			types[id].id = id;
+			return types[id];
+		};
+		define(groundId).group = ITEM_GROUP_GROUND;
+		define(borderId).alwaysOnTopOrder = 1;
+		define(coinsId).stackable = true;
+		define(splashId).group = ITEM_GROUP_SPLASH;
+		define(stoneId).animationType = ANIMATION_RANDOM;
+		define(chestId).group = ITEM_GROUP_CONTAINER;
+	}
+
+	std::shared_ptr<Tile> makeTile(uint16_t x, std::initializer_list<std::pair<uint16_t, uint16_t>> things) {
+		auto tile = std::make_shared<DynamicTile>(x, 100, 7);
+		for (const auto &[id, count] : things) {
+			tile->internalAddThing(std::make_shared<Item>(id, count));
+		}
+		return tile;
+	}
+
+	// Uncached reference, the part of ProtocolGame::AddItem used by cacheable items
+	void addItem(NetworkMessage &msg, const std::shared_ptr<Item> &item, bool oldProtocol) {
+		const ItemType &it = Item::items[item->getID()];
+		msg.add<uint16_t>(it.id);
+		if (oldProtocol) {
+			msg.addByte(0xFF);
+		}
+		if (it.stackable) {
+			msg.addByte(static_cast<uint8_t>(std::min<uint16_t>(std::numeric_limits<uint8_t>::max(), item->getItemCount())));
+		}
+		if (it.isSplash() || it.isFluidContainer()) {
+			msg.addByte(item->getAttribute<uint8_t>(ItemAttribute_t::FLUIDTYPE));
+		}
+		if (oldProtocol && it.animationType == ANIMATION_RANDOM) {
+			msg.addByte(0xFE);
+		}
+	}
+
+	void addItems(NetworkMessage &msg, const std::shared_ptr<Tile> &tile, bool oldProtocol) {
+		if (const auto &ground = tile->getGround()) {
+			addItem(msg, ground, oldProtocol);
+		}
+		if (const auto items = tile->getItemList()) {
+			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				addItem(msg, *it, oldProtocol);
+			}
+			for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
+				addItem(msg, *it, oldProtocol);
+			}
+		}
+	}
+
+	std::vector<uint8_t> bytes(const NetworkMessage &msg) {
+		const auto begin = msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		return { begin, begin + msg.getLength() };
+	}
+
+	std::vector<uint8_t> cachedBytes(const std::shared_ptr<Tile> &tile, bool oldProtocol) {
+		NetworkMessage msg;
+		const auto description = TileDescription::get(tile);
+		description->write(msg, oldProtocol, 0, description->getTopItems() + description->getDownItems());
+		return bytes(msg);
+	}
+
+	std::vector<uint8_t> referenceBytes(const std::shared_ptr<Tile> &tile, bool oldProtocol) {
+		NetworkMessage msg;
+		addItems(msg, tile, oldProtocol);
+		return bytes(msg);
+	}
+}
+
+TEST(TileDescriptionTest, MatchesItemEncoding) {
+	registerItemTypes();
+	const auto tile = makeTile(100, { { groundId, 0 }, { borderId, 0 }, { coinsId, 37 }, { splashId, 5 }, { stoneId, 0 } });
+
+	const auto description = TileDescription::get(tile);
+	ASSERT_TRUE(description->isCacheable());
+	EXPECT_EQ(2u, description->getTopItems());
+	EXPECT_EQ(3u, description->getDownItems());
+
+	EXPECT_EQ(referenceBytes(tile, false), cachedBytes(tile, false));
+	EXPECT_EQ(referenceBytes(tile, true), cachedBytes(tile, true));
+}
+
+TEST(TileDescriptionTest, WritesItemRanges) {
+	registerItemTypes();
+	const auto tile = makeTile(101, { { groundId, 0 }, { coinsId, 3 }, { coinsId, 4 } });
+	const auto description = TileDescription::get(tile);
+
+	NetworkMessage msg;
+	description->write(msg, false, 1, 2);
+	// Down items are stored top to bottom, the last one added comes first
+	EXPECT_EQ((std::vector<uint8_t> { coinsId, 0, 4 }), bytes(msg));
+
+	msg.reset();
+	description->write(msg, false, 2, TileDescription::MAX_THINGS);
+	EXPECT_EQ((std::vector<uint8_t> { coinsId, 0, 3 }), bytes(msg));
+}
+
+TEST(TileDescriptionTest, IsReusedUntilTheTileChanges) {
+	registerItemTypes();
+	const auto tile = makeTile(102, { { groundId, 0 }, { stoneId, 0 } });
+
+	const auto first = TileDescription::get(tile);
+	EXPECT_EQ(first, TileDescription::get(tile));
+
+	tile->internalAddThing(std::make_shared<Item>(coinsId, 10));
+	const auto second = TileDescription::get(tile);
+	EXPECT_NE(first, second);
+	EXPECT_EQ(3u, second->getTopItems() + second->getDownItems());
+	EXPECT_EQ(referenceBytes(tile, false), cachedBytes(tile, false));
+
+	tile->invalidateDescription();
+	EXPECT_NE(second, TileDescription::get(tile));
+}
+
+TEST(TileDescriptionTest, ViewerDependentItemsAreNotCached) {
+	registerItemTypes();
+	const auto tile = makeTile(103, { { groundId, 0 }, { chestId, 0 } });
+	EXPECT_FALSE(TileDescription::get(tile)->isCacheable());
+}
+
+// Full client view on every floor (18x14 tiles, 8 floors), as sent on login or
+// teleport. Copying the cached descriptions gives the bytes of encoding every item.
+TEST(TileDescriptionTest, FullScreenDescriptionMatchesEncoding) {
+	registerItemTypes();
+	constexpr size_t tiles = 18 * 14 * 8;
+
+	std::vector<std::shared_ptr<Tile>> window;
+	window.reserve(tiles);
+	for (size_t i = 0; i < tiles; ++i) {
+		window.emplace_back(makeTile(static_cast<uint16_t>(200 + i), { { groundId, 0 }, { borderId, 0 }, { splashId, 2 }, { coinsId, static_cast<uint16_t>(1 + i % 100) } }));
+	}
+
+	NetworkMessage encoded;
+	for (const auto &tile : window) {
+		addItems(encoded, tile, false);
+	}
+
+	NetworkMessage copied;
+	for (const auto &tile : window) {
+		const auto description = TileDescription::get(tile);
+		description->write(copied, false, 0, description->getTopItems() + description->getDownItems());
+	}
+
+	EXPECT_EQ(bytes(encoded), bytes(copied));
+}
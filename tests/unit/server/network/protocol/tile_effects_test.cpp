@@ -0,0 +1,142 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/logging/in_memory_logger.hpp"
+
+#include "server/network/message/networkmessage.hpp"
+#include "server/network/protocol/tile_effects.hpp"
+#include "server/server_definitions.hpp"
+
+namespace {
+	constexpr uint16_t effectId = 7;
+	constexpr auto castSound = static_cast<SoundEffect_t>(1);
+	constexpr auto impactSound = static_cast<SoundEffect_t>(2);
+
+	// ProtocolGame::sendMagicEffect, one message per tile
+	NetworkMessage magicEffect(const Position &pos, uint16_t type) {
+		NetworkMessage msg;
+		msg.addByte(0x83);
+		msg.addPosition(pos);
+		msg.addByte(MAGIC_EFFECTS_CREATE_EFFECT);
+		msg.add<uint16_t>(type);
+		msg.addByte(MAGIC_EFFECTS_END_LOOP);
+		return msg;
+	}
+
+	// ProtocolGame::sendDoubleSoundEffect, one message per tile
+	NetworkMessage doubleSound(const Position &pos, SoundEffect_t mainSound, SoundEffect_t secondarySound, SourceEffect_t source) {
+		NetworkMessage msg;
+		msg.addByte(0x83);
+		msg.addPosition(pos);
+		msg.addByte(MAGIC_EFFECTS_CREATE_SOUND_MAIN_EFFECT);
+		msg.addByte(static_cast<uint8_t>(source));
+		msg.add<uint16_t>(static_cast<uint16_t>(mainSound));
+		msg.addByte(MAGIC_EFFECTS_CREATE_SOUND_SECONDARY_EFFECT);
+		msg.addByte(0x01);
+		msg.addByte(static_cast<uint8_t>(source));
+		msg.add<uint16_t>(static_cast<uint16_t>(secondarySound));
+		msg.addByte(MAGIC_EFFECTS_END_LOOP);
+		return msg;
+	}
+
+	std::vector<uint8_t> bytes(NetworkMessage &msg) {
+		const auto* body = msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		return { body, body + msg.getLength() };
+	}
+
+	TileEffects makeArea(uint16_t effect, SoundEffect_t mainSound, SoundEffect_t secondarySound, int radius) {
+		TileEffects effects(effect, mainSound, secondarySound);
+		for (int dy = -radius; dy <= radius; ++dy) {
+			for (int dx = -radius; dx <= radius; ++dx) {
+				effects.addPosition(Position(static_cast<uint16_t>(1000 + dx), static_cast<uint16_t>(1000 + dy), 7));
+			}
+		}
+		return effects;
+	}
+}
+
+TEST(TileEffectsTest, MatchesMagicEffectPackets) {
+	const auto effects = makeArea(effectId, SoundEffect_t::SILENCE, SoundEffect_t::SILENCE, 1);
+
+	NetworkMessage expected;
+	NetworkMessage batched;
+	for (const auto &pos : effects.getPositions()) {
+		auto packet = magicEffect(pos, effectId);
+		const auto packetBytes = bytes(packet);
+		expected.addBytes(reinterpret_cast<const char*>(packetBytes.data()), packetBytes.size());
+		effects.write(batched, pos, false, true, SourceEffect_t::OWN);
+	}
+
+	EXPECT_EQ(bytes(expected), bytes(batched));
+}
+
+TEST(TileEffectsTest, WritesSoundsOnlyOnTheViewerFloor) {
+	const TileEffects effects(CONST_ME_NONE, castSound, impactSound);
+	const Position pos(1000, 1000, 7);
+
+	NetworkMessage sameFloor;
+	effects.write(sameFloor, pos, false, true, SourceEffect_t::OTHERS);
+	auto expected = doubleSound(pos, castSound, impactSound, SourceEffect_t::OTHERS);
+	EXPECT_EQ(bytes(expected), bytes(sameFloor));
+
+	// Nothing left to show
+	NetworkMessage otherFloor;
+	effects.write(otherFloor, pos, false, false, SourceEffect_t::OTHERS);
+	EXPECT_EQ(0, otherFloor.getLength());
+	EXPECT_TRUE(TileEffects(CONST_ME_NONE, SoundEffect_t::SILENCE, SoundEffect_t::SILENCE).empty());
+}
+
+TEST(TileEffectsTest, OldProtocolOnlyGetsSingleByteEffects) {
+	const Position pos(1000, 1000, 7);
+
+	NetworkMessage msg;
+	TileEffects(effectId, castSound, impactSound).write(msg, pos, true, true, SourceEffect_t::OWN);
+	EXPECT_EQ(1 + 5 + 1, msg.getLength());
+
+	NetworkMessage wide;
+	TileEffects(0x100, castSound, impactSound).write(wide, pos, true, true, SourceEffect_t::OWN);
+	EXPECT_EQ(0, wide.getLength());
+}
+
+// An 11x11 area rune with an impact effect and sounds fits a single message,
+// smaller than a magic effect plus a sound packet per tile.
+TEST(TileEffectsTest, AreaCombatFitsOneMessage) {
+	const auto effects = makeArea(effectId, castSound, impactSound, 5);
+
+	size_t perTileBytes = 0;
+	NetworkMessage batched;
+	for (const auto &pos : effects.getPositions()) {
+		perTileBytes += magicEffect(pos, effectId).getLength();
+		perTileBytes += doubleSound(pos, castSound, impactSound, SourceEffect_t::OTHERS).getLength();
+
+		ASSERT_TRUE(batched.canAdd(TileEffects::MAX_TILE_SIZE));
+		effects.write(batched, pos, false, true, SourceEffect_t::OTHERS);
+	}
+
+	EXPECT_LT(batched.getLength(), perTileBytes);
+}
+
+// Combat::CombatFunc sends the tiles collected so far before each damage and
+// clears them, the next write only carries the tiles hit after it.
+TEST(TileEffectsTest, ClearKeepsTheEffectsForTheNextTiles) {
+	TileEffects effects(effectId, SoundEffect_t::SILENCE, SoundEffect_t::SILENCE);
+	effects.addPosition(Position(1000, 1000, 7));
+	effects.clear();
+	EXPECT_TRUE(effects.empty());
+
+	const Position pos(1001, 1000, 7);
+	effects.addPosition(pos);
+	ASSERT_EQ(1, effects.getPositions().size());
+	EXPECT_EQ(pos, effects.getPositions().front());
+
+	NetworkMessage msg;
+	effects.write(msg, pos, false, true, SourceEffect_t::OWN);
+	auto expected = magicEffect(pos, effectId);
+	EXPECT_EQ(bytes(expected), bytes(msg));
+}
@@ -0,0 +1,140 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "utils/timing_wheel.hpp"
+
+namespace {
+	constexpr int64_t kTick = 50;
+	constexpr int64_t kEpoch = 1700000000000;
+
+	std::vector<int> advance(stdext::timing_wheel<int> &wheel, int64_t now) {
+		std::vector<int> expired;
+		wheel.advance(now, expired);
+		return expired;
+	}
+}
+
+TEST(TimingWheelTest, ExpiresEntriesOrderedByTimestamp) {
+	stdext::timing_wheel<int> wheel { kTick };
+	wheel.insert(kEpoch, kEpoch + 300, 3);
+	wheel.insert(kEpoch, kEpoch + 100, 1);
+	wheel.insert(kEpoch, kEpoch + 200, 2);
+	EXPECT_EQ(3u, wheel.size());
+
+	EXPECT_TRUE(advance(wheel, kEpoch + 50).empty());
+	EXPECT_EQ((std::vector<int> { 1, 2 }), advance(wheel, kEpoch + 250));
+	EXPECT_EQ((std::vector<int> { 3 }), advance(wheel, kEpoch + 300));
+	EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, NeverExpiresEarly) {
+	stdext::timing_wheel<int> wheel { kTick };
+	wheel.insert(kEpoch, kEpoch + 120, 1);
+
+	EXPECT_TRUE(advance(wheel, kEpoch + 119).empty());
+	EXPECT_TRUE(advance(wheel, kEpoch + 149).empty());
+	EXPECT_EQ((std::vector<int> { 1 }), advance(wheel, kEpoch + 150));
+}
+
+TEST(TimingWheelTest, CancelRemovesEntry) {
+	stdext::timing_wheel<int> wheel { kTick };
+	const auto first = wheel.insert(kEpoch, kEpoch + 100, 1);
+	wheel.insert(kEpoch, kEpoch + 100, 2);
+
+	EXPECT_TRUE(wheel.cancel(first));
+	EXPECT_FALSE(wheel.cancel(first));
+	EXPECT_EQ((std::vector<int> { 2 }), advance(wheel, kEpoch + 100));
+}
+
+TEST(TimingWheelTest, CascadesFarFutureEntries) {
+	stdext::timing_wheel<int> wheel { kTick };
+	constexpr int64_t hour = 60 * 60 * 1000;
+	constexpr int64_t month = 30 * 24 * hour;
+	wheel.insert(kEpoch, kEpoch + month, 3);
+	wheel.insert(kEpoch, kEpoch + hour, 2);
+	wheel.insert(kEpoch, kEpoch + 20 * 1000, 1);
+
+	EXPECT_EQ((std::vector<int> { 1 }), advance(wheel, kEpoch + 20 * 1000));
+	EXPECT_TRUE(advance(wheel, kEpoch + hour - 1).empty());
+	EXPECT_EQ((std::vector<int> { 2 }), advance(wheel, kEpoch + hour));
+	EXPECT_TRUE(advance(wheel, kEpoch + month - 1).empty());
+	EXPECT_EQ((std::vector<int> { 3 }), advance(wheel, kEpoch + month));
+}
+
+TEST(TimingWheelTest, PastTimestampsExpireOnNextAdvance) {
+	stdext::timing_wheel<int> wheel { kTick };
+	advance(wheel, kEpoch);
+	wheel.insert(kEpoch, kEpoch - 1000, 1);
+
+	EXPECT_EQ((std::vector<int> { 1 }), advance(wheel, kEpoch));
+}
+
+// Decay-like workload: many short and some long durations, frequent restarts.
+// Checks that the wheel expires the same timestamps in the same order as the
+// ordered map the decay used before.
+TEST(TimingWheelTest, MatchesOrderedMap) {
+	constexpr size_t items = 20000;
+	std::mt19937_64 rng { 42 };
+	std::vector<int64_t> timestamps(items);
+	for (auto &timestamp : timestamps) {
+		const auto duration = rng() % 8 == 0 ? rng() % (24 * 60 * 60 * 1000) : rng() % (5 * 60 * 1000);
+		timestamp = kEpoch + static_cast<int64_t>(duration);
+	}
+
+	std::vector<int64_t> wheelOrder;
+	std::vector<int64_t> mapOrder;
+	wheelOrder.reserve(items);
+	mapOrder.reserve(items);
+
+	{
+		stdext::timing_wheel<int> wheel { kTick };
+		std::vector<stdext::timing_wheel<int>::handle> handles(items);
+		for (size_t i = 0; i < items; ++i) {
+			handles[i] = wheel.insert(kEpoch, timestamps[i], static_cast<int>(i));
+		}
+		// Restart a tenth of them, as happens when items are moved or transformed
+		for (size_t i = 0; i < items; i += 10) {
+			wheel.cancel(handles[i]);
+			wheel.insert(kEpoch, timestamps[i], static_cast<int>(i));
+		}
+
+		std::vector<int> expired;
+		for (int64_t now = kEpoch; !wheel.empty(); now += kTick) {
+			expired.clear();
+			wheel.advance(now, expired);
+			for (const auto id : expired) {
+				wheelOrder.push_back(timestamps[id]);
+			}
+		}
+	}
+
+	{
+		std::map<int64_t, std::vector<int>> map;
+		for (size_t i = 0; i < items; ++i) {
+			map[timestamps[i]].push_back(static_cast<int>(i));
+		}
+		for (size_t i = 0; i < items; i += 10) {
+			auto &bucket = map[timestamps[i]];
+			bucket.erase(std::ranges::find(bucket, static_cast<int>(i)));
+			bucket.push_back(static_cast<int>(i));
+		}
+
+		for (int64_t now = kEpoch; !map.empty(); now += kTick) {
+			const auto end = map.upper_bound(now);
+			for (auto it = map.begin(); it != end; ++it) {
+				for (const auto id : it->second) {
+					mapOrder.push_back(timestamps[id]);
+				}
+			}
+			map.erase(map.begin(), end);
+		}
+	}
+
+	EXPECT_EQ(mapOrder, wheelOrder);
+}